@@ -0,0 +1,41 @@
+#include "BenchSupport.h"
+#include "TestPageServer.h"
+#include "DatabaseManager.h"
+#include <QStandardPaths>
+
+namespace BenchSupport
+{
+
+void prepareHeadlessEnvironment()
+{
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    if (!qEnvironmentVariableIsSet("QTWEBENGINE_CHROMIUM_FLAGS")) {
+        qputenv("QTWEBENGINE_CHROMIUM_FLAGS", "--disable-gpu --disable-software-rasterizer --no-sandbox --disable-gpu-sandbox --disable-background-timer-throttling");
+    }
+    qputenv("BSS_EVENT_LOOP_MONITOR", "0");
+}
+
+void isolateUserData()
+{
+    QStandardPaths::setTestModeEnabled(true);
+}
+
+bool seedDatabase(const QString& path, const TestPageServer& server, int tiles, int columns)
+{
+    DatabaseManager* dbManager = DatabaseManager::getInstance();
+    dbManager->setDatabasePath(path);
+    if (!dbManager->initialize()) {
+        return false;
+    }
+
+    bool ok = dbManager->saveUserSession("bench", true);
+    ok = dbManager->setAppSetting("windowColumns", columns) && ok;
+    for (int tile = 1; tile <= tiles; ++tile) {
+        ok = dbManager->addSubWindow(QString("Tile %1").arg(tile), server.tileUrl(tile)) && ok;
+    }
+    return ok;
+}
+
+} // namespace BenchSupport
@@ -0,0 +1,24 @@
+#ifndef BENCHSUPPORT_H
+#define BENCHSUPPORT_H
+
+#include <QString>
+
+class TestPageServer;
+
+// Setup shared by the headless benchmarks that run the whole application
+namespace BenchSupport
+{
+    // Offscreen platform, GPU disabled, no watchdog; call before QApplication.
+    // Variables the caller already set are left alone.
+    void prepareHeadlessEnvironment();
+
+    // Profiles, cookies and logs go to the QStandardPaths test locations; call
+    // after the application name is set
+    void isolateUserData();
+
+    // Fresh database at path with a remembered session (so MainWindow skips the
+    // login dialog) and one sub-window per test page
+    bool seedDatabase(const QString& path, const TestPageServer& server, int tiles, int columns);
+}
+
+#endif // BENCHSUPPORT_H
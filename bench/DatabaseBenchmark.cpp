@@ -0,0 +1,217 @@
+// Storage micro-benchmarks for DatabaseManager.
+//
+//     cmake -S . -B build -DBUILD_BENCHMARKS=ON && cmake --build build
+//     ./build/DatabaseBenchmark                 # all benchmarks
+//     ./build/DatabaseBenchmark -iterations 50 getHistoryRecords
+//
+// Every benchmark runs against a temporary file and an in-memory database.
+// The 1M-row history case takes a while to seed; skip it with BSS_BENCH_QUICK=1.
+
+#include <QtTest>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QTemporaryDir>
+#include "DatabaseManager.h"
+
+class DatabaseBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void addHistoryRecord_data();
+    void addHistoryRecord();
+    void getHistoryRecords_data();
+    void getHistoryRecords();
+    void getAllSubWindows_data();
+    void getAllSubWindows();
+    void appSettingRoundTrip_data();
+    void appSettingRoundTrip();
+    void saveWindowConfig_data();
+    void saveWindowConfig();
+
+private:
+    DatabaseManager* openDatabase(const QString& backend);
+    void addBackendColumn();
+    void addBackendRows(const char* name, const QList<int>& sizes = {0});
+    void seedHistory(int rows);
+    void seedSubWindows(int rows);
+
+    QTemporaryDir m_tempDir;
+    int m_databaseCounter = 0;
+};
+
+DatabaseManager* DatabaseBenchmark::openDatabase(const QString& backend)
+{
+    // A fresh database per data row, so earlier rows cannot skew the next
+    DatabaseManager* dbManager = DatabaseManager::getInstance();
+    dbManager->setDatabasePath(backend == "memory"
+        ? QString(":memory:")
+        : m_tempDir.filePath(QString("bench_%1.db").arg(++m_databaseCounter)));
+    if (!dbManager->initialize()) {
+        qFatal("Failed to open benchmark database");
+    }
+    return dbManager;
+}
+
+void DatabaseBenchmark::addBackendColumn()
+{
+    QTest::addColumn<QString>("backend");
+    QTest::addColumn<int>("rows");
+}
+
+void DatabaseBenchmark::addBackendRows(const char* name, const QList<int>& sizes)
+{
+    for (const QString backend : {QString("file"), QString("memory")}) {
+        for (int size : sizes) {
+            QByteArray tag = QString("%1/%2/%3").arg(QString::fromLatin1(name), backend).arg(size).toLatin1();
+            QTest::newRow(tag.constData()) << backend << size;
+        }
+    }
+}
+
+void DatabaseBenchmark::seedHistory(int rows)
+{
+    // Bulk seeding goes straight to SQL in one transaction; only the reads are measured
+    QSqlDatabase database = QSqlDatabase::database();
+    database.transaction();
+    QSqlQuery query(database);
+    query.prepare("INSERT INTO history (url, title, window_id) VALUES (?, ?, ?)");
+    for (int i = 0; i < rows; ++i) {
+        query.addBindValue(QString("https://example.com/page/%1").arg(i));
+        query.addBindValue(QString("Page %1").arg(i));
+        query.addBindValue(i % 16 + 1);
+        query.exec();
+    }
+    database.commit();
+}
+
+void DatabaseBenchmark::seedSubWindows(int rows)
+{
+    QSqlDatabase database = QSqlDatabase::database();
+    database.transaction();
+    QSqlQuery query(database);
+    query.prepare("INSERT INTO sub_windows (name, url) VALUES (?, ?)");
+    for (int i = 0; i < rows; ++i) {
+        query.addBindValue(QString("Dashboard %1").arg(i));
+        query.addBindValue(QString("https://example.com/dashboard/%1").arg(i));
+        query.exec();
+    }
+    database.commit();
+}
+
+void DatabaseBenchmark::addHistoryRecord_data()
+{
+    addBackendColumn();
+    addBackendRows("append");
+}
+
+void DatabaseBenchmark::addHistoryRecord()
+{
+    QFETCH(QString, backend);
+    DatabaseManager* dbManager = openDatabase(backend);
+
+    int i = 0;
+    QBENCHMARK {
+        dbManager->addHistoryRecord(QString("https://example.com/%1").arg(i), "Example", i % 16 + 1);
+        ++i;
+    }
+}
+
+void DatabaseBenchmark::getHistoryRecords_data()
+{
+    addBackendColumn();
+    QList<int> sizes = {10000};
+    if (qEnvironmentVariableIntValue("BSS_BENCH_QUICK") == 0) {
+        sizes.append(1000000);
+    }
+    addBackendRows("limit100", sizes);
+}
+
+void DatabaseBenchmark::getHistoryRecords()
+{
+    QFETCH(QString, backend);
+    QFETCH(int, rows);
+    DatabaseManager* dbManager = openDatabase(backend);
+    seedHistory(rows);
+
+    QBENCHMARK {
+        QList<QJsonObject> records = dbManager->getHistoryRecords(100);
+        QCOMPARE(records.size(), 100);
+    }
+}
+
+void DatabaseBenchmark::getAllSubWindows_data()
+{
+    addBackendColumn();
+    addBackendRows("all", {16, 1000});
+}
+
+void DatabaseBenchmark::getAllSubWindows()
+{
+    QFETCH(QString, backend);
+    QFETCH(int, rows);
+    DatabaseManager* dbManager = openDatabase(backend);
+    seedSubWindows(rows);
+
+    QBENCHMARK {
+        QList<QJsonObject> subWindows = dbManager->getAllSubWindows();
+        QCOMPARE(subWindows.size(), rows);
+    }
+}
+
+void DatabaseBenchmark::appSettingRoundTrip_data()
+{
+    addBackendColumn();
+    addBackendRows("set+get");
+}
+
+void DatabaseBenchmark::appSettingRoundTrip()
+{
+    QFETCH(QString, backend);
+    DatabaseManager* dbManager = openDatabase(backend);
+
+    int i = 0;
+    QBENCHMARK {
+        dbManager->setAppSetting("benchmarkKey", i);
+        QCOMPARE(dbManager->getAppSetting("benchmarkKey").toInt(), i);
+        ++i;
+    }
+}
+
+void DatabaseBenchmark::saveWindowConfig_data()
+{
+    addBackendColumn();
+    addBackendRows("tiles", {16});
+}
+
+void DatabaseBenchmark::saveWindowConfig()
+{
+    QFETCH(QString, backend);
+    QFETCH(int, rows);
+    DatabaseManager* dbManager = openDatabase(backend);
+    seedSubWindows(rows);
+
+    // One iteration saves the whole wall, like the periodic auto-save
+    QList<WindowConfig> configs;
+    for (int i = 1; i <= rows; ++i) {
+        WindowConfig config;
+        config.windowId = i;
+        config.subId = i;
+        config.url = QString("https://example.com/dashboard/%1").arg(i);
+        config.title = QString("Dashboard %1").arg(i);
+        config.geometry = QRect(0, 0, 640, 384);
+        config.zoomFactor = 0.75;
+        config.scrollPosition = QPointF(0, i * 10);
+        config.lifecycleState = WindowConfig::Active;
+        configs.append(config);
+    }
+
+    QBENCHMARK {
+        for (const WindowConfig& config : configs) {
+            dbManager->saveWindowConfig(config);
+        }
+    }
+}
+
+QTEST_MAIN(DatabaseBenchmark)
+#include "DatabaseBenchmark.moc"
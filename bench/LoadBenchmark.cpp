@@ -0,0 +1,351 @@
+// End-to-end load benchmark: the real MainWindow/WindowManager/BrowserWidget stack,
+// headless, against pages served from loopback by TestPageServer.
+//
+//     cmake -S . -B build -DBUILD_BENCHMARKS=ON && cmake --build build
+//     ./build/LoadBenchmark --tiles 16 --page-kb 256 --script-ms 50 --latency-ms 30 --json run.json
+//
+// Runs under QT_QPA_PLATFORM=offscreen with the GPU disabled unless the environment
+// says otherwise (see BenchSupport), so it needs neither a display, a GPU nor a
+// network. One run per process: the startup pipeline only runs once.
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QTimer>
+#include <QSet>
+#include <algorithm>
+#include <cstdio>
+#include "MainWindow.h"
+#include "BrowserWidget.h"
+#include "ProcStats.h"
+#include "Tracer.h"
+#include "Log.h"
+#include "TestPageServer.h"
+#include "BenchSupport.h"
+
+namespace {
+
+struct TileResult
+{
+    int subId = -1;
+    qint64 firstPaintNs = -1;   // From window show
+    qint64 loadedNs = -1;       // From window show
+    qint64 navigationNs = -1;   // Load start to load finished, as the tile measured it
+    bool success = false;
+};
+
+// Follows the tiles of one MainWindow and the processes below this one
+class LoadRun : public QObject
+{
+public:
+    LoadRun(MainWindow* window, int tileCount, int timeoutMs)
+        : m_window(window)
+        , m_tileCount(tileCount)
+        , m_startNs(Tracer::getInstance()->now())
+        , m_peakRendererRssBytes(0)
+        , m_peakTotalRssBytes(0)
+        , m_finished(false)
+    {
+        m_baselineTicks = ProcStats::read(QCoreApplication::applicationPid()).cpuTicks;
+
+        connect(&m_discoveryTimer, &QTimer::timeout, this, &LoadRun::discoverTiles);
+        m_discoveryTimer.start(10);
+
+        connect(&m_sampleTimer, &QTimer::timeout, this, &LoadRun::sampleProcesses);
+        m_sampleTimer.start(100);
+
+        m_timeoutTimer.setSingleShot(true);
+        connect(&m_timeoutTimer, &QTimer::timeout, this, &LoadRun::finish);
+        m_timeoutTimer.start(timeoutMs);
+    }
+
+    bool isComplete() const
+    {
+        if (m_results.size() < m_tileCount) {
+            return false;
+        }
+        for (const TileResult& result : m_results) {
+            if (result.loadedNs < 0 || result.firstPaintNs < 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    QJsonObject report(const TestPageProfile& profile) const;
+    void print(QTextStream& out, const TestPageProfile& profile) const;
+
+private:
+    void discoverTiles();
+    void sampleProcesses();
+    void checkDone();
+    void finish();
+
+    MainWindow* m_window;
+    int m_tileCount;
+    qint64 m_startNs;
+    quint64 m_baselineTicks;
+    QHash<int, TileResult> m_results;      // By sub-window id
+    QSet<BrowserWidget*> m_watched;
+    QHash<qint64, QString> m_processTypes;  // Chromium "--type=" per pid, read once
+    QHash<qint64, quint64> m_lastTicks;     // Last cumulative CPU ticks per pid, kept after exit
+    qint64 m_peakRendererRssBytes;
+    qint64 m_peakTotalRssBytes;
+    QTimer m_discoveryTimer;
+    QTimer m_sampleTimer;
+    QTimer m_timeoutTimer;
+    bool m_finished;
+};
+
+void LoadRun::discoverTiles()
+{
+    // Tiles are created by the startup pipeline after the first show
+    for (BrowserWidget* widget : m_window->findChildren<BrowserWidget*>()) {
+        if (m_watched.contains(widget)) {
+            continue;
+        }
+        int subId = widget->getTileMetrics().subWindowId;
+        if (subId <= 0) {
+            continue;  // Pooled widget without a sub-window yet
+        }
+
+        m_watched.insert(widget);
+        m_results[subId].subId = subId;
+
+        connect(widget, &BrowserWidget::firstPaint, this, [this, subId](qint64) {
+            TileResult& result = m_results[subId];
+            if (result.firstPaintNs < 0) {
+                result.firstPaintNs = Tracer::getInstance()->now() - m_startNs;
+                checkDone();
+            }
+        });
+        connect(widget, &BrowserWidget::loadFinished, this, [this, widget, subId](bool success) {
+            TileResult& result = m_results[subId];
+            if (result.loadedNs < 0) {
+                result.loadedNs = Tracer::getInstance()->now() - m_startNs;
+                result.navigationNs = widget->getTileMetrics().navigationMs * 1000000;
+                result.success = success;
+                checkDone();
+            }
+        });
+    }
+}
+
+void LoadRun::sampleProcesses()
+{
+    const qint64 selfPid = QCoreApplication::applicationPid();
+    qint64 rendererRss = 0;
+    qint64 totalRss = 0;
+
+    QList<qint64> pids = ProcStats::descendants(selfPid);
+    pids.prepend(selfPid);
+    for (qint64 pid : pids) {
+        ProcessSample sample = ProcStats::read(pid);
+        if (!sample.valid) {
+            continue;
+        }
+        if (!m_processTypes.contains(pid)) {
+            m_processTypes.insert(pid, ProcStats::chromiumProcessType(pid));
+        }
+
+        totalRss += sample.rssBytes;
+        if (m_processTypes.value(pid) == "renderer") {
+            rendererRss += sample.rssBytes;
+        }
+        m_lastTicks[pid] = sample.cpuTicks;
+    }
+
+    m_peakRendererRssBytes = qMax(m_peakRendererRssBytes, rendererRss);
+    m_peakTotalRssBytes = qMax(m_peakTotalRssBytes, totalRss);
+}
+
+void LoadRun::checkDone()
+{
+    if (isComplete()) {
+        finish();
+    }
+}
+
+void LoadRun::finish()
+{
+    if (m_finished) {
+        return;
+    }
+    m_finished = true;
+    m_discoveryTimer.stop();
+    m_timeoutTimer.stop();
+    sampleProcesses();  // Final CPU reading before the pages go away
+    m_sampleTimer.stop();
+    QCoreApplication::exit(isComplete() ? 0 : 1);
+}
+
+QJsonObject LoadRun::report(const TestPageProfile& profile) const
+{
+    const qint64 selfPid = QCoreApplication::applicationPid();
+    const double ticksPerSecond = ProcStats::ticksPerSecond();
+
+    quint64 childTicks = 0;
+    for (auto it = m_lastTicks.constBegin(); it != m_lastTicks.constEnd(); ++it) {
+        if (it.key() != selfPid) {
+            childTicks += it.value();
+        }
+    }
+    quint64 selfTicks = m_lastTicks.value(selfPid, m_baselineTicks) - m_baselineTicks;
+
+    QJsonArray tiles;
+    qint64 lastFirstPaintNs = -1;
+    qint64 lastLoadedNs = -1;
+    int failures = 0;
+    QList<int> subIds = m_results.keys();
+    std::sort(subIds.begin(), subIds.end());
+    for (int subId : subIds) {
+        const TileResult& result = m_results.value(subId);
+        QJsonObject tile;
+        tile["subId"] = subId;
+        tile["firstPaintMs"] = result.firstPaintNs >= 0 ? result.firstPaintNs / 1e6 : -1.0;
+        tile["loadedMs"] = result.loadedNs >= 0 ? result.loadedNs / 1e6 : -1.0;
+        tile["navigationMs"] = result.navigationNs >= 0 ? result.navigationNs / 1e6 : -1.0;
+        tile["success"] = result.success;
+        tiles.append(tile);
+
+        lastFirstPaintNs = qMax(lastFirstPaintNs, result.firstPaintNs);
+        lastLoadedNs = qMax(lastLoadedNs, result.loadedNs);
+        if (result.loadedNs >= 0 && !result.success) {
+            ++failures;
+        }
+    }
+
+    QJsonObject config;
+    config["tiles"] = m_tileCount;
+    config["pageKb"] = profile.pageKb;
+    config["scriptMs"] = profile.scriptMs;
+    config["latencyMs"] = profile.latencyMs;
+    config["subresources"] = profile.subresources;
+    config["qtVersion"] = QString(qVersion());
+
+    QJsonObject summary;
+    summary["complete"] = isComplete();
+    summary["tilesSeen"] = m_results.size();
+    summary["failures"] = failures;
+    summary["allFirstPaintMs"] = lastFirstPaintNs >= 0 ? lastFirstPaintNs / 1e6 : -1.0;
+    summary["allLoadedMs"] = lastLoadedNs >= 0 ? lastLoadedNs / 1e6 : -1.0;
+    summary["peakRendererRssBytes"] = m_peakRendererRssBytes;
+    summary["peakTotalRssBytes"] = m_peakTotalRssBytes;
+    summary["browserCpuSeconds"] = selfTicks / ticksPerSecond;
+    summary["childCpuSeconds"] = childTicks / ticksPerSecond;  // Renderers, GPU/utility processes
+
+    QJsonObject result;
+    result["config"] = config;
+    result["summary"] = summary;
+    result["tiles"] = tiles;
+    return result;
+}
+
+void LoadRun::print(QTextStream& out, const TestPageProfile& profile) const
+{
+    QJsonObject result = report(profile);
+    QJsonObject summary = result["summary"].toObject();
+
+    out << QString("%1 %2 %3 %4\n").arg(QString("subId"), 6).arg(QString("paint ms"), 10).arg(QString("loaded ms"), 10).arg(QString("nav ms"), 10);
+    for (const QJsonValue& value : result["tiles"].toArray()) {
+        QJsonObject tile = value.toObject();
+        out << QString("%1 %2 %3 %4%5\n")
+            .arg(tile["subId"].toInt(), 6)
+            .arg(tile["firstPaintMs"].toDouble(), 10, 'f', 1)
+            .arg(tile["loadedMs"].toDouble(), 10, 'f', 1)
+            .arg(tile["navigationMs"].toDouble(), 10, 'f', 1)
+            .arg(QString(tile["success"].toBool() ? "" : "  FAILED"));
+    }
+    out << "\n";
+    out << "all tiles painted:   " << QString::number(summary["allFirstPaintMs"].toDouble(), 'f', 1) << " ms\n";
+    out << "all tiles loaded:    " << QString::number(summary["allLoadedMs"].toDouble(), 'f', 1) << " ms\n";
+    out << "peak renderer RSS:   " << QString::number(summary["peakRendererRssBytes"].toDouble() / (1024 * 1024), 'f', 1) << " MiB\n";
+    out << "peak process RSS:    " << QString::number(summary["peakTotalRssBytes"].toDouble() / (1024 * 1024), 'f', 1) << " MiB\n";
+    out << "CPU browser/child:   " << QString::number(summary["browserCpuSeconds"].toDouble(), 'f', 2) << " s / "
+        << QString::number(summary["childCpuSeconds"].toDouble(), 'f', 2) << " s\n";
+    if (!summary["complete"].toBool()) {
+        out << "INCOMPLETE: " << summary["tilesSeen"].toInt() << " tiles seen, timed out before all loaded\n";
+    }
+    out.flush();
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    BenchSupport::prepareHeadlessEnvironment();
+
+    QApplication app(argc, argv);
+    app.setApplicationName("Browser Split Screen Load Benchmark");
+    app.setOrganizationName("QunKong");
+    BenchSupport::isolateUserData();
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Headless end-to-end tile load benchmark");
+    parser.addHelpOption();
+    parser.addOption({"tiles", "Number of sub-windows.", "n", "16"});
+    parser.addOption({"columns", "Wall columns.", "n", "4"});
+    parser.addOption({"page-kb", "HTML document size in KiB.", "kb", "64"});
+    parser.addOption({"script-ms", "JavaScript busy time per page on load.", "ms", "20"});
+    parser.addOption({"latency-ms", "Server delay per response.", "ms", "0"});
+    parser.addOption({"subresources", "Stylesheets/scripts per page.", "n", "4"});
+    parser.addOption({"timeout-s", "Give up after this many seconds.", "s", "120"});
+    parser.addOption({"json", "Also write the results as JSON to this file.", "path"});
+    parser.process(app);
+
+    Log::install();
+
+    TestPageProfile profile;
+    profile.pageKb = parser.value("page-kb").toInt();
+    profile.scriptMs = parser.value("script-ms").toInt();
+    profile.latencyMs = parser.value("latency-ms").toInt();
+    profile.subresources = parser.value("subresources").toInt();
+    const int tileCount = qMax(1, parser.value("tiles").toInt());
+
+    TestPageServer server;
+    server.setProfile(profile);
+    if (!server.start()) {
+        fprintf(stderr, "Failed to start the test page server\n");
+        Log::shutdown();
+        return 2;
+    }
+
+    QTemporaryDir dataDir;
+    if (!dataDir.isValid() ||
+        !BenchSupport::seedDatabase(dataDir.filePath("bench.db"), server, tileCount, parser.value("columns").toInt())) {
+        fprintf(stderr, "Failed to initialize the benchmark database\n");
+        Log::shutdown();
+        return 2;
+    }
+
+    int exitCode;
+    {
+        MainWindow window;
+        window.resize(1920, 1080);
+        LoadRun run(&window, tileCount, parser.value("timeout-s").toInt() * 1000);
+        window.show();
+        exitCode = app.exec();
+
+        QTextStream out(stdout);
+        out << "tiles=" << tileCount << " page=" << profile.pageKb << "KiB script=" << profile.scriptMs
+            << "ms latency=" << profile.latencyMs << "ms requests=" << server.requestCount() << "\n\n";
+        run.print(out, profile);
+
+        if (parser.isSet("json")) {
+            QFile file(parser.value("json"));
+            if (file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+                file.write(QJsonDocument(run.report(profile)).toJson());
+            } else {
+                fprintf(stderr, "Cannot write %s\n", qPrintable(parser.value("json")));
+            }
+        }
+    }
+
+    Log::shutdown();
+    return exitCode;
+}
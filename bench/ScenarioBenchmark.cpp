@@ -0,0 +1,146 @@
+// Interaction latency benchmark: replays an operator scenario (see ScenarioRunner)
+// against the real application, headless, on pages served from loopback.
+//
+//     cmake -S . -B build -DBUILD_BENCHMARKS=ON && cmake --build build
+//     ./build/ScenarioBenchmark --tiles 16 bench/scenarios/operator.txt --json latency.json
+//
+// Exits with 1 if any action timed out, so it can gate a CI job.
+//
+// Soak mode (--soak-minutes) loops the scenario for that long and samples memory and
+// object counts (see SoakMonitor); leak suspects also make it exit with 1.
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <cstdio>
+#include "MainWindow.h"
+#include "Log.h"
+#include "TestPageServer.h"
+#include "ScenarioRunner.h"
+#include "SoakMonitor.h"
+#include "Tracer.h"
+#include "BenchSupport.h"
+
+int main(int argc, char *argv[])
+{
+    BenchSupport::prepareHeadlessEnvironment();
+
+    QApplication app(argc, argv);
+    app.setApplicationName("Browser Split Screen Scenario Benchmark");
+    app.setOrganizationName("QunKong");
+    BenchSupport::isolateUserData();
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Replays an operator scenario and reports per-action latency");
+    parser.addHelpOption();
+    parser.addPositionalArgument("scenario", "Scenario file.");
+    parser.addOption({"tiles", "Sub-windows on the wall at start.", "n", "16"});
+    parser.addOption({"columns", "Wall columns at start.", "n", "4"});
+    parser.addOption({"page-kb", "HTML document size in KiB.", "kb", "64"});
+    parser.addOption({"script-ms", "JavaScript busy time per page on load.", "ms", "20"});
+    parser.addOption({"latency-ms", "Server delay per response.", "ms", "0"});
+    parser.addOption({"settle-ms", "Quiet time after the last frame that ends an action.", "ms", "100"});
+    parser.addOption({"step-timeout-s", "Give up on an action after this many seconds.", "s", "30"});
+    parser.addOption({"soak-minutes", "Loop the scenario for this long and look for memory growth.", "min", "0"});
+    parser.addOption({"sample-every", "Soak mode: full memory sample every n steps.", "n", "25"});
+    parser.addOption({"json", "Also write the results as JSON to this file.", "path"});
+    parser.process(app);
+
+    if (parser.positionalArguments().size() != 1) {
+        parser.showHelp(2);
+    }
+
+    Log::install();
+
+    TestPageProfile profile;
+    profile.pageKb = parser.value("page-kb").toInt();
+    profile.scriptMs = parser.value("script-ms").toInt();
+    profile.latencyMs = parser.value("latency-ms").toInt();
+
+    TestPageServer server;
+    server.setProfile(profile);
+    if (!server.start()) {
+        fprintf(stderr, "Failed to start the test page server\n");
+        Log::shutdown();
+        return 2;
+    }
+
+    QTemporaryDir dataDir;
+    const int tileCount = qMax(1, parser.value("tiles").toInt());
+    if (!dataDir.isValid() ||
+        !BenchSupport::seedDatabase(dataDir.filePath("bench.db"), server, tileCount, parser.value("columns").toInt())) {
+        fprintf(stderr, "Failed to initialize the benchmark database\n");
+        Log::shutdown();
+        return 2;
+    }
+
+    int exitCode;
+    {
+        MainWindow window;
+        window.resize(1920, 1080);
+
+        ScenarioRunner runner(&window, &server);
+        runner.setSettleMs(parser.value("settle-ms").toInt());
+        runner.setStepTimeoutMs(parser.value("step-timeout-s").toInt() * 1000);
+
+        QString error;
+        if (!runner.load(parser.positionalArguments().first(), &error)) {
+            fprintf(stderr, "%s\n", qPrintable(error));
+            Log::shutdown();
+            return 2;
+        }
+        QObject::connect(&runner, &ScenarioRunner::finished, &app, &QCoreApplication::quit);
+
+        // Soak mode: growth is measured from the loaded wall, not from an empty window
+        const double soakMinutes = parser.value("soak-minutes").toDouble();
+        SoakMonitor monitor(&window);
+        monitor.setSampleEvery(parser.value("sample-every").toInt());
+        if (soakMinutes > 0) {
+            runner.setLoopUntil(Tracer::getInstance()->now() + static_cast<qint64>(soakMinutes * 60e9));
+            QObject::connect(&runner, &ScenarioRunner::stepFinished, &monitor, [&monitor](const QString& action) {
+                if (action == "startup") {
+                    monitor.start();
+                } else {
+                    monitor.onStepFinished(action);
+                }
+            });
+        }
+
+        window.show();
+        runner.start();
+        app.exec();
+
+        QTextStream out(stdout);
+        out << "tiles=" << tileCount << " steps=" << runner.stepCount() << " page=" << profile.pageKb
+            << "KiB script=" << profile.scriptMs << "ms latency=" << profile.latencyMs << "ms\n\n";
+        runner.print(out);
+
+        QJsonObject result = runner.report();
+        exitCode = runner.hasTimeouts() ? 1 : 0;
+        if (soakMinutes > 0) {
+            monitor.finish();
+            out << "\n";
+            monitor.print(out);
+            result["soak"] = monitor.report();
+            if (monitor.hasLeakSuspects()) {
+                exitCode = 1;
+            }
+        }
+
+        if (parser.isSet("json")) {
+            QFile file(parser.value("json"));
+            if (file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+                file.write(QJsonDocument(result).toJson());
+            } else {
+                fprintf(stderr, "Cannot write %s\n", qPrintable(parser.value("json")));
+            }
+        }
+    }
+
+    Log::shutdown();
+    return exitCode;
+}
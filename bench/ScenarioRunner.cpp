@@ -0,0 +1,454 @@
+#include "ScenarioRunner.h"
+#include "Log.h"
+#include "MainWindow.h"
+#include "BrowserWidget.h"
+#include "DatabaseManager.h"
+#include "SubWindowManager.h"
+#include "TestPageServer.h"
+#include "Tracer.h"
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonArray>
+#include <QTextStream>
+#include <QWidget>
+#include <algorithm>
+#include <cmath>
+
+const QEvent::Type ScenarioRunner::InputEventType = static_cast<QEvent::Type>(QEvent::registerEventType());
+
+namespace {
+
+// Carries one step through the event loop, like an input event would
+class ScenarioInputEvent : public QEvent
+{
+public:
+    ScenarioInputEvent(QEvent::Type type, const ScenarioStep& step)
+        : QEvent(type)
+        , step(step)
+    {
+    }
+
+    ScenarioStep step;
+};
+
+const int MAX_REPEAT_DEPTH = 8;
+
+} // namespace
+
+ScenarioRunner::ScenarioRunner(MainWindow* window, TestPageServer* server, QObject *parent)
+    : QObject(parent)
+    , m_window(window)
+    , m_server(server)
+    , m_nextStep(0)
+    , m_nextPage(1000)
+    , m_settleMs(100)
+    , m_stepTimeoutMs(30000)
+    , m_loopUntilNs(0)
+    , m_completedSteps(0)
+    , m_measuring(false)
+    , m_inputNs(0)
+    , m_lastPaintNs(0)
+    , m_expectedLoads(0)
+    , m_finishedLoads(0)
+{
+    connect(&m_pollTimer, &QTimer::timeout, this, &ScenarioRunner::onPoll);
+}
+
+bool ScenarioRunner::load(const QString& filePath, QString* error)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        if (error) {
+            *error = QString("Cannot open %1: %2").arg(filePath, file.errorString());
+        }
+        return false;
+    }
+    return parse(QString::fromUtf8(file.readAll()), error);
+}
+
+bool ScenarioRunner::parse(const QString& text, QString* error)
+{
+    QStringList lines = text.split('\n');
+    QList<ScenarioStep> steps;
+    int index = 0;
+    if (!parseLines(lines, index, 0, steps, error)) {
+        return false;
+    }
+    m_steps = steps;
+    return true;
+}
+
+bool ScenarioRunner::parseLines(const QStringList& lines, int& index, int depth, QList<ScenarioStep>& steps, QString* error)
+{
+    static const QStringList knownActions = {
+        "columns", "fullscreen", "exit-fullscreen", "refresh-all", "add", "edit", "delete",
+        "logout", "login", "wait"
+    };
+
+    auto fail = [error](int line, const QString& message) {
+        if (error) {
+            *error = QString("line %1: %2").arg(line).arg(message);
+        }
+        return false;
+    };
+
+    while (index < lines.size()) {
+        const int lineNumber = index + 1;
+        QString line = lines[index++];
+        int comment = line.indexOf('#');
+        if (comment >= 0) {
+            line.truncate(comment);
+        }
+        QStringList words = line.split(' ', Qt::SkipEmptyParts);
+        if (words.isEmpty()) {
+            continue;
+        }
+
+        ScenarioStep step;
+        step.action = words.takeFirst().toLower();
+        step.args = words;
+        step.line = lineNumber;
+
+        if (step.action == "end") {
+            if (depth == 0) {
+                return fail(lineNumber, "'end' without 'repeat'");
+            }
+            return true;
+        }
+
+        if (step.action == "repeat") {
+            bool ok = false;
+            int count = step.args.value(0).toInt(&ok);
+            if (!ok || count < 0) {
+                return fail(lineNumber, "repeat needs a non-negative count");
+            }
+            if (depth >= MAX_REPEAT_DEPTH) {
+                return fail(lineNumber, "repeat blocks nested too deeply");
+            }
+
+            QList<ScenarioStep> body;
+            if (!parseLines(lines, index, depth + 1, body, error)) {
+                return false;
+            }
+            for (int i = 0; i < count; ++i) {
+                steps.append(body);
+            }
+            continue;
+        }
+
+        if (!knownActions.contains(step.action)) {
+            return fail(lineNumber, QString("unknown action '%1'").arg(step.action));
+        }
+        bool needsNumber = step.action == "columns" || step.action == "edit" ||
+                           step.action == "delete" || step.action == "wait";
+        if (needsNumber) {
+            bool ok = false;
+            step.args.value(0).toInt(&ok);
+            if (!ok) {
+                return fail(lineNumber, QString("'%1' needs a number").arg(step.action));
+            }
+        }
+        steps.append(step);
+    }
+
+    if (depth > 0) {
+        return fail(lines.size(), "'repeat' without 'end'");
+    }
+    return true;
+}
+
+int ScenarioRunner::stepCount() const
+{
+    return m_steps.size();
+}
+
+void ScenarioRunner::setSettleMs(int settleMs)
+{
+    m_settleMs = qMax(1, settleMs);
+}
+
+void ScenarioRunner::setStepTimeoutMs(int timeoutMs)
+{
+    m_stepTimeoutMs = qMax(m_settleMs, timeoutMs);
+}
+
+void ScenarioRunner::setLoopUntil(qint64 deadlineNs)
+{
+    m_loopUntilNs = deadlineNs;
+}
+
+int ScenarioRunner::completedSteps() const
+{
+    return m_completedSteps;
+}
+
+void ScenarioRunner::start()
+{
+    // Frames are seen through an application-wide filter; only this window's count
+    QCoreApplication::instance()->installEventFilter(this);
+    m_pollTimer.start(5);
+
+    m_nextStep = 0;
+    beginMeasurement("startup", DatabaseManager::getInstance()->getAllSubWindows().size());
+}
+
+void ScenarioRunner::nextStep()
+{
+    if (m_nextStep >= m_steps.size() && !m_steps.isEmpty() && Tracer::getInstance()->now() < m_loopUntilNs) {
+        m_nextStep = 0;
+    }
+    if (m_nextStep >= m_steps.size()) {
+        m_pollTimer.stop();
+        QCoreApplication::instance()->removeEventFilter(this);
+        emit finished();
+        return;
+    }
+
+    const ScenarioStep step = m_steps[m_nextStep++];
+    if (step.action == "wait") {
+        QTimer::singleShot(step.args.value(0).toInt(), this, &ScenarioRunner::nextStep);
+        return;
+    }
+
+    // The clock starts when the input is queued, so event-loop backlog counts too
+    beginMeasurement(step.action, 0);
+    QCoreApplication::postEvent(this, new ScenarioInputEvent(InputEventType, step));
+}
+
+void ScenarioRunner::customEvent(QEvent* event)
+{
+    if (event->type() == InputEventType) {
+        dispatch(static_cast<ScenarioInputEvent*>(event)->step);
+        return;
+    }
+    QObject::customEvent(event);
+}
+
+void ScenarioRunner::dispatch(const ScenarioStep& step)
+{
+    watchTiles();
+
+    if (step.action == "columns") {
+        m_window->applyWindowColumns(step.args.value(0).toInt());
+    } else if (step.action == "fullscreen") {
+        if (BrowserWidget* widget = tileAt(step, 0)) {
+            m_window->showFullscreenWindow(widget);
+        }
+    } else if (step.action == "exit-fullscreen") {
+        m_window->hideFullscreenWindow();
+    } else if (step.action == "refresh-all") {
+        // Off-screen tiles are deferred by the refresh queue until scrolled into view
+        m_window->onRefreshAll();
+        m_expectedLoads = m_window->windowManager()->getRefreshQueue()->total();
+    } else if (step.action == "add") {
+        int page = m_nextPage++;
+        QJsonObject subWindow;
+        subWindow["name"] = step.args.value(0, QString("Scenario %1").arg(page));
+        subWindow["url"] = m_server->tileUrl(page);
+
+        SubWindowChangeSet changes;
+        changes.added.append(subWindow);
+        m_expectedLoads = 1;
+        m_window->subWindowManager()->applyChanges(changes);
+    } else if (step.action == "edit") {
+        if (BrowserWidget* widget = tileAt(step, 0)) {
+            QJsonObject subWindow;
+            subWindow["id"] = widget->getSubWindowId();
+            subWindow["name"] = widget->getSubWindowName();
+            subWindow["url"] = m_server->tileUrl(m_nextPage++);
+
+            SubWindowChangeSet changes;
+            changes.updated.append(subWindow);
+            m_expectedLoads = 1;
+            m_window->subWindowManager()->applyChanges(changes);
+        }
+    } else if (step.action == "delete") {
+        if (BrowserWidget* widget = tileAt(step, 0)) {
+            SubWindowChangeSet changes;
+            changes.deleted.append(widget->getSubWindowId());
+            m_window->subWindowManager()->applyChanges(changes);
+        }
+    } else if (step.action == "logout") {
+        m_window->logout();
+    } else if (step.action == "login") {
+        m_window->completeLogin(step.args.value(0, "bench"));
+    }
+
+    // Something must be repainted even when the action changed nothing visible
+    m_window->update();
+}
+
+void ScenarioRunner::beginMeasurement(const QString& name, int expectedLoads)
+{
+    m_current = name;
+    m_measuring = true;
+    m_inputNs = Tracer::getInstance()->now();
+    m_lastPaintNs = 0;
+    m_expectedLoads = expectedLoads;
+    m_finishedLoads = 0;
+
+    if (!m_stats.contains(name)) {
+        m_actionOrder.append(name);
+    }
+    m_stats[name];
+}
+
+void ScenarioRunner::endMeasurement(bool timedOut)
+{
+    m_measuring = false;
+    ActionStats& stats = m_stats[m_current];
+    qint64 latencyNs = -1;
+    if (timedOut) {
+        ++stats.timeouts;
+    } else {
+        latencyNs = m_lastPaintNs - m_inputNs;
+        stats.latenciesNs.append(latencyNs);
+    }
+    ++m_completedSteps;
+    emit stepFinished(m_current, latencyNs);
+
+    // Steps run back to back, but never inside the previous step's event handling
+    QTimer::singleShot(0, this, &ScenarioRunner::nextStep);
+}
+
+void ScenarioRunner::onPoll()
+{
+    if (!m_measuring) {
+        return;
+    }
+    watchTiles();
+
+    const qint64 now = Tracer::getInstance()->now();
+    if (now - m_inputNs > qint64(m_stepTimeoutMs) * 1000000) {
+        LOG_WARNING("bench") << "ScenarioRunner:" << m_current << "did not settle within" << m_stepTimeoutMs << "ms";
+        endMeasurement(true);
+        return;
+    }
+
+    bool loadsDone = m_finishedLoads >= m_expectedLoads;
+    bool painted = m_lastPaintNs > m_inputNs;
+    if (loadsDone && painted && now - m_lastPaintNs >= qint64(m_settleMs) * 1000000) {
+        endMeasurement(false);
+    }
+}
+
+bool ScenarioRunner::eventFilter(QObject* watched, QEvent* event)
+{
+    if (m_measuring && event->type() == QEvent::Paint) {
+        QWidget* widget = qobject_cast<QWidget*>(watched);
+        if (widget && widget->window() == m_window) {
+            m_lastPaintNs = Tracer::getInstance()->now();
+        }
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+void ScenarioRunner::watchTiles()
+{
+    // Widgets come and go with add/delete and pool resizing
+    for (BrowserWidget* widget : m_window->findChildren<BrowserWidget*>()) {
+        if (m_watched.contains(widget)) {
+            continue;
+        }
+        m_watched.insert(widget);
+        connect(widget, &BrowserWidget::loadFinished, this, [this]() {
+            if (m_measuring) {
+                ++m_finishedLoads;
+            }
+        });
+        connect(widget, &QObject::destroyed, this, [this, widget]() {
+            m_watched.remove(widget);
+        });
+    }
+}
+
+QList<BrowserWidget*> ScenarioRunner::tiles() const
+{
+    QList<BrowserWidget*> result;
+    if (!m_window->windowManager()) {
+        return result;
+    }
+    for (BrowserWidget* widget : m_window->windowManager()->getBrowserWidgets()) {
+        if (widget && widget->getSubWindowId() > 0) {
+            result.append(widget);
+        }
+    }
+    return result;
+}
+
+BrowserWidget* ScenarioRunner::tileAt(const ScenarioStep& step, int argIndex) const
+{
+    QList<BrowserWidget*> wall = tiles();
+    int index = step.args.value(argIndex, "0").toInt();
+    if (index < 0 || index >= wall.size()) {
+        LOG_WARNING("bench") << "ScenarioRunner: line" << step.line << "tile" << index << "out of range, wall has" << wall.size();
+        return nullptr;
+    }
+    return wall[index];
+}
+
+qint64 ScenarioRunner::percentile(QList<qint64> sortedValues, double fraction)
+{
+    // Nearest rank
+    if (sortedValues.isEmpty()) {
+        return -1;
+    }
+    int rank = qBound(1, static_cast<int>(std::ceil(fraction * sortedValues.size())), static_cast<int>(sortedValues.size()));
+    return sortedValues[rank - 1];
+}
+
+bool ScenarioRunner::hasTimeouts() const
+{
+    for (const ActionStats& stats : m_stats) {
+        if (stats.timeouts > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+QJsonObject ScenarioRunner::report() const
+{
+    QJsonArray actions;
+    for (const QString& name : m_actionOrder) {
+        const ActionStats stats = m_stats.value(name);
+        QList<qint64> sorted = stats.latenciesNs;
+        std::sort(sorted.begin(), sorted.end());
+
+        QJsonObject action;
+        action["action"] = name;
+        action["count"] = sorted.size();
+        action["timeouts"] = stats.timeouts;
+        action["p50Ms"] = percentile(sorted, 0.50) / 1e6;
+        action["p95Ms"] = percentile(sorted, 0.95) / 1e6;
+        action["p99Ms"] = percentile(sorted, 0.99) / 1e6;
+        action["maxMs"] = sorted.isEmpty() ? -1.0 : sorted.last() / 1e6;
+        actions.append(action);
+    }
+
+    QJsonObject result;
+    result["settleMs"] = m_settleMs;
+    result["steps"] = m_steps.size();
+    result["actions"] = actions;
+    return result;
+}
+
+void ScenarioRunner::print(QTextStream& out) const
+{
+    out << QString("%1 %2 %3 %4 %5 %6 %7\n")
+        .arg(QString("action"), -16).arg(QString("n"), 5).arg(QString("p50 ms"), 9)
+        .arg(QString("p95 ms"), 9).arg(QString("p99 ms"), 9).arg(QString("max ms"), 9).arg(QString("timeouts"), 9);
+
+    for (const QJsonValue& value : report()["actions"].toArray()) {
+        QJsonObject action = value.toObject();
+        out << QString("%1 %2 %3 %4 %5 %6 %7\n")
+            .arg(action["action"].toString(), -16)
+            .arg(action["count"].toInt(), 5)
+            .arg(action["p50Ms"].toDouble(), 9, 'f', 1)
+            .arg(action["p95Ms"].toDouble(), 9, 'f', 1)
+            .arg(action["p99Ms"].toDouble(), 9, 'f', 1)
+            .arg(action["maxMs"].toDouble(), 9, 'f', 1)
+            .arg(action["timeouts"].toInt(), 9);
+    }
+    out.flush();
+}
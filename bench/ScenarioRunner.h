@@ -0,0 +1,124 @@
+#ifndef SCENARIORUNNER_H
+#define SCENARIORUNNER_H
+
+#include <QObject>
+#include <QEvent>
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QSet>
+#include <QStringList>
+#include <QTimer>
+
+class MainWindow;
+class BrowserWidget;
+class TestPageServer;
+class QTextStream;
+
+// One operator action from a scenario file
+struct ScenarioStep
+{
+    QString action;
+    QStringList args;
+    int line = 0;
+};
+
+// Replays a scenario against a live MainWindow and measures each action from its
+// input event to the settled frame.
+//
+// Scenario files are plain text, one action per line; '#' starts a comment:
+//
+//   columns <n>              applyWindowColumns(n)
+//   fullscreen [tile]        overlay tile (0-based, default 0) over the wall
+//   exit-fullscreen
+//   refresh-all              settles once every on-screen tile has reloaded
+//   add [name]               new sub-window on the next test page; settles when it loaded
+//   edit <tile>              point a tile at a new test page; settles when it loaded
+//   delete <tile>
+//   logout
+//   login [user]             completeLogin() as after a successful login dialog
+//   wait <ms>                pause, not measured
+//   repeat <n> ... end       blocks may nest
+//
+// An action's input event is posted to the event loop; its latency runs from the
+// post to the last frame painted before the window stays quiet for the settle time.
+// With setLoopUntil() the steps are replayed until the deadline (soak mode).
+class ScenarioRunner : public QObject
+{
+    Q_OBJECT
+
+public:
+    ScenarioRunner(MainWindow* window, TestPageServer* server, QObject *parent = nullptr);
+
+    bool load(const QString& filePath, QString* error);
+    bool parse(const QString& text, QString* error);
+    int stepCount() const;
+
+    void setSettleMs(int settleMs);       // Quiet time that counts as a settled frame
+    void setStepTimeoutMs(int timeoutMs); // Steps that never settle are reported as timed out
+    void setLoopUntil(qint64 deadlineNs); // Soak mode: replay the steps until this Tracer time
+    int completedSteps() const;
+
+    // Waits for the initial wall to load (reported as "startup"), then replays the
+    // steps and emits finished()
+    void start();
+
+    QJsonObject report() const;
+    void print(QTextStream& out) const;
+    bool hasTimeouts() const;
+
+signals:
+    void stepFinished(const QString& action, qint64 latencyNs);  // latencyNs < 0 = timed out
+    void finished();
+
+protected:
+    void customEvent(QEvent* event) override;
+    bool eventFilter(QObject* watched, QEvent* event) override;
+
+private slots:
+    void onPoll();
+
+private:
+    struct ActionStats
+    {
+        QList<qint64> latenciesNs;
+        int timeouts = 0;
+    };
+
+    bool parseLines(const QStringList& lines, int& index, int depth, QList<ScenarioStep>& steps, QString* error);
+    void nextStep();
+    void dispatch(const ScenarioStep& step);
+    void beginMeasurement(const QString& name, int expectedLoads);
+    void endMeasurement(bool timedOut);
+    void watchTiles();
+    QList<BrowserWidget*> tiles() const;
+    BrowserWidget* tileAt(const ScenarioStep& step, int argIndex) const;
+    static qint64 percentile(QList<qint64> sortedValues, double fraction);
+
+    static const QEvent::Type InputEventType;
+
+    MainWindow* m_window;
+    TestPageServer* m_server;
+    QList<ScenarioStep> m_steps;
+    int m_nextStep;
+    int m_nextPage;            // Test page for the next add/edit, after the seeded ones
+    int m_settleMs;
+    int m_stepTimeoutMs;
+    qint64 m_loopUntilNs;      // 0 = one pass
+    int m_completedSteps;
+    QTimer m_pollTimer;
+
+    // Current measurement
+    QString m_current;
+    bool m_measuring;
+    qint64 m_inputNs;          // When the input event was posted
+    qint64 m_lastPaintNs;      // Last frame painted in the window since then
+    int m_expectedLoads;
+    int m_finishedLoads;
+
+    QSet<BrowserWidget*> m_watched;
+    QHash<QString, ActionStats> m_stats;
+    QStringList m_actionOrder;  // First-seen order, for the report
+};
+
+#endif // SCENARIORUNNER_H
@@ -0,0 +1,264 @@
+#include "SoakMonitor.h"
+#include "MainWindow.h"
+#include "WindowManager.h"
+#include "PageCache.h"
+#include "ProcStats.h"
+#include "Tracer.h"
+#include <QApplication>
+#include <QJsonArray>
+#include <QTextStream>
+#include <QWidget>
+
+const QStringList SoakMonitor::CHEAP_METRICS = {
+    "qobjects", "widgets", "layout_items", "content_widgets", "cached_pages", "browser_rss_bytes"
+};
+const QStringList SoakMonitor::PROCESS_METRICS = {
+    "renderer_rss_bytes", "tree_rss_bytes", "renderer_processes"
+};
+const double SoakMonitor::WARM_UP_FRACTION = 0.1;  // Caches and pools fill up first
+const double SoakMonitor::RISING_FRACTION = 0.9;   // Of sample intervals that must grow
+
+SoakMonitor::SoakMonitor(MainWindow* window, QObject *parent)
+    : QObject(parent)
+    , m_window(window)
+    , m_sampleEvery(25)
+    , m_steps(0)
+    , m_startNs(0)
+{
+}
+
+void SoakMonitor::setSampleEvery(int steps)
+{
+    m_sampleEvery = qMax(1, steps);
+}
+
+void SoakMonitor::start()
+{
+    m_startNs = Tracer::getInstance()->now();
+    m_steps = 0;
+    m_samples.clear();
+    m_lastCheap = readCheapMetrics();
+    takeSample();
+}
+
+void SoakMonitor::finish()
+{
+    if (m_samples.isEmpty() || m_samples.last().steps != m_steps) {
+        takeSample();
+    }
+}
+
+void SoakMonitor::onStepFinished(const QString& action)
+{
+    ++m_steps;
+
+    // Attribute the change since the previous step to this action
+    QHash<QString, qint64> cheap = readCheapMetrics();
+    if (!m_actionGrowth.contains(action)) {
+        m_actionOrder.append(action);
+    }
+    ActionGrowth& growth = m_actionGrowth[action];
+    ++growth.count;
+    for (const QString& metric : CHEAP_METRICS) {
+        growth.totalDelta[metric] += cheap.value(metric) - m_lastCheap.value(metric);
+    }
+    m_lastCheap = cheap;
+
+    if (m_steps % m_sampleEvery == 0) {
+        takeSample();
+    }
+}
+
+QHash<QString, qint64> SoakMonitor::readCheapMetrics() const
+{
+    QHash<QString, qint64> values;
+
+    // Every object reachable from a top-level widget or the application
+    qint64 objects = 1 + QCoreApplication::instance()->findChildren<QObject*>().size();
+    for (QWidget* topLevel : QApplication::topLevelWidgets()) {
+        objects += 1 + topLevel->findChildren<QObject*>().size();
+    }
+    values["qobjects"] = objects;
+    values["widgets"] = QApplication::allWidgets().size();
+
+    WindowManager* windowManager = m_window->findChild<WindowManager*>();
+    values["layout_items"] = windowManager ? windowManager->layoutItemCount() : 0;
+    values["content_widgets"] = windowManager ? windowManager->contentWidgetCount() : 0;
+    values["cached_pages"] = windowManager ? windowManager->getPageCache()->size() : 0;
+
+    values["browser_rss_bytes"] = ProcStats::read(QCoreApplication::applicationPid()).rssBytes;
+    return values;
+}
+
+void SoakMonitor::takeSample()
+{
+    Sample sample;
+    sample.steps = m_steps;
+    sample.elapsedSeconds = (Tracer::getInstance()->now() - m_startNs) / 1e9;
+    sample.values = readCheapMetrics();
+
+    qint64 rendererRss = 0;
+    qint64 treeRss = sample.values.value("browser_rss_bytes");
+    qint64 renderers = 0;
+    for (qint64 pid : ProcStats::descendants(QCoreApplication::applicationPid())) {
+        ProcessSample process = ProcStats::read(pid);
+        if (!process.valid) {
+            continue;
+        }
+        treeRss += process.rssBytes;
+        if (ProcStats::chromiumProcessType(pid) == "renderer") {
+            rendererRss += process.rssBytes;
+            ++renderers;
+        }
+    }
+    sample.values["renderer_rss_bytes"] = rendererRss;
+    sample.values["tree_rss_bytes"] = treeRss;
+    sample.values["renderer_processes"] = renderers;
+
+    m_samples.append(sample);
+}
+
+bool SoakMonitor::isByteMetric(const QString& metric)
+{
+    return metric.endsWith("_bytes");
+}
+
+SoakMonitor::Trend SoakMonitor::trend(const QString& metric) const
+{
+    Trend result;
+    const int skip = static_cast<int>(m_samples.size() * WARM_UP_FRACTION);
+    const int count = m_samples.size() - skip;
+    if (count < 2) {
+        return result;
+    }
+
+    double meanX = 0.0;
+    double meanY = 0.0;
+    for (int i = skip; i < m_samples.size(); ++i) {
+        meanX += m_samples[i].steps;
+        meanY += m_samples[i].values.value(metric);
+    }
+    meanX /= count;
+    meanY /= count;
+
+    double covariance = 0.0;
+    double variance = 0.0;
+    int rising = 0;
+    for (int i = skip; i < m_samples.size(); ++i) {
+        double dx = m_samples[i].steps - meanX;
+        covariance += dx * (m_samples[i].values.value(metric) - meanY);
+        variance += dx * dx;
+        // Flat intervals do not count, so one step up after a flat stretch is not growth
+        if (i > skip && m_samples[i].values.value(metric) > m_samples[i - 1].values.value(metric)) {
+            ++rising;
+        }
+    }
+
+    result.first = m_samples[skip].values.value(metric);
+    result.last = m_samples.last().values.value(metric);
+    result.slopePerStep = variance > 0.0 ? covariance / variance : 0.0;
+    result.risingFraction = static_cast<double>(rising) / (count - 1);
+
+    // Sizes jitter; a byte metric must also grow past 1 MiB and 2% of its start
+    qint64 growth = result.last - result.first;
+    bool pastNoise = isByteMetric(metric)
+        ? growth > qMax<qint64>(1024 * 1024, result.first / 50)
+        : growth > 0;
+    result.suspect = count >= 5 && pastNoise && result.slopePerStep > 0.0 && result.risingFraction >= RISING_FRACTION;
+    return result;
+}
+
+bool SoakMonitor::hasLeakSuspects() const
+{
+    for (const QString& metric : CHEAP_METRICS + PROCESS_METRICS) {
+        if (trend(metric).suspect) {
+            return true;
+        }
+    }
+    return false;
+}
+
+QJsonObject SoakMonitor::report() const
+{
+    QJsonArray metrics;
+    for (const QString& metric : CHEAP_METRICS + PROCESS_METRICS) {
+        Trend t = trend(metric);
+        QJsonObject entry;
+        entry["metric"] = metric;
+        entry["first"] = t.first;
+        entry["last"] = t.last;
+        entry["growthPer1000Steps"] = t.slopePerStep * 1000.0;
+        entry["risingFraction"] = t.risingFraction;
+        entry["suspect"] = t.suspect;
+        metrics.append(entry);
+    }
+
+    QJsonArray actions;
+    for (const QString& action : m_actionOrder) {
+        const ActionGrowth growth = m_actionGrowth.value(action);
+        QJsonObject entry;
+        entry["action"] = action;
+        entry["count"] = growth.count;
+        for (const QString& metric : CHEAP_METRICS) {
+            entry[metric + "PerStep"] = growth.count > 0 ? double(growth.totalDelta.value(metric)) / growth.count : 0.0;
+        }
+        actions.append(entry);
+    }
+
+    QJsonArray samples;
+    for (const Sample& sample : m_samples) {
+        QJsonObject entry;
+        entry["steps"] = sample.steps;
+        entry["elapsedSeconds"] = sample.elapsedSeconds;
+        for (auto it = sample.values.constBegin(); it != sample.values.constEnd(); ++it) {
+            entry[it.key()] = it.value();
+        }
+        samples.append(entry);
+    }
+
+    QJsonObject result;
+    result["steps"] = m_steps;
+    result["elapsedSeconds"] = m_samples.isEmpty() ? 0.0 : m_samples.last().elapsedSeconds;
+    result["leakSuspects"] = hasLeakSuspects();
+    result["metrics"] = metrics;
+    result["actions"] = actions;
+    result["samples"] = samples;
+    return result;
+}
+
+void SoakMonitor::print(QTextStream& out) const
+{
+    QJsonObject result = report();
+    out << "soak: " << result["steps"].toInt() << " steps in "
+        << QString::number(result["elapsedSeconds"].toDouble() / 60.0, 'f', 1) << " min, "
+        << m_samples.size() << " samples\n\n";
+
+    out << QString("%1 %2 %3 %4 %5\n").arg(QString("metric"), -20).arg(QString("first"), 14)
+        .arg(QString("last"), 14).arg(QString("per 1000 steps"), 16).arg(QString("rising"), 8);
+    for (const QJsonValue& value : result["metrics"].toArray()) {
+        QJsonObject entry = value.toObject();
+        out << QString("%1 %2 %3 %4 %5%6\n")
+            .arg(entry["metric"].toString(), -20)
+            .arg(entry["first"].toInteger(), 14)
+            .arg(entry["last"].toInteger(), 14)
+            .arg(entry["growthPer1000Steps"].toDouble(), 16, 'f', 1)
+            .arg(entry["risingFraction"].toDouble(), 8, 'f', 2)
+            .arg(QString(entry["suspect"].toBool() ? "  LEAK?" : ""));
+    }
+
+    out << "\nGrowth per step, by action:\n";
+    out << QString("%1 %2").arg(QString("action"), -16).arg(QString("n"), 6);
+    for (const QString& metric : CHEAP_METRICS) {
+        out << QString(" %1").arg(metric, 18);
+    }
+    out << "\n";
+    for (const QJsonValue& value : result["actions"].toArray()) {
+        QJsonObject entry = value.toObject();
+        out << QString("%1 %2").arg(entry["action"].toString(), -16).arg(entry["count"].toInt(), 6);
+        for (const QString& metric : CHEAP_METRICS) {
+            out << QString(" %1").arg(entry[metric + "PerStep"].toDouble(), 18, 'f', 2);
+        }
+        out << "\n";
+    }
+    out.flush();
+}
@@ -0,0 +1,82 @@
+#ifndef SOAKMONITOR_H
+#define SOAKMONITOR_H
+
+#include <QObject>
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QStringList>
+
+class MainWindow;
+class QTextStream;
+
+// Memory and object-count samples taken while a scenario loops for hours, and the
+// growth analysis that turns them into leak suspects.
+//
+// Cheap metrics (Qt objects, widgets, tile layout items, browser RSS) are read after
+// every step and attributed to the step's action. The whole set, including the
+// /proc scan for renderer RSS, is sampled every N steps. A metric is a leak suspect
+// when, after the warm-up, it grows in nearly every sample interval and by more
+// than noise over the run.
+class SoakMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SoakMonitor(MainWindow* window, QObject *parent = nullptr);
+
+    void setSampleEvery(int steps);
+    void start();   // Baseline sample
+    void finish();  // Final sample
+
+    QJsonObject report() const;
+    void print(QTextStream& out) const;
+    bool hasLeakSuspects() const;
+
+public slots:
+    void onStepFinished(const QString& action);
+
+private:
+    struct Sample
+    {
+        int steps = 0;
+        double elapsedSeconds = 0.0;
+        QHash<QString, qint64> values;
+    };
+
+    struct Trend
+    {
+        qint64 first = 0;
+        qint64 last = 0;
+        double slopePerStep = 0.0;  // Least squares over the post-warm-up samples
+        double risingFraction = 0.0;  // Sample intervals with strict growth
+        bool suspect = false;
+    };
+
+    struct ActionGrowth
+    {
+        int count = 0;
+        QHash<QString, qint64> totalDelta;
+    };
+
+    QHash<QString, qint64> readCheapMetrics() const;
+    void takeSample();
+    Trend trend(const QString& metric) const;
+    static bool isByteMetric(const QString& metric);
+
+    static const QStringList CHEAP_METRICS;
+    static const QStringList PROCESS_METRICS;
+    static const double WARM_UP_FRACTION;
+    static const double RISING_FRACTION;
+
+    MainWindow* m_window;
+    int m_sampleEvery;
+    int m_steps;
+    qint64 m_startNs;
+    QList<Sample> m_samples;
+    QHash<QString, qint64> m_lastCheap;
+    QHash<QString, ActionGrowth> m_actionGrowth;
+    QStringList m_actionOrder;
+};
+
+#endif // SOAKMONITOR_H
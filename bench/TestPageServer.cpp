@@ -0,0 +1,196 @@
+#include "TestPageServer.h"
+#include <QTcpSocket>
+#include <QTimer>
+#include <QUrl>
+#include <QUrlQuery>
+#include <QRegularExpression>
+
+TestPageServer::TestPageServer(QObject *parent)
+    : QObject(parent)
+    , m_requestCount(0)
+{
+    connect(&m_server, &QTcpServer::newConnection, this, &TestPageServer::onNewConnection);
+}
+
+bool TestPageServer::start(quint16 port)
+{
+    return m_server.listen(QHostAddress::LocalHost, port);
+}
+
+quint16 TestPageServer::port() const
+{
+    return m_server.serverPort();
+}
+
+QString TestPageServer::tileUrl(int tile) const
+{
+    return QString("http://127.0.0.1:%1/tile/%2").arg(port()).arg(tile);
+}
+
+void TestPageServer::setProfile(const TestPageProfile& profile)
+{
+    m_profile = profile;
+}
+
+const TestPageProfile& TestPageServer::profile() const
+{
+    return m_profile;
+}
+
+int TestPageServer::requestCount() const
+{
+    return m_requestCount;
+}
+
+void TestPageServer::onNewConnection()
+{
+    while (QTcpSocket* socket = m_server.nextPendingConnection()) {
+        connect(socket, &QTcpSocket::readyRead, this, &TestPageServer::onReadyRead);
+        connect(socket, &QTcpSocket::disconnected, this, [this, socket]() {
+            m_pending.remove(socket);
+            socket->deleteLater();
+        });
+    }
+}
+
+void TestPageServer::onReadyRead()
+{
+    QTcpSocket* socket = qobject_cast<QTcpSocket*>(sender());
+    if (!socket) {
+        return;
+    }
+
+    QByteArray& buffer = m_pending[socket];
+    buffer.append(socket->readAll());
+    if (!buffer.contains("\r\n\r\n")) {
+        return;  // Headers not complete yet; request bodies are never used
+    }
+
+    QByteArray requestLine = buffer.left(buffer.indexOf("\r\n"));
+    m_pending.remove(socket);
+    disconnect(socket, &QTcpSocket::readyRead, this, &TestPageServer::onReadyRead);
+    ++m_requestCount;
+
+    QUrlQuery query(QUrl(QString::fromLatin1(requestLine.split(' ').value(1))));
+    int latencyMs = query.hasQueryItem("delay") ? query.queryItemValue("delay").toInt() : m_profile.latencyMs;
+    if (latencyMs > 0) {
+        QTimer::singleShot(latencyMs, socket, [this, socket, requestLine]() {
+            respond(socket, requestLine);
+        });
+    } else {
+        respond(socket, requestLine);
+    }
+}
+
+void TestPageServer::respond(QTcpSocket* socket, const QByteArray& requestLine)
+{
+    static const QRegularExpression tilePattern(R"(^/tile/(\d+)$)");
+    static const QRegularExpression assetPattern(R"(^/asset/(\d+)/(\d+)\.(js|css)$)");
+
+    QList<QByteArray> parts = requestLine.split(' ');
+    QUrl url(QString::fromLatin1(parts.value(1)));
+    QUrlQuery query(url);
+    QString path = url.path();
+
+    int status = 200;
+    QByteArray contentType;
+    QByteArray body;
+
+    QRegularExpressionMatch match = tilePattern.match(path);
+    if (parts.value(0) != "GET") {
+        status = 405;
+    } else if (match.hasMatch()) {
+        int pageKb = query.hasQueryItem("kb") ? query.queryItemValue("kb").toInt() : m_profile.pageKb;
+        int scriptMs = query.hasQueryItem("js") ? query.queryItemValue("js").toInt() : m_profile.scriptMs;
+        contentType = "text/html; charset=utf-8";
+        body = buildPage(match.captured(1).toInt(), pageKb, scriptMs);
+    } else if ((match = assetPattern.match(path)).hasMatch()) {
+        bool stylesheet = match.captured(3) == "css";
+        contentType = stylesheet ? "text/css" : "application/javascript";
+        body = buildAsset(match.captured(1).toInt(), match.captured(2).toInt(), stylesheet);
+    } else {
+        status = 404;
+    }
+
+    QByteArray response = QString("HTTP/1.0 %1 %2\r\n").arg(status)
+        .arg(QString(status == 200 ? "OK" : (status == 404 ? "Not Found" : "Method Not Allowed"))).toLatin1();
+    if (!contentType.isEmpty()) {
+        response += "Content-Type: " + contentType + "\r\n";
+    }
+    response += "Content-Length: " + QByteArray::number(body.size()) + "\r\n";
+    response += "Cache-Control: no-store\r\n";  // Every run fetches everything again
+    response += "Connection: close\r\n\r\n";
+    response += body;
+
+    socket->write(response);
+    socket->disconnectFromHost();
+}
+
+QByteArray TestPageServer::buildPage(int tile, int pageKb, int scriptMs) const
+{
+    QByteArray head;
+    for (int i = 0; i < m_profile.subresources; ++i) {
+        if (i % 2 == 0) {
+            head += QString("<link rel=\"stylesheet\" href=\"/asset/%1/%2.css\">\n").arg(tile).arg(i).toLatin1();
+        } else {
+            head += QString("<script src=\"/asset/%1/%2.js\"></script>\n").arg(tile).arg(i).toLatin1();
+        }
+    }
+
+    // Busy-wait on the renderer main thread, like a dashboard doing its first render
+    QByteArray script = QString(
+        "<script>\n"
+        "window.addEventListener('load', function() {\n"
+        "  var end = performance.now() + %1;\n"
+        "  var x = 0;\n"
+        "  while (performance.now() < end) { x += Math.sqrt(x + 1); }\n"
+        "  document.getElementById('status').textContent = 'ready ' + (x > 0);\n"
+        "});\n"
+        "</script>\n").arg(qMax(0, scriptMs)).toLatin1();
+
+    QByteArray page = "<!DOCTYPE html>\n<html><head><meta charset=\"utf-8\">\n";
+    page += QString("<title>Tile %1</title>\n").arg(tile).toLatin1();
+    page += head;
+    page += script;
+    page += "</head><body>\n";
+    page += QString("<h1>Tile %1</h1><p id=\"status\">loading</p>\n").arg(tile).toLatin1();
+
+    const QByteArray tail = "</body></html>\n";
+    int fillerBytes = qMax(0, pageKb * 1024 - page.size() - static_cast<int>(tail.size()));
+    page += filler(tile, fillerBytes);
+    page += tail;
+    return page;
+}
+
+QByteArray TestPageServer::buildAsset(int tile, int index, bool stylesheet) const
+{
+    if (stylesheet) {
+        return QString(".tile-%1-%2 { color: #%3; padding: %4px; }\n")
+            .arg(tile).arg(index).arg((tile * 7919 + index) % 0xFFFFFF, 6, 16, QChar('0')).arg(index % 8).toLatin1();
+    }
+    return QString("window.asset_%1_%2 = %3;\n").arg(tile).arg(index).arg(tile * 1000 + index).toLatin1();
+}
+
+QByteArray TestPageServer::filler(int tile, int bytes)
+{
+    // Paragraphs of pseudo-random words from a fixed seed: same bytes on every run
+    static const char* const words[] = {
+        "latency", "render", "tile", "dashboard", "metric", "frame", "queue", "socket",
+        "paint", "layout", "script", "style", "buffer", "thread", "cache", "request"
+    };
+
+    QByteArray result;
+    result.reserve(bytes);
+    quint32 state = 2166136261u ^ static_cast<quint32>(tile);
+    while (result.size() < bytes) {
+        result += "<p>";
+        for (int i = 0; i < 24; ++i) {
+            state = state * 1664525u + 1013904223u;
+            result += words[(state >> 16) % 16];
+            result += ' ';
+        }
+        result += "</p>\n";
+    }
+    result.truncate(bytes);
+    return result;
+}
@@ -0,0 +1,60 @@
+#ifndef TESTPAGESERVER_H
+#define TESTPAGESERVER_H
+
+#include <QObject>
+#include <QTcpServer>
+#include <QHash>
+#include <QByteArray>
+
+class QTcpSocket;
+
+// Shape of the pages served by TestPageServer
+struct TestPageProfile
+{
+    int pageKb = 64;         // Size of the HTML document
+    int scriptMs = 20;       // Main-thread JavaScript busy time on load
+    int latencyMs = 0;       // Delay before each response, documents and subresources alike
+    int subresources = 4;    // Stylesheets/scripts referenced by each page
+};
+
+// Minimal HTTP/1.0 server on loopback for the load benchmark. Every response is
+// generated from the request path and the profile, so runs are reproducible
+// and need no network access.
+//
+//   /tile/<n>          HTML document for tile n
+//   /asset/<n>/<i>.js  Subresource i of tile n
+//   /asset/<n>/<i>.css
+//
+// Query parameters kb, js and delay override the profile for one request.
+class TestPageServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TestPageServer(QObject *parent = nullptr);
+
+    bool start(quint16 port = 0);  // 0 = any free port
+    quint16 port() const;
+    QString tileUrl(int tile) const;
+
+    void setProfile(const TestPageProfile& profile);
+    const TestPageProfile& profile() const;
+    int requestCount() const;
+
+private slots:
+    void onNewConnection();
+    void onReadyRead();
+
+private:
+    void respond(QTcpSocket* socket, const QByteArray& requestLine);
+    QByteArray buildPage(int tile, int pageKb, int scriptMs) const;
+    QByteArray buildAsset(int tile, int index, bool stylesheet) const;
+    static QByteArray filler(int tile, int bytes);
+
+    QTcpServer m_server;
+    TestPageProfile m_profile;
+    QHash<QTcpSocket*, QByteArray> m_pending;  // Request bytes received so far
+    int m_requestCount;
+};
+
+#endif // TESTPAGESERVER_H
@@ -173,6 +173,44 @@ build_project() {
     log_success "项目构建完成"
 }
 
+# PGO 构建: 插桩构建 -> 无界面训练负载 -> 使用配置文件重新构建 (同一构建目录, GCC 按目标文件路径查找配置文件)
+pgo_build() {
+    log_info "PGO 构建 (LTO + 配置文件引导优化)..."
+    
+    if [[ "$OS" == "linux" ]]; then
+        CORES=$(nproc)
+    elif [[ "$OS" == "macos" ]]; then
+        CORES=$(sysctl -n hw.ncpu)
+    else
+        CORES=4
+    fi
+    
+    PGO_BUILD_DIR="build-pgo"
+    PGO_DIR="$(pwd)/$PGO_BUILD_DIR/pgo-profiles"
+    rm -rf "$PGO_DIR"
+    
+    cmake -S . -B "$PGO_BUILD_DIR" \
+        -DCMAKE_BUILD_TYPE=Release \
+        -DBUILD_BENCHMARKS=ON \
+        -DBSS_ENABLE_LTO=ON \
+        -DBSS_PGO=GENERATE \
+        -DBSS_PGO_DIR="$PGO_DIR"
+    cmake --build "$PGO_BUILD_DIR" --parallel $CORES
+    
+    log_info "运行训练负载 (无界面加载与交互场景)..."
+    cmake --build "$PGO_BUILD_DIR" --target pgo-train
+    
+    # Clang 的原始配置文件需要先合并
+    if ls "$PGO_DIR"/*.profraw &> /dev/null; then
+        llvm-profdata merge -o "$PGO_DIR/merged.profdata" "$PGO_DIR"/*.profraw
+    fi
+    
+    cmake -S . -B "$PGO_BUILD_DIR" -DBSS_PGO=USE
+    cmake --build "$PGO_BUILD_DIR" --parallel $CORES
+    
+    log_success "PGO 构建完成: $PGO_BUILD_DIR/BrowserSplitScreen"
+}
+
 # 运行测试
 run_tests() {
     log_info "运行测试..."
@@ -319,6 +357,7 @@ show_help() {
     echo "  -c, --clean         清理构建目录"
     echo "  -d, --deps          安装依赖"
     echo "  -b, --build         构建项目"
+    echo "  -P, --pgo           LTO + PGO 优化构建 (需要 Qt WebEngine 可运行)"
     echo "  -t, --test          运行测试"
     echo "  -i, --install       安装到系统"
     echo "  -p, --package       创建发布包"
@@ -352,6 +391,10 @@ main() {
                 BUILD=true
                 shift
                 ;;
+            -P|--pgo)
+                PGO=true
+                shift
+                ;;
             -t|--test)
                 TEST=true
                 shift
@@ -381,7 +424,7 @@ main() {
     done
     
     # 如果没有指定任何选项，显示帮助
-    if [[ -z "$CLEAN" && -z "$INSTALL_DEPS" && -z "$BUILD" && -z "$TEST" && -z "$INSTALL" && -z "$PACKAGE" && -z "$DEPLOY" && -z "$ALL" ]]; then
+    if [[ -z "$CLEAN" && -z "$INSTALL_DEPS" && -z "$BUILD" && -z "$PGO" && -z "$TEST" && -z "$INSTALL" && -z "$PACKAGE" && -z "$DEPLOY" && -z "$ALL" ]]; then
         show_help
         exit 0
     fi
@@ -421,6 +464,11 @@ main() {
         build_project
     fi
     
+    if [[ "$PGO" == "true" ]]; then
+        check_dependencies
+        pgo_build
+    fi
+    
     if [[ "$TEST" == "true" ]]; then
         run_tests
     fi
@@ -0,0 +1,83 @@
+#ifndef BLOCKLIST_H
+#define BLOCKLIST_H
+
+#include <QtGlobal>
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QFile>
+#include <QString>
+#include <QStringList>
+
+// Compiled host/path blocklist, matched without allocating.
+//
+// Text lists are compiled ahead of time (tools/BlocklistCompiler, run by the build)
+// into a flat little-endian image that load() maps read-only and only bounds-checks:
+//
+//     Header     magic "BSSB", version, counts, string table size
+//     Node[]     host trie; node 0 is the root, labels run right to left
+//                ("ads.example.com" = com -> example -> ads)
+//     Edge[]     children of each node, sorted by label hash
+//     PathRule[] path segment and file extension rules, sorted by hash
+//     strings    label and rule text, lowercase, not terminated
+//
+// A host rule also covers every subdomain, so matching a host walks at most one
+// edge per label and stops at the first node that carries categories.
+//
+// Text list syntax, one rule per line, '#' starts a comment:
+//
+//     [ads]             category of the rules below (ads, trackers, heavy)
+//     doubleclick.net   host and all its subdomains
+//     /pagead/          a whole path segment
+//     *.mp4             a file extension of the last path segment
+class Blocklist
+{
+public:
+    enum Category : quint32 {
+        Ads = 0x1,
+        Trackers = 0x2,
+        Heavy = 0x4
+    };
+
+    Blocklist();
+    ~Blocklist();
+
+    bool load(const QString& path);  // Replaces any list loaded before
+    void unload();
+    bool isLoaded() const;
+    QString path() const;
+    int hostRuleCount() const;
+    int pathRuleCount() const;
+
+    // Categories (0 = not blocked). host must be lowercase, as QUrl::host() is.
+    quint32 matchHost(QByteArrayView host) const;
+    quint32 matchPath(QByteArrayView path) const;
+    quint32 match(QByteArrayView host, QByteArrayView path) const;
+
+    // Text lists -> image; false with a message on a syntax error
+    static bool compile(const QStringList& listPaths, QByteArray* image, QString* error);
+    static QString categoryName(quint32 categories);  // Name of the lowest category bit set
+
+    static const quint32 FORMAT_VERSION;
+
+private:
+    struct Header;
+    struct Node;
+    struct Edge;
+    struct PathRule;
+
+    bool attach(const uchar* data, qint64 size);
+    quint32 findPathRule(quint32 kind, QByteArrayView text) const;
+
+    QFile m_file;
+    const uchar* m_map;
+    const Node* m_nodes;
+    const Edge* m_edges;
+    const PathRule* m_pathRules;
+    const char* m_strings;
+    quint32 m_nodeCount;
+    quint32 m_edgeCount;
+    quint32 m_pathRuleCount;
+    quint32 m_hostRuleCount;
+};
+
+#endif // BLOCKLIST_H
@@ -11,6 +11,7 @@
 #include <QPushButton>
 #include <QHBoxLayout>
 #include <QVBoxLayout>
+#include <QStackedLayout>
 #include <QProgressBar>
 #include <QLabel>
 #include <QMenu>
@@ -22,6 +23,9 @@
 #include <QMouseEvent>
 #include <QGraphicsOpacityEffect>
 #include <QPropertyAnimation>
+#include "DatabaseManager.h"
+#include "ResourceSampler.h"
+#include "TileHud.h"
 
 class BrowserWidget : public QWidget
 {
@@ -35,6 +39,9 @@ public:
     QString getCurrentUrl() const;
     QString getCurrentTitle() const;
     void loadUrl(const QString& url);
+    void attachPage(QWebEnginePage* page);  // Show a cached page without reloading it
+    void clearSubWindow();
+    QString getRequestedUrl() const;
     void setWindowId(int id);
     void setSubWindowName(const QString& name);
     QString getSubWindowName() const;
@@ -42,6 +49,7 @@ public:
     int getSubWindowId() const;
     void saveState();
     void loadState();
+    WindowConfig captureWindowConfig() const;
     void saveCookies();
     void loadCookies();
     void clearLoginState();
@@ -53,6 +61,20 @@ public:
     bool isAllowResize() const;
     void updateWebViewResolution();
     double calculateOptimalZoomFactor() const;
+    void setScreenSize(const QSize& screenSize);  // Cached by WindowManager, not queried per resize
+    void setHudVisible(bool visible);
+    bool isHudVisible() const;
+    TileMetrics getTileMetrics() const;
+    qint64 getRendererPid() const;
+    void setResourceReading(const ResourceReading& reading);  // Latest ResourceSampler figures
+    
+    // Thumbnail wall: the tile shows a periodic snapshot and its page stays frozen in
+    // between; hovering, focusing or fullscreening the tile makes it live again
+    void setThumbnailMode(bool enabled);
+    bool isThumbnailMode() const;
+    void setThumbnailInterval(int seconds);
+    int getThumbnailInterval() const;
+    bool isLive() const;  // Showing the interactive page rather than a snapshot
     
     // Public interface methods
     void refresh();
@@ -64,14 +86,22 @@ signals:
     void titleChanged(const QString& title);
     void loadProgress(int progress);
     void loadFinished(bool success);
+    void firstPaint(qint64 elapsedNs);  // First rendered frame after a navigation started
     void fullscreenRequested();
     void closeRequested();
+    void zoomUpdateRequested();  // Coalesced into the next WindowManager frame pass
 
 private slots:
     void onUrlChanged(const QUrl& url);
     void onTitleChanged(const QString& title);
     void onLoadProgress(int progress);
+    void onLoadStarted();
     void onLoadFinished(bool success);
+    void updateHud();
+    void onThumbnailTimeout();
+    void onCaptureSettled();
+    void onLiveReleaseTimeout();
+    void updateLiveState();
     void onBackClicked();
     void onForwardClicked();
     void onRefreshClicked();
@@ -84,6 +114,10 @@ protected:
     void resizeEvent(QResizeEvent* event) override;
     void mouseMoveEvent(QMouseEvent* event) override;
     void showEvent(QShowEvent *event) override;
+    void enterEvent(QEnterEvent* event) override;
+    void leaveEvent(QEvent* event) override;
+    void paintEvent(QPaintEvent* event) override;
+    bool eventFilter(QObject* watched, QEvent* event) override;
 
 private:
     void setupUI();
@@ -95,14 +129,23 @@ private:
     void loadWindowState();
     void addToHistory(const QString& url, const QString& title);
     bool isValidUrl(const QString& url);
+    QWebEngineProfile* currentProfile() const;
     QString formatUrl(const QString& url);
+    bool wantsLive() const;
+    void beginCapture();
+    void captureThumbnail();
+    void showThumbnail();
+    void showLiveView();
+    void scheduleNextCapture();
+    void raiseOverlays();
 
     // UI Components
     QVBoxLayout* m_mainLayout;
     QHBoxLayout* m_toolbarLayout;
     QLabel* m_subWindowNameLabel;
-    QWebEngineProfile* m_profile;
     QWebEngineView* m_webView;
+    QStackedLayout* m_viewStack;    // Web view and thumbnail share one slot, stacked
+    QLabel* m_thumbnailLabel;
     QPushButton* m_fullscreenButton;
     QPushButton* m_refreshButton;
     QProgressBar* m_progressBar;
@@ -128,12 +171,14 @@ private:
     bool m_isFullscreen;
     bool m_showBrowserUI;
     bool m_allowResize;
-    QJsonObject m_windowState;
+    WindowConfig m_windowState;
+    QPointF m_pendingScrollPosition;  // Restored from window_configs, applied after load
     QTimer* m_saveTimer;
     
     // Resolution management
     double m_currentZoomFactor;
     QSize m_referenceSize;
+    QSize m_screenSize;
     bool m_autoResolutionEnabled;
     
     // Hover button management
@@ -154,6 +199,32 @@ private:
     // Pending cookie script to execute when page is ready
     QString m_pendingCookieScript;
     bool m_isLoaded = false;  // New: Track if URL is loaded
+    
+    // Trace timestamps (Tracer clock); -1 = not pending
+    qint64 m_createdNs = -1;
+    qint64 m_loadStartNs = -1;
+    
+    // Performance HUD
+    TileHud* m_hud;
+    qint64 m_lastNavigationNs = -1;
+    qint64 m_lastFirstPaintNs = -1;
+    bool m_awaitingFirstPaint = false;
+    int m_reloadCount = 0;
+    ResourceReading m_resourceReading;
+    
+    // Thumbnail wall
+    bool m_thumbnailMode = false;
+    bool m_live = true;
+    bool m_hovered = false;
+    int m_thumbnailInterval;      // Seconds
+    int m_captureAttempts = 0;
+    QTimer* m_thumbnailTimer;     // Next snapshot
+    QTimer* m_captureTimer;       // Lets a thawed page render before it is grabbed
+    QTimer* m_liveReleaseTimer;   // Keeps a tile live while the pointer crosses it
+    
+    static const int THUMBNAIL_SETTLE_MS;
+    static const int THUMBNAIL_MAX_SETTLE_ATTEMPTS;
+    static const int LIVE_RELEASE_MS;
 };
 
 #endif // BROWSERWIDGET_H
@@ -13,6 +13,52 @@
 #include <QCryptographicHash>
 #include <QVariant>
 #include <QByteArray>
+#include <QRect>
+#include <QPointF>
+#include <QStringList>
+
+// Per-tile state persisted in window_configs as typed columns
+struct WindowConfig
+{
+    enum LifecycleState {
+        Unloaded = 0,
+        Active = 1,
+        Frozen = 2,
+        Discarded = 3
+    };
+
+    int windowId = -1;
+    int subId = -1;
+    QString url;
+    QString title;
+    QRect geometry;
+    double zoomFactor = 1.0;
+    QPointF scrollPosition;
+    int lifecycleState = Unloaded;
+    QString homeUrl;  // sub_windows.url, joined in by loadWindowConfig()
+
+    bool isValid() const { return windowId > 0; }
+};
+
+// A batch of sub-window edits, applied by DatabaseManager in one transaction
+struct SubWindowChangeSet
+{
+    QList<QJsonObject> added;    // name, url, optional thumbnail_interval and refresh_interval
+    QList<QJsonObject> updated;  // id, name, url, optional thumbnail_interval and refresh_interval
+    QList<int> deleted;
+
+    bool isEmpty() const { return added.isEmpty() && updated.isEmpty() && deleted.isEmpty(); }
+};
+
+// What a committed change set did; added entries carry their new IDs
+struct SubWindowChangeResult
+{
+    QList<QJsonObject> added;    // id, name, url, thumbnail_interval, refresh_interval
+    QList<QJsonObject> updated;  // as passed in the change set
+    QList<int> deleted;
+
+    bool isEmpty() const { return added.isEmpty() && updated.isEmpty() && deleted.isEmpty(); }
+};
 
 class DatabaseManager : public QObject
 {
@@ -24,6 +70,11 @@ public:
     bool initialize();
     void close();
     
+    // Database file; ":memory:" gives a private in-memory database. Takes effect on the
+    // next initialize(). Defaults to BSS_DB_PATH, else browser_split_screen.db next to the executable.
+    void setDatabasePath(const QString& path);
+    QString getDatabasePath();
+    
     // User management
     bool createUser(const QString& username, const QString& password);
     bool authenticateUser(const QString& username, const QString& password);
@@ -39,14 +90,15 @@ public:
     bool deleteSubWindow(int subWindowId);
     QList<QJsonObject> getAllSubWindows();
     QJsonObject getSubWindow(int subWindowId);
+    bool applySubWindowChanges(const SubWindowChangeSet& changes, SubWindowChangeResult* result = nullptr);
+    static const int DEFAULT_THUMBNAIL_INTERVAL;  // Seconds, for sub-windows that do not set one
     
     
     // Window management
-    bool saveWindowConfig(int windowId, int subId, const QString& url, const QString& title, 
-                          const QJsonObject& geometry);
-    QJsonObject loadWindowConfig(int windowId);
+    bool saveWindowConfig(const WindowConfig& config);
+    WindowConfig loadWindowConfig(int windowId);
     bool deleteWindowConfig(int windowId);
-    QList<QJsonObject> getAllWindowConfigs();
+    QList<WindowConfig> getAllWindowConfigs();
     bool deleteWindowConfigsBySubId(int subId);
     
     // History management
@@ -71,10 +123,10 @@ private:
     
     static DatabaseManager* instance;
     QSqlDatabase database;
+    QString m_databasePath;  // Explicit override; empty = environment or default
     
     bool createTables();
     QString hashPassword(const QString& password);
-    QString getDatabasePath();
     
     // Table creation methods
     bool createUsersTable();
@@ -85,6 +137,10 @@ private:
     bool createAppSettingsTable();
     bool createUserSessionsTable();
 
+    // Schema migrations
+    QStringList tableColumns(const QString& table);
+    bool migrateLegacyWindowConfigs();
+
     QByteArray serializeVariant(const QVariant& value) const;
     QVariant deserializeVariant(const QByteArray& data, const QVariant& defaultValue) const;
 };
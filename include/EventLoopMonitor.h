@@ -0,0 +1,106 @@
+#ifndef EVENTLOOPMONITOR_H
+#define EVENTLOOPMONITOR_H
+
+#include <QApplication>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <atomic>
+#include <thread>
+
+// Watchdog for the GUI event loop. A background thread posts a heartbeat to the
+// GUI thread and measures how late it is handled; every lag goes into the
+// bss_event_loop_lag_seconds histogram. While a heartbeat is overdue by more
+// than STALL_THRESHOLD_MS the watchdog samples what the GUI thread is doing:
+// the innermost STALL_SCOPE label if one is active, else the receiver class and
+// event type recorded by MonitoredApplication::notify(). Each stall is charged
+// to the handler seen most often during it.
+class EventLoopMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Offender
+    {
+        QString handler;
+        int stalls = 0;
+        qint64 totalNs = 0;
+        qint64 maxNs = 0;
+    };
+
+    static EventLoopMonitor* getInstance();
+
+    void start();
+    void stop();
+    bool isRunning() const;
+
+    QList<Offender> topOffenders(int count = 10) const;
+    QString report(int count = 10) const;
+
+    // Dispatcher and scope hooks; only the GUI thread's calls are recorded
+    static void enterScope(const char* label);
+    static void leaveScope();
+
+    static const int HEARTBEAT_INTERVAL_MS;
+    static const int STALL_THRESHOLD_MS;
+    static constexpr int MAX_SCOPE_DEPTH = 16;
+
+private:
+    friend class MonitoredApplication;
+
+    explicit EventLoopMonitor(QObject* parent = nullptr);
+    ~EventLoopMonitor();
+
+    void watchdogLoop();
+    void onHeartbeat(qint64 sentNs);
+    QString currentHandler() const;
+    void finishStall(const QHash<QString, int>& samples, qint64 durationNs);
+
+    static EventLoopMonitor* instance;
+    static bool isGuiThread();
+
+    // What the GUI thread is executing; written by the GUI thread, read by the watchdog
+    static std::atomic<const char*> s_receiverClass;
+    static std::atomic<int> s_eventType;
+    static std::atomic<const char*> s_scopes[MAX_SCOPE_DEPTH];
+    static std::atomic<int> s_scopeDepth;
+
+    std::thread m_watchdog;
+    std::atomic<bool> m_running;
+    std::atomic<qint64> m_outstandingSentNs;  // 0 = no heartbeat in flight
+    std::atomic<qint64> m_lastLagNs;
+
+    mutable QMutex m_mutex;
+    QHash<QString, Offender> m_offenders;
+};
+
+// Records the label of the running handler for stall attribution
+class StallScope
+{
+public:
+    explicit StallScope(const char* label) { EventLoopMonitor::enterScope(label); }
+    ~StallScope() { EventLoopMonitor::leaveScope(); }
+
+    StallScope(const StallScope&) = delete;
+    StallScope& operator=(const StallScope&) = delete;
+};
+
+#define STALL_CONCAT_INNER(a, b) a##b
+#define STALL_CONCAT(a, b) STALL_CONCAT_INNER(a, b)
+#define STALL_SCOPE(label) StallScope STALL_CONCAT(stallScope_, __LINE__)(label)
+
+// QApplication whose notify() records the receiver and event type being
+// dispatched, so stalls outside any STALL_SCOPE are still attributed
+class MonitoredApplication : public QApplication
+{
+    Q_OBJECT
+
+public:
+    MonitoredApplication(int& argc, char** argv);
+
+    bool notify(QObject* receiver, QEvent* event) override;
+};
+
+#endif // EVENTLOOPMONITOR_H
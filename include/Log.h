@@ -0,0 +1,87 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <QDebug>
+#include <QString>
+#include <QtGlobal>
+
+// Structured, asynchronous logging.
+//
+//     LOG_DEBUG("layout") << "moved" << movedTiles << "tiles";
+//
+// A call below BSS_LOG_MIN_LEVEL compiles to nothing; a call below the
+// category's runtime level costs one lookup and evaluates none of its
+// arguments. Enabled records are pushed into a lock-free ring owned by the
+// calling thread and written by a background thread, as JSON lines, to a
+// rotating file; the calling thread never waits for I/O. When a ring is full
+// the record is dropped and counted instead of blocking.
+//
+// Runtime levels come from BSS_LOG, e.g. "info,layout=debug,db=warning" (the
+// bare level is the default for all other categories). Existing qDebug() and
+// qWarning() output is routed through the same pipeline.
+class Log
+{
+public:
+    enum Level { Trace = 0, Debug, Info, Warning, Error };
+
+    static void install();   // Configure from the environment, start the writer, take over Qt messages
+    static void shutdown();  // Drain everything and stop the writer
+
+    static bool isEnabled(Level level, const char* category);
+    static void setDefaultLevel(Level level);
+    static void setCategoryLevel(const QByteArray& category, Level level);
+    static void submit(Level level, const char* category, QString&& message);
+
+    static QString filePath();
+    static quint64 droppedCount();
+};
+
+// Collects one record through a QDebug stream and submits it when destroyed
+class LogRecord
+{
+public:
+    LogRecord(Log::Level level, const char* category)
+        : m_level(level), m_category(category), m_stream(new QDebug(&m_message))
+    {
+        m_stream->noquote();
+    }
+
+    ~LogRecord()
+    {
+        // The stream finishes the text (trailing space) when it is destroyed
+        delete m_stream;
+        Log::submit(m_level, m_category, std::move(m_message));
+    }
+
+    LogRecord(const LogRecord&) = delete;
+    LogRecord& operator=(const LogRecord&) = delete;
+
+    QDebug& stream() { return *m_stream; }
+
+private:
+    Log::Level m_level;
+    const char* m_category;
+    QString m_message;
+    QDebug* m_stream;
+};
+
+// Compile-time floor: release builds drop trace and debug records entirely
+#ifndef BSS_LOG_MIN_LEVEL
+#ifdef NDEBUG
+#define BSS_LOG_MIN_LEVEL 2
+#else
+#define BSS_LOG_MIN_LEVEL 0
+#endif
+#endif
+
+#define BSS_LOG_AT(level, category) \
+    if (static_cast<int>(level) < BSS_LOG_MIN_LEVEL || !Log::isEnabled(level, category)) {} \
+    else LogRecord(level, category).stream()
+
+#define LOG_TRACE(category)   BSS_LOG_AT(Log::Trace, category)
+#define LOG_DEBUG(category)   BSS_LOG_AT(Log::Debug, category)
+#define LOG_INFO(category)    BSS_LOG_AT(Log::Info, category)
+#define LOG_WARNING(category) BSS_LOG_AT(Log::Warning, category)
+#define LOG_ERROR(category)   BSS_LOG_AT(Log::Error, category)
+
+#endif // LOG_H
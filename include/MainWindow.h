@@ -35,18 +35,27 @@ public:
     explicit MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
 
+    // Operator actions without their dialogs (bench/ScenarioRunner drives these too)
+    WindowManager* windowManager() const;
+    SubWindowManager* subWindowManager();  // Created on first use, connected to the wall
+    void applyWindowColumns(int columns);
+    void showFullscreenWindow(BrowserWidget* widget);
+    void hideFullscreenWindow();
+    void completeLogin(const QString& username);
+    void logout();  // onLogout() after the confirmation
+
 public slots:
-    void onAllWidgetsCreated();
+    void onRefreshAll();
 
 protected:
     void closeEvent(QCloseEvent *event) override;
     void keyPressEvent(QKeyEvent *event) override;
     void showEvent(QShowEvent *event) override;
+    bool eventFilter(QObject *watched, QEvent *event) override;
 
 private slots:
     // Menu actions
     void onExit();
-    void onRefreshAll();
     void onSubWindowManager();
     void onSettings();
     void onAbout();
@@ -57,13 +66,12 @@ private slots:
     
     // Window management
     void onFullscreenRequested(BrowserWidget* widget);
+    void onPromotionChanged(BrowserWidget* widget);
     void onWindowCloseRequested();
     
     // SubWindow management
-    void onSubWindowAdded(const QJsonObject& subWindow);
     void onNewSubWindowRefresh(int subId);
-    void onSubWindowUpdated(const QJsonObject& subWindow);
-    void onSubWindowDeleted(int subWindowId);
+    void onSubWindowsChanged(const SubWindowChangeResult& changes);
     
     // Status updates
     void updateStatusBar();
@@ -85,15 +93,16 @@ private:
     void handleLogout();
     void saveSettings();
     void loadSettings();
-    void showFullscreenWindow(BrowserWidget* widget);
-    void hideFullscreenWindow();
+    void logFullscreenToggle(const char* direction, qint64 elapsedNs);
     void showLogoutPage();
     void showMainInterface();
     void loadSubWindowsToLayout();
-    void applyWindowCount(int windowCount);
-    void applyWindowColumns(int columns);
-    int calculateRequiredWindowWidth(int columns);
-    void centerWindowOnScreen();
+    
+    // Startup stages (see StartupPipeline); each runs once per process
+    void runStartupPipeline();
+    bool loadSubWindowRegistry(QList<QJsonObject>& subWindows);
+    void applyPoolSizing(int windowCount);
+    void scheduleNavigations(const QList<QJsonObject>& subWindows);
     
     // UI Components
     QMenuBar* m_menuBar;
@@ -106,19 +115,18 @@ private:
     QStackedWidget* m_stackedWidget;
     QWidget* m_mainWidget;
     QWidget* m_logoutWidget;
-    QWidget* m_fullscreenWidget;
     QLabel* m_emptyStateLabel;
     QPushButton* m_logoutLoginButton;
     
     // Window management
     WindowManager* m_windowManager;
     BrowserWidget* m_fullscreenBrowser;
-    int m_fullscreenWidgetPosition;
     
     // Menu actions
     QAction* m_logoutAction;
     QAction* m_exitAction;
     QAction* m_refreshAllAction;
+    QAction* m_thumbnailModeAction;
     QAction* m_subWindowManagerAction;
     QAction* m_settingsAction;
     QAction* m_aboutAction;
@@ -126,6 +134,7 @@ private:
     
     // 布局现在由子窗口数据自动决定
     QLabel* m_statusLabel;
+    QLabel* m_resourceLabel;
     QProgressBar* m_globalProgressBar;
     
     // Login dialog
@@ -0,0 +1,98 @@
+#ifndef METRICSREGISTRY_H
+#define METRICSREGISTRY_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QMutex>
+#include <QVector>
+#include <QString>
+#include <functional>
+
+// Process-wide counters, gauges and histograms, rendered in OpenMetrics text
+// format. Families are declared once (defineX); samples are keyed by a
+// pre-rendered label set such as sub_window="3". Safe to update from any thread.
+class MetricsRegistry
+{
+public:
+    using Collector = std::function<void(MetricsRegistry&)>;
+
+    static MetricsRegistry* getInstance();
+
+    void defineCounter(const QString& name, const QString& help);
+    void defineGauge(const QString& name, const QString& help);
+    void defineHistogram(const QString& name, const QString& help, const QList<double>& buckets);
+
+    void increment(const QString& name, const QString& labels = QString(), double amount = 1.0);
+    void setGauge(const QString& name, const QString& labels, double value);
+    void clearGauge(const QString& name);  // Drop all label sets, e.g. before a collector refills them
+    void observe(const QString& name, const QString& labels, double value);
+
+    // Collectors run right before each exposition to refresh pulled gauges
+    int addCollector(const Collector& collector);
+    void removeCollector(int id);
+
+    QByteArray exposition();
+
+    static QString label(const QString& key, const QString& value);
+    static QString label(const QString& key, int value);
+    static QList<double> latencyBuckets();  // 1 ms .. 30 s, in seconds
+
+private:
+    MetricsRegistry();
+
+    enum class Type { Counter, Gauge, Histogram };
+
+    struct HistogramSample
+    {
+        QVector<quint64> bucketCounts;  // Per bucket, non-cumulative
+        quint64 count = 0;
+        double sum = 0.0;
+    };
+
+    struct Family
+    {
+        Type type = Type::Counter;
+        QString help;
+        QList<double> buckets;                     // Histograms only, ascending upper bounds
+        QMap<QString, double> values;              // Counters and gauges, by label set
+        QMap<QString, HistogramSample> histograms; // By label set
+    };
+
+    static MetricsRegistry* instance;
+    static QString escapeLabelValue(const QString& value);
+
+    QMutex m_mutex;
+    QMap<QString, Family> m_families;  // Sorted by name for stable output
+    QHash<int, Collector> m_collectors;
+    int m_nextCollectorId;
+};
+
+// Observes the lifetime of the enclosing scope, in seconds, into a histogram
+class ScopedLatency
+{
+public:
+    ScopedLatency(const char* histogram, const QString& labels = QString())
+        : m_histogram(histogram), m_labels(labels)
+    {
+        m_timer.start();
+    }
+
+    ~ScopedLatency()
+    {
+        MetricsRegistry::getInstance()->observe(QString::fromLatin1(m_histogram), m_labels,
+                                                m_timer.nsecsElapsed() / 1e9);
+    }
+
+    ScopedLatency(const ScopedLatency&) = delete;
+    ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+private:
+    const char* m_histogram;
+    QString m_labels;
+    QElapsedTimer m_timer;
+};
+
+#endif // METRICSREGISTRY_H
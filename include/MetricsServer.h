@@ -0,0 +1,46 @@
+#ifndef METRICSSERVER_H
+#define METRICSSERVER_H
+
+#include <QObject>
+#include <QHash>
+#include <QByteArray>
+#include <QTcpServer>
+
+class QTcpSocket;
+
+// Minimal HTTP endpoint serving MetricsRegistry::exposition() at /metrics.
+// Off unless a port is configured; binds to the loopback interface only.
+//
+//     BSS_METRICS_PORT=9464 ./BrowserSplitScreen
+//     curl http://127.0.0.1:9464/metrics
+class MetricsServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MetricsServer(QObject* parent = nullptr);
+    ~MetricsServer();
+
+    // Port from BSS_METRICS_PORT, else the "metricsPort" app setting; 0 = disabled
+    static quint16 configuredPort();
+
+    bool start(quint16 port);
+    void stop();
+    bool isListening() const;
+    quint16 port() const;
+
+private slots:
+    void onNewConnection();
+    void onReadyRead();
+
+private:
+    void respond(QTcpSocket* socket, const QByteArray& status, const QByteArray& contentType,
+                 const QByteArray& body);
+
+    QTcpServer* m_server;
+    QHash<QTcpSocket*, QByteArray> m_requests;  // Partial request headers per connection
+
+    static const int MAX_REQUEST_BYTES;
+};
+
+#endif // METRICSSERVER_H
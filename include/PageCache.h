@@ -0,0 +1,51 @@
+#ifndef PAGECACHE_H
+#define PAGECACHE_H
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QString>
+#include <QWebEnginePage>
+#include <QWebEngineProfile>
+
+// Live QWebEnginePages keyed by sub-window ID. A page (and its profile) stays with its
+// sub-window for its whole lifetime, so reassigning sub-windows to tiles moves pages
+// between views instead of reloading them. Least recently used pages that are not
+// shown in a visible view are dropped once the cache is over capacity.
+class PageCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PageCache(int capacity = 24, QObject* parent = nullptr);
+    ~PageCache();
+
+    QWebEnginePage* acquire(int subId);   // Cached page, or a new one; marks it most recently used
+    QWebEnginePage* find(int subId) const;
+    void release(int subId);              // Drop the page, e.g. when the sub-window is deleted
+    void retainOnly(const QSet<int>& subIds);
+    void setCapacity(int capacity);
+    int capacity() const;
+    int size() const;
+
+    static QString requestedUrl(const QWebEnginePage* page);
+    static void setRequestedUrl(QWebEnginePage* page, const QString& url);
+
+private:
+    QWebEnginePage* createPage(int subId);
+    void applySettings(QWebEngineSettings* settings);
+    void evict();
+
+    struct Entry
+    {
+        QWebEngineProfile* profile = nullptr;
+        QWebEnginePage* page = nullptr;
+    };
+
+    QHash<int, Entry> m_entries;
+    QList<int> m_lru;  // Front = most recently used
+    int m_capacity;
+};
+
+#endif // PAGECACHE_H
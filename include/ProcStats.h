@@ -0,0 +1,36 @@
+#ifndef PROCSTATS_H
+#define PROCSTATS_H
+
+#include <QtGlobal>
+#include <QList>
+#include <QString>
+
+// One reading of a process from /proc. CPU time is cumulative; a CPU percentage
+// needs two readings (see ProcStats::cpuPercent).
+struct ProcessSample
+{
+    qint64 pid = 0;
+    qint64 parentPid = 0;
+    bool valid = false;
+    quint64 cpuTicks = 0;    // utime + stime, in clock ticks
+    qint64 rssBytes = 0;
+    int threadCount = 0;
+    qint64 sampledAtNs = 0;  // Monotonic time of the reading
+};
+
+// Reads per-process resource usage from /proc. Returns invalid samples on
+// platforms without /proc or for processes that have exited.
+class ProcStats
+{
+public:
+    static ProcessSample read(qint64 pid);
+    static qint64 readPss(qint64 pid);               // From smaps_rollup; -1 if unavailable
+    static QString chromiumProcessType(qint64 pid);  // "--type=" from the command line; empty = browser
+    static QList<qint64> descendants(qint64 pid);    // Scans /proc, so keep it off hot paths
+    static double cpuPercent(const ProcessSample& previous, const ProcessSample& current);
+    static qint64 ticksPerSecond();
+    static qint64 pageSize();
+    static qint64 monotonicNs();  // Clock used for ProcessSample::sampledAtNs
+};
+
+#endif // PROCSTATS_H
@@ -0,0 +1,67 @@
+#ifndef REFRESHQUEUE_H
+#define REFRESHQUEUE_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QTimer>
+
+class WindowManager;
+class BrowserWidget;
+
+// Refresh All as a prioritized queue instead of reloading every pool member at once.
+//
+// Only tiles on the wall with a sub-window are queued: the fullscreen tile first,
+// then tiles inside the visible part of the wall in wall order. At most
+// MAX_CONCURRENT_LOADS reload at a time; the next starts when one finishes (or
+// after LOAD_TIMEOUT_MS). Tiles scrolled out of view stay pending until
+// WindowManager reports them on screen again and are then refreshed too.
+//
+// progressChanged() reports the aggregate load progress over the tiles refreshed
+// in this run; finished() is emitted once nothing on screen is left to refresh.
+class RefreshQueue : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit RefreshQueue(WindowManager* windowManager, QObject* parent = nullptr);
+
+    void start();   // Queues the wall; a run in progress is restarted with fresh order
+    void cancel();
+    void pump();    // Starts queued tiles that are now on screen, up to the concurrency limit
+    bool isRunning() const;
+    int total() const;      // Tiles started or waiting on screen in this run
+    int completed() const;
+    int deferred() const;   // Waiting until scrolled into view
+
+    static const int MAX_CONCURRENT_LOADS;
+    static const int LOAD_TIMEOUT_MS;
+
+signals:
+    void progressChanged(int percent, int completed, int total);
+    void finished();
+
+private slots:
+    void onTileLoadProgress(int progress);
+    void onTileLoadFinished();
+    void onWatchdog();
+
+private:
+    void finishTile(int subId);
+    void updateProgress();
+    void connectTile(BrowserWidget* widget);
+    void disconnectTile(BrowserWidget* widget);
+
+    WindowManager* m_windowManager;
+    QList<int> m_pending;            // Sub-window IDs in priority order
+    QHash<int, int> m_inFlight;      // Sub-window ID -> load progress (0-100)
+    QHash<int, qint64> m_startedMs;  // Sub-window ID -> m_clock time its reload started
+    QElapsedTimer m_clock;
+    QTimer* m_watchdog;
+    int m_completed;
+    bool m_running;  // Until every queued tile, off-screen ones included, was refreshed
+    bool m_busy;     // Tiles loading or waiting on screen; finished() ends a busy period
+};
+
+#endif // REFRESHQUEUE_H
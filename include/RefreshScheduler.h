@@ -0,0 +1,85 @@
+#ifndef REFRESHSCHEDULER_H
+#define REFRESHSCHEDULER_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QPointer>
+#include <QString>
+#include <QTimer>
+
+class WindowManager;
+class QNetworkAccessManager;
+class QNetworkReply;
+
+// Automatic reloads for sub-windows with a refresh interval (sub_windows.refresh_interval).
+//
+// Reloads are spread out: each due time is jittered by JITTER_PERCENT, only one
+// sub-window is handled per timer tick, and consecutive reloads are at least
+// MIN_SPACING_MS apart. Sub-windows whose tile is hidden, unassigned or has the
+// keyboard focus are postponed instead of reloaded.
+//
+// Before reloading, a conditional GET of the tile's URL (If-None-Match /
+// If-Modified-Since, else a SHA-1 of the body) skips the reload when the document
+// did not change. Pages that fetch their data with scripts look unchanged to this
+// check, so every MAX_SKIPPED_CHECKS-th check reloads regardless. The check runs
+// without the tile's cookies and does not follow redirects; anything but 200 or
+// 304 (offline, redirect to a login page, 401/403, non-HTTP URLs) falls back to a
+// plain reload.
+class RefreshScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit RefreshScheduler(WindowManager* windowManager, QObject* parent = nullptr);
+
+    void setInterval(int subId, int seconds);  // 0 removes the sub-window
+    int interval(int subId) const;
+    void remove(int subId);
+    void clear();
+    QList<int> subWindowIds() const;
+
+    static const int MIN_INTERVAL_S;
+    static const int JITTER_PERCENT;
+    static const int MIN_SPACING_MS;
+    static const int CHECK_TIMEOUT_MS;
+    static const int MAX_SKIPPED_CHECKS;
+    static const int FOCUS_DEFER_MS;
+
+signals:
+    void checked(int subId, bool reloaded);
+
+private slots:
+    void onTimeout();
+    void onCheckFinished();
+
+private:
+    struct Entry
+    {
+        int intervalSeconds = 0;
+        qint64 dueMs = 0;         // m_clock time
+        int skippedChecks = 0;
+        QString checkedUrl;       // Validators below belong to this URL
+        QByteArray etag;
+        QByteArray lastModified;
+        QByteArray contentHash;
+    };
+
+    void arm();
+    void startCheck(int subId, const QString& url);
+    void complete(int subId, const QString& result, bool reloadTile);
+    qint64 jitteredIntervalMs(int seconds) const;
+
+    WindowManager* m_windowManager;
+    QNetworkAccessManager* m_network;
+    QTimer* m_timer;
+    QElapsedTimer m_clock;
+    QHash<int, Entry> m_entries;
+    QPointer<QNetworkReply> m_pendingCheck;  // One check in flight at a time
+    int m_pendingSubId;
+    qint64 m_lastReloadMs;
+};
+
+#endif // REFRESHSCHEDULER_H
@@ -0,0 +1,53 @@
+#ifndef REQUESTBLOCKER_H
+#define REQUESTBLOCKER_H
+
+#include <QWebEngineUrlRequestInterceptor>
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QHash>
+#include <QString>
+#include <QUrl>
+#include <atomic>
+#include "Blocklist.h"
+
+// Drops ad, tracker and heavy-asset subresource requests of the tile profiles.
+//
+// Every request except the page's own navigation is matched against the compiled
+// Blocklist (blocklist.bin next to the executable, or BSS_BLOCKLIST_PATH). Requests
+// to the page's own site (same registrable domain, so cdn.example.com for a page on
+// www.example.com) are never blocked, so a dashboard that happens to host its
+// assets under a listed path keeps working. BSS_BLOCKLIST=0 turns blocking off.
+//
+// PageCache installs the one instance on each sub-window profile.
+class RequestBlocker : public QWebEngineUrlRequestInterceptor
+{
+    Q_OBJECT
+
+public:
+    static RequestBlocker* getInstance();
+
+    void interceptRequest(QWebEngineUrlRequestInfo& info) override;
+
+    bool isEnabled() const;   // A valid list is loaded and blocking is not switched off
+    const Blocklist& blocklist() const;
+    quint64 blockedCount() const;
+
+    static QString defaultPath();
+    static QByteArrayView registrableDomain(QByteArrayView host);  // Approximate eTLD+1, a slice of host
+    static bool isSameSite(QByteArrayView host, QByteArrayView firstPartyHost);  // Lowercase hosts
+
+    static const int FIRST_PARTY_CACHE_SIZE;
+
+private:
+    explicit RequestBlocker(QObject* parent = nullptr);
+    QByteArray firstPartyDomain(const QUrl& firstPartyUrl);  // Cached per page URL
+
+    static RequestBlocker* instance;
+
+    Blocklist m_blocklist;
+    bool m_enabled;
+    std::atomic<quint64> m_blocked;
+    QHash<QUrl, QByteArray> m_firstPartyDomains;  // UI thread only, like interceptRequest()
+};
+
+#endif // REQUESTBLOCKER_H
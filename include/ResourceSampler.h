@@ -0,0 +1,115 @@
+#ifndef RESOURCESAMPLER_H
+#define RESOURCESAMPLER_H
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QTimer>
+#include <QVector>
+#include "ProcStats.h"
+
+class WindowManager;
+
+// Resource usage attributed to one sub-window at one point in time. Tiles that
+// share a renderer process split its CPU time and memory evenly.
+struct ResourceReading
+{
+    qint64 timestampNs = 0;   // ProcStats::monotonicNs()
+    qint64 rendererPid = 0;
+    double cpuPercent = -1.0; // Percent of one core; -1 until two samples exist
+    qint64 rssBytes = -1;
+    qint64 pssBytes = -1;     // Refreshed every PSS_EVERY passes, carried over in between
+    int threadCount = 0;
+};
+
+// A non-tile process of the WebEngine process tree
+struct ProcessUsage
+{
+    qint64 pid = 0;
+    QString role;             // "browser", "gpu-process", "utility", "zygote", ...
+    double cpuPercent = -1.0;
+    qint64 rssBytes = -1;
+    qint64 pssBytes = -1;
+    int threadCount = 0;
+};
+
+// Totals over the whole wall, each process counted once
+struct ResourceTotals
+{
+    int rendererCount = 0;
+    double rendererCpuPercent = 0.0;
+    qint64 rendererRssBytes = 0;
+    double auxiliaryCpuPercent = 0.0;   // Browser, GPU and utility processes
+    qint64 auxiliaryRssBytes = 0;
+    int busiestSubId = -1;
+    double busiestCpuPercent = -1.0;
+};
+
+// The single source of per-tile resource data. Periodically reads /proc for
+// every tile's renderer and for the browser, GPU and utility processes, and
+// keeps a fixed-size time series per sub-window.
+//
+// Cost is bounded: one stat read per process per pass, smaps_rollup only every
+// PSS_EVERY passes, the /proc scan for auxiliary processes only every
+// DISCOVERY_EVERY passes, and the interval stretches so a pass never takes more
+// than COST_BUDGET_PERCENT of the interval.
+class ResourceSampler : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ResourceSampler(WindowManager* windowManager, QObject* parent = nullptr);
+
+    void start();
+    void stop();
+    bool isRunning() const;
+
+    bool hasReading(int subId) const;
+    ResourceReading latest(int subId) const;
+    QList<ResourceReading> history(int subId) const;  // Oldest first
+    QList<ProcessUsage> auxiliaryProcesses() const;
+    ResourceTotals totals() const;
+
+    int intervalMs() const;
+    qint64 lastPassCostNs() const;
+
+    static const int HISTORY_SIZE;
+    static const int MIN_INTERVAL_MS;
+    static const int MAX_INTERVAL_MS;
+    static const int COST_BUDGET_PERCENT;
+    static const int PSS_EVERY;
+    static const int DISCOVERY_EVERY;
+
+public slots:
+    void samplePass();
+
+signals:
+    void sampled();
+
+private:
+    // Fixed-capacity ring of readings
+    struct TileSeries
+    {
+        QVector<ResourceReading> readings;
+        int next = 0;
+        int count = 0;
+    };
+
+    void appendReading(int subId, const ResourceReading& reading);
+    void sampleAuxiliaryProcesses(bool refreshPss, QHash<qint64, ProcessSample>& currentSamples);
+    void adaptInterval();
+
+    WindowManager* m_windowManager;
+    QTimer* m_timer;
+    QHash<int, TileSeries> m_series;
+    QHash<qint64, ProcessSample> m_previousSamples;  // Per PID, for CPU deltas
+    QHash<qint64, int> m_rendererShares;             // Renderer PID -> number of tiles it serves
+    QHash<qint64, qint64> m_pssCache;                // Per PID, between PSS refreshes
+    QList<qint64> m_auxiliaryPids;
+    QList<ProcessUsage> m_auxiliary;
+    quint64 m_passCount;
+    qint64 m_lastPassCostNs;
+};
+
+#endif // RESOURCESAMPLER_H
@@ -0,0 +1,65 @@
+#ifndef STARTUPPIPELINE_H
+#define STARTUPPIPELINE_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QString>
+#include <functional>
+
+// Staged application start-up. Every stage runs at most once per process, whichever
+// code path reaches it first; later requests for a finished stage are no-ops. The
+// duration and completion offset of each stage are recorded for the start-up budget.
+class StartupPipeline : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Stage {
+        DatabaseOpen = 0,
+        Settings,
+        SessionCheck,
+        RegistryLoad,
+        PoolSizing,
+        NavigationScheduling,
+        FirstPaint,
+        StageCount
+    };
+    Q_ENUM(Stage)
+
+    static StartupPipeline* getInstance();
+    static QString stageName(Stage stage);
+
+    // Runs work() unless the stage already ran; returns the stage's (first) result
+    bool runStage(Stage stage, const std::function<bool()>& work);
+    // Records an externally observed stage (e.g. first paint) as of now
+    void markStage(Stage stage);
+
+    bool isDone(Stage stage) const;
+    bool isComplete() const;
+    qint64 stageTimeNs(Stage stage) const;    // Duration of the stage itself
+    qint64 stageOffsetNs(Stage stage) const;  // Completion time since process start-up
+    qint64 totalTimeNs() const;
+    QString summary() const;
+
+    static const qint64 STARTUP_BUDGET_MS;
+
+signals:
+    void stageCompleted(StartupPipeline::Stage stage, qint64 elapsedNs);
+    void completed(qint64 totalNs);
+
+private:
+    explicit StartupPipeline(QObject* parent = nullptr);
+    static const char* stageLabel(Stage stage);
+    void finishStage(Stage stage, qint64 elapsedNs, bool result);
+
+    static StartupPipeline* instance;
+
+    QElapsedTimer m_clock;  // Started when the pipeline is first used, at the top of main()
+    bool m_done[StageCount];
+    bool m_results[StageCount];
+    qint64 m_durationNs[StageCount];
+    qint64 m_offsetNs[StageCount];
+    qint64 m_lastCompletionNs;
+};
+
+#endif // STARTUPPIPELINE_H
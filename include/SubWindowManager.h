@@ -12,9 +12,11 @@
 #include <QLineEdit>
 #include <QLabel>
 #include <QComboBox>
+#include <QSpinBox>
 #include <QFormLayout>
 #include <QDialogButtonBox>
 #include <QJsonObject>
+#include "DatabaseManager.h"
 
 class SubWindowManager : public QDialog
 {
@@ -27,18 +29,21 @@ public:
     void refreshSubWindows();
     QList<QJsonObject> getSubWindows() const;
 
+    // Commits a batch of edits in one transaction and announces it with one signal
+    bool applyChanges(const SubWindowChangeSet& changes);
+
 signals:
-    void subWindowAdded(const QJsonObject& subWindow);
     void subWindowRefreshRequested(int subId);
-    void subWindowUpdated(const QJsonObject& subWindow);
-    void subWindowDeleted(int subWindowId);
+    void subWindowsChanged(const SubWindowChangeResult& result);
 
 private slots:
     void onAddSubWindow();
+    void onImportSubWindows();
     void onDeleteSubWindow();
     void onSubWindowSelectionChanged();
     void onCheckboxChanged(QTableWidgetItem* item);
     void onUrlChanged(QTableWidgetItem* item);
+    void onIntervalChanged(QTableWidgetItem* item);
 
 private:
     void setupUI();
@@ -47,12 +52,15 @@ private:
     void addSubWindowToTable(const QJsonObject& subWindow);
     void updateSubWindowInTable(int row, const QJsonObject& subWindow);
     bool validateSubWindowData(const QString& name, const QString& url);
+    QList<QJsonObject> parseImportFile(const QString& filePath);
+    static bool isImportableUrl(const QString& url);  // http(s) with a host, or file
     QJsonObject getSubWindowFromTable(int row);
 
     // UI Components
     QTableWidget* m_tableWidget;
     QPushButton* m_addButton;
     QPushButton* m_deleteButton;
+    QPushButton* m_importButton;
     QPushButton* m_refreshButton;
     QDialogButtonBox* m_buttonBox;
 
@@ -72,6 +80,12 @@ public:
     QJsonObject getSubWindowData() const;
     void setSubWindowData(const QJsonObject& subWindow);
 
+    // Accepted ranges for the per-sub-window intervals, in seconds; auto-refresh is 0 = off
+    // or RefreshScheduler::MIN_INTERVAL_S up to MAX_REFRESH_INTERVAL
+    static const int MIN_THUMBNAIL_INTERVAL;
+    static const int MAX_THUMBNAIL_INTERVAL;
+    static const int MAX_REFRESH_INTERVAL;
+
 private slots:
     void onUrlChanged();
     void validateInput();
@@ -85,6 +99,8 @@ private:
     QLineEdit* m_nameEdit;
     QLineEdit* m_urlEdit;
     QLabel* m_urlStatusLabel;
+    QSpinBox* m_thumbnailIntervalSpin;
+    QSpinBox* m_refreshIntervalSpin;
     QDialogButtonBox* m_buttonBox;
 
     // Data
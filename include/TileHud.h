@@ -0,0 +1,41 @@
+#ifndef TILEHUD_H
+#define TILEHUD_H
+
+#include <QLabel>
+#include <QString>
+
+enum class TileLifecycle { NoPage, Active, Frozen, Discarded };
+
+// Live numbers for one tile, as shown in its HUD and summed in the status bar
+struct TileMetrics
+{
+    int windowId = 0;
+    int subWindowId = -1;
+    qint64 navigationMs = -1;   // Last navigation, load start to load finished
+    qint64 firstPaintMs = -1;   // Last navigation, load start to first rendered frame
+    qint64 rendererPid = 0;
+    qint64 rssBytes = -1;       // Share of the renderer when tiles share one
+    qint64 pssBytes = -1;
+    int threadCount = 0;
+    double cpuPercent = -1.0;   // Percent of one core since the previous sample
+    TileLifecycle lifecycle = TileLifecycle::NoPage;
+    QString lifecycleState;     // Display name of lifecycle
+    int reloadCount = 0;
+};
+
+// Small translucent metrics panel drawn over the top-left corner of a tile (the
+// fullscreen button owns the top-right). Ignores the mouse so the page stays usable.
+class TileHud : public QLabel
+{
+    Q_OBJECT
+
+public:
+    explicit TileHud(QWidget* parent = nullptr);
+
+    void setMetrics(const TileMetrics& metrics);
+    void reposition();  // Keep the panel in the parent's top-left corner
+
+    static QString formatBytes(qint64 bytes);
+};
+
+#endif // TILEHUD_H
@@ -0,0 +1,97 @@
+#ifndef TILELAYOUT_H
+#define TILELAYOUT_H
+
+#include <QLayout>
+#include <QList>
+#include <QHash>
+#include <QRect>
+#include <QString>
+#include <QStringList>
+
+// Placement of one tile in the grid, in cell units
+struct TileCell
+{
+    int row = 0;
+    int column = 0;
+    int rowSpan = 1;
+    int columnSpan = 1;
+
+    bool operator==(const TileCell& other) const
+    {
+        return row == other.row && column == other.column &&
+               rowSpan == other.rowSpan && columnSpan == other.columnSpan;
+    }
+};
+
+// Declarative description of a tile wall
+struct TileLayoutSpec
+{
+    int rows = 0;                     // 0 = as many rows as the tile count needs
+    int columns = 2;
+    QList<TileCell> cells;            // Explicit placements in item order; the rest auto-flow
+    int horizontalGap = 5;
+    int verticalGap = 5;
+    double aspectRatio = 5.0 / 3.0;   // Cell width / height; <= 0 fills the available height
+    int cellWidth = 0;                // Fixed cell width; 0 = derive from the available width
+    int minimumCellWidth = 0;         // Lower bound for derived cell widths, in logical pixels
+    qreal devicePixelRatio = 1.0;     // Cell sizes are snapped to whole device pixels
+
+    static TileLayoutSpec grid(int columns, int rows = 0);
+    static TileLayoutSpec featured(int smallTiles);      // One 2x2 tile followed by small tiles
+    static TileLayoutSpec fromPreset(const QString& preset);  // "3x4", "4x4", "1+5", ...
+    static QStringList presetNames();
+
+    QList<TileCell> placements(int itemCount) const;
+    int rowsFor(int itemCount) const;
+    bool operator==(const TileLayoutSpec& other) const;
+    bool operator!=(const TileLayoutSpec& other) const { return !(*this == other); }
+};
+
+// Places tiles directly from a TileLayoutSpec in one O(n) pass, without any
+// intermediate row containers. Only items whose rectangle changed are touched.
+class TileLayout : public QLayout
+{
+    Q_OBJECT
+
+public:
+    explicit TileLayout(QWidget* parent = nullptr);
+    ~TileLayout();
+
+    void setSpec(const TileLayoutSpec& spec);
+    const TileLayoutSpec& spec() const;
+
+    // Replace the item list with the given widgets, reusing existing items
+    void setWidgets(const QList<QWidget*>& widgets);
+    void insertWidget(int index, QWidget* widget);
+
+    // Overlay one tile on top of the wall at the given rectangle; the other tiles keep
+    // their geometry. Pass nullptr to put the tile back into its cell.
+    void setPromotedWidget(QWidget* widget, const QRect& rect = QRect());
+    QWidget* promotedWidget() const;
+
+    QList<QRect> computeGeometries(const QRect& rect) const;
+    QSize cellSize(const QRect& rect) const;
+
+    // QLayout interface
+    void addItem(QLayoutItem* item) override;
+    int count() const override;
+    QLayoutItem* itemAt(int index) const override;
+    QLayoutItem* takeAt(int index) override;
+    QSize sizeHint() const override;
+    QSize minimumSize() const override;
+    Qt::Orientations expandingDirections() const override;
+    bool hasHeightForWidth() const override;
+    int heightForWidth(int width) const override;
+    void setGeometry(const QRect& rect) override;
+
+private:
+    QSize contentSize(int width) const;
+    int snapToDevicePixels(int logical) const;
+
+    QList<QLayoutItem*> m_items;
+    TileLayoutSpec m_spec;
+    QWidget* m_promotedWidget = nullptr;
+    QRect m_promotedRect;
+};
+
+#endif // TILELAYOUT_H
@@ -0,0 +1,100 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <QString>
+#include <QtGlobal>
+#include <atomic>
+#include <memory>
+
+// One completed span. Names and categories must be string literals (or otherwise
+// outlive the tracer); the optional argument distinguishes e.g. tiles.
+struct TraceEvent
+{
+    const char* name = nullptr;
+    const char* category = nullptr;
+    qint64 startNs = 0;      // Since Tracer::epoch
+    qint64 durationNs = 0;   // 0 = instant event
+    int threadId = 0;
+    int arg = -1;            // -1 = no argument
+};
+
+// Process-wide span tracer. Recording is a wait-free slot claim in a fixed-size
+// ring buffer, so it can be called from any thread; the oldest spans are
+// overwritten once the buffer is full. The buffer can be written out as a
+// Chrome trace-event JSON file (chrome://tracing, Perfetto).
+class Tracer
+{
+public:
+    static Tracer* getInstance();
+
+    // Nanoseconds since the tracer was created (at the top of main())
+    qint64 now() const;
+
+    void record(const char* name, const char* category, qint64 startNs, qint64 durationNs, int arg = -1);
+    void instant(const char* name, const char* category, int arg = -1);
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+
+    // Reads BSS_TRACE (0 disables recording), BSS_TRACE_FILE and --trace=<path>
+    void configure(const QStringList& arguments);
+    QString exitDumpPath() const;
+    QString defaultDumpPath() const;
+
+    bool writeChromeTrace(const QString& path) const;
+
+    static const int CAPACITY;
+
+private:
+    Tracer();
+    static int currentThreadId();
+
+    struct Slot
+    {
+        std::atomic<quint64> sequence{0};  // Claim index + 1 once the event is fully written
+        TraceEvent event;
+    };
+
+    static Tracer* instance;
+
+    std::unique_ptr<Slot[]> m_slots;
+    std::atomic<quint64> m_writeIndex{0};
+    std::atomic<bool> m_enabled{true};
+    qint64 m_epochNs;
+    QString m_exitDumpPath;
+};
+
+// Records the enclosing scope as one span
+class TraceScope
+{
+public:
+    TraceScope(const char* name, const char* category, int arg = -1)
+        : m_name(name), m_category(category), m_arg(arg)
+        , m_startNs(Tracer::getInstance()->isEnabled() ? Tracer::getInstance()->now() : -1)
+    {
+    }
+
+    ~TraceScope()
+    {
+        if (m_startNs >= 0) {
+            Tracer* tracer = Tracer::getInstance();
+            tracer->record(m_name, m_category, m_startNs, tracer->now() - m_startNs, m_arg);
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* m_name;
+    const char* m_category;
+    int m_arg;
+    qint64 m_startNs;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name, category) TraceScope TRACE_CONCAT(traceScope_, __LINE__)(name, category)
+#define TRACE_SCOPE_ARG(name, category, arg) TraceScope TRACE_CONCAT(traceScope_, __LINE__)(name, category, arg)
+
+#endif // TRACER_H
@@ -9,7 +9,17 @@
 #include <QList>
 #include <QJsonObject>
 #include <QTimer>
+#include <QEvent>
+#include <QSet>
+#include <QHash>
+#include <QSize>
 #include "BrowserWidget.h"
+#include "TileLayout.h"
+#include "PageCache.h"
+#include "ResourceSampler.h"
+#include "RefreshScheduler.h"
+#include "RefreshQueue.h"
+#include "MetricsRegistry.h"
 
 class WindowManager : public QObject
 {
@@ -33,57 +43,111 @@ public:
     void detachWidgetFromLayout(BrowserWidget* widget);
     void attachWidgetToLayout(BrowserWidget* widget, int position);
     void forceLayoutUpdate();
-    void synchronizeWidgetWidths();
-    void ensureConsistentWidths();
+    void promoteWidget(BrowserWidget* widget);  // Overlay one tile over the visible wall
+    void demoteWidget();
+    BrowserWidget* getPromotedWidget() const;
     void setColumnCount(int columns);
     int getColumnCount() const;
+    void setLayoutPreset(const QString& preset);
+    QString getLayoutPreset() const;
     void updateWidgetContent(int index, int subId, const QString& name, const QString& url);  // New: Update pooled widget content
+    void assignSubWindow(BrowserWidget* widget, int subId, const QString& name, const QString& url);
+    
+    // Incremental wall edits: each touches one widget and its layout slot
+    BrowserWidget* addTile(int subId, const QString& name, const QString& url);
+    bool removeTile(int subId);
+    bool retargetTile(int subId, const QString& name, const QString& url);
+    void applyChangeSet(const SubWindowChangeResult& changes);  // One layout pass for the whole batch
+    void releaseStalePages(const QSet<int>& liveSubIds);
+    PageCache* getPageCache() const;
     BrowserWidget* findWidgetBySubId(int subId) const;
+    qint64 lastLayoutTimeNs() const;
+    int layoutItemCount() const;     // Items in the tile layout
+    int contentWidgetCount() const;  // Direct child widgets of the scroll content
+    void setHudVisible(bool visible);  // Per-tile performance overlay on every tile
+    bool isHudVisible() const;
+    void setThumbnailMode(bool enabled);  // Snapshot wall; only the hovered/focused/fullscreen tile is live
+    bool isThumbnailMode() const;
+    ResourceSampler* getResourceSampler() const;
+    RefreshScheduler* getRefreshScheduler() const;
+    RefreshQueue* getRefreshQueue() const;
+    void stopRefreshing();           // Cancels Refresh All and unschedules auto-refresh, e.g. on logout
+    void loadSubWindowSettings();    // Per-sub-window intervals from the database
+    bool isTileOnScreen(BrowserWidget* widget) const;  // Fullscreen, or inside the visible part of the wall
 
     // Layout configurations
     static const QList<int> SUPPORTED_WINDOW_COUNTS;
+    static const int MIN_COLUMNS;
+    static const int MAX_COLUMNS;    // Also bounds the column choice in the settings dialog
     static QPair<int, int> getGridDimensions(int windowCount);
     static bool isValidWindowCount(int windowCount);
 
+protected:
+    bool eventFilter(QObject* watched, QEvent* event) override;
+
 signals:
-    void allWidgetsCreated();  // FIXED: Signal emitted when all delayed widgets are created and ready
     void layoutChanged(int windowCount);
     void widgetAdded(BrowserWidget* widget);
     void widgetRemoved(int index);
     void fullscreenRequested(BrowserWidget* widget);
+    void layoutUpdated(int movedTiles, qint64 elapsedNs);
+    void promotionChanged(BrowserWidget* widget);  // widget is null when demoted
 
 private slots:
     void onWidgetFullscreenRequested();
     void onWidgetCloseRequested();
     void onAutoSave();
     void onParentWidgetResized();
+    void onZoomUpdateRequested();
+    void onZoomFrame();
+    void updateScreenMetrics();
+    void onResourcesSampled();
 
 private:
     void setupLayout();
     void updateLayout();
+    TileLayoutSpec currentSpec() const;
     // void createBrowserWidgets();  // Commented out: No longer needed with pool
     void destroyBrowserWidgets();
     void connectWidgetSignals(BrowserWidget* widget);
     void disconnectWidgetSignals(BrowserWidget* widget);
-    int calculateDynamicWidth() const;
+    void resizeScrollContent();
+    void scheduleZoomUpdate(BrowserWidget* widget);
+    BrowserWidget* placeTile(int subId, const QString& name, const QString& url);
+    bool takeTile(int subId);
+    QRect overlayRect() const;
+    void updatePromotedGeometry();
+    void collectMetrics(MetricsRegistry& registry) const;
 
     QWidget* m_parentWidget;
     QGridLayout* m_gridLayout;
     QScrollArea* m_scrollArea;
     QWidget* m_scrollContent;
-    QVBoxLayout* m_verticalLayout;
+    TileLayout* m_tileLayout;
+    qint64 m_lastLayoutTimeNs;
     QList<BrowserWidget*> m_browserWidgets;
     int m_currentWindowCount;
     int m_columnCount;
+    QString m_layoutPreset;  // Empty = plain grid of m_columnCount columns
     QTimer* m_autoSaveTimer;
-    QTimer* m_widthSyncTimer;
-    
-    // Fixed widget dimensions
-    static const int FIXED_WIDGET_WIDTH;
-    static const int FIXED_WIDGET_HEIGHT;
+    QTimer* m_resizeDebounceTimer;  // Coalesces viewport resizes into one reflow
+    QTimer* m_zoomFrameTimer;       // One zoom pass per frame for all tiles that changed
+    QSet<BrowserWidget*> m_pendingZoomTiles;
+    QSize m_screenSize;             // Cached primary screen size, refreshed on screen changes
+    BrowserWidget* m_promotedWidget;
+    PageCache* m_pageCache;
+    bool m_hudVisible;
+    bool m_thumbnailMode;
+    QHash<int, int> m_thumbnailIntervals;  // sub-window ID -> seconds between snapshots
+    RefreshScheduler* m_refreshScheduler;
+    RefreshQueue* m_refreshQueue;
+    ResourceSampler* m_resourceSampler;
+    int m_metricsCollectorId;
     
-    // Calculate height based on 5:3 aspect ratio
-    int calculateHeightFromWidth(int width) const;
+    // Smallest tile width in logical pixels before the wall starts scrolling horizontally
+    static const int MINIMUM_TILE_WIDTH;
+    static const int RESIZE_DEBOUNCE_MS;
+    static const int ZOOM_FRAME_MS;
 };
 
 #endif // WINDOWMANAGER_H
@@ -0,0 +1,499 @@
+#include "Blocklist.h"
+#include "Log.h"
+#include <QHash>
+#include <QMap>
+#include <QPair>
+#include <QTextStream>
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+const quint32 Blocklist::FORMAT_VERSION = 1;
+
+static const char BLOCKLIST_MAGIC[4] = {'B', 'S', 'S', 'B'};
+static const quint32 NO_NODE = 0xffffffffu;
+
+enum PathRuleKind : quint32 {
+    SegmentRule = 1,
+    ExtensionRule = 2
+};
+
+// Everything in the image is little-endian and 4-byte aligned
+struct Blocklist::Header
+{
+    char magic[4];
+    quint32_le version;
+    quint32_le nodeCount;
+    quint32_le edgeCount;
+    quint32_le pathRuleCount;
+    quint32_le stringBytes;
+};
+
+struct Blocklist::Node
+{
+    quint32_le firstEdge;
+    quint32_le edgeCount;
+    quint32_le categories;  // Non-zero: a host rule ends here
+};
+
+struct Blocklist::Edge
+{
+    quint32_le hash;
+    quint32_le labelOffset;
+    quint32_le labelLength;
+    quint32_le child;
+};
+
+struct Blocklist::PathRule
+{
+    quint32_le hash;
+    quint32_le textOffset;
+    quint32_le textLength;
+    quint32_le kind;
+    quint32_le categories;
+};
+
+static inline char lowerAscii(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? char(c + ('a' - 'A')) : c;
+}
+
+// FNV-1a over the lowercased bytes
+static inline quint32 hashLower(QByteArrayView text)
+{
+    quint32 hash = 2166136261u;
+    for (char c : text) {
+        hash ^= quint8(lowerAscii(c));
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static inline bool equalsLower(QByteArrayView text, const char* lower, quint32 length)
+{
+    if (quint32(text.size()) != length) {
+        return false;
+    }
+    for (quint32 i = 0; i < length; ++i) {
+        if (lowerAscii(text[i]) != lower[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+Blocklist::Blocklist()
+    : m_map(nullptr)
+    , m_nodes(nullptr)
+    , m_edges(nullptr)
+    , m_pathRules(nullptr)
+    , m_strings(nullptr)
+    , m_nodeCount(0)
+    , m_edgeCount(0)
+    , m_pathRuleCount(0)
+    , m_hostRuleCount(0)
+{
+}
+
+Blocklist::~Blocklist()
+{
+    unload();
+}
+
+bool Blocklist::load(const QString& path)
+{
+    unload();
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        LOG_WARNING("blocklist") << "Blocklist: cannot open" << path << m_file.errorString();
+        return false;
+    }
+
+    const qint64 size = m_file.size();
+    m_map = size > 0 ? m_file.map(0, size) : nullptr;
+    if (!m_map || !attach(m_map, size)) {
+        LOG_WARNING("blocklist") << "Blocklist:" << path << "is not a valid version" << FORMAT_VERSION << "blocklist image";
+        unload();
+        return false;
+    }
+
+    LOG_INFO("blocklist") << "Blocklist: mapped" << path << "-" << m_hostRuleCount << "host rules,"
+                          << m_pathRuleCount << "path rules," << size << "bytes";
+    return true;
+}
+
+void Blocklist::unload()
+{
+    if (m_map) {
+        m_file.unmap(const_cast<uchar*>(m_map));
+    }
+    m_file.close();
+    m_map = nullptr;
+    m_nodes = nullptr;
+    m_edges = nullptr;
+    m_pathRules = nullptr;
+    m_strings = nullptr;
+    m_nodeCount = 0;
+    m_edgeCount = 0;
+    m_pathRuleCount = 0;
+    m_hostRuleCount = 0;
+}
+
+bool Blocklist::isLoaded() const
+{
+    return m_nodes != nullptr;
+}
+
+QString Blocklist::path() const
+{
+    return isLoaded() ? m_file.fileName() : QString();
+}
+
+int Blocklist::hostRuleCount() const
+{
+    return static_cast<int>(m_hostRuleCount);
+}
+
+int Blocklist::pathRuleCount() const
+{
+    return static_cast<int>(m_pathRuleCount);
+}
+
+bool Blocklist::attach(const uchar* data, qint64 size)
+{
+    // Bounds checks only, so a truncated or foreign file cannot be read past its end
+    if (size < qint64(sizeof(Header))) {
+        return false;
+    }
+    const Header* header = reinterpret_cast<const Header*>(data);
+    if (std::memcmp(header->magic, BLOCKLIST_MAGIC, sizeof(BLOCKLIST_MAGIC)) != 0 || header->version != FORMAT_VERSION) {
+        return false;
+    }
+
+    const quint64 nodeCount = header->nodeCount;
+    const quint64 edgeCount = header->edgeCount;
+    const quint64 pathRuleCount = header->pathRuleCount;
+    const quint64 stringBytes = header->stringBytes;
+    const quint64 expected = sizeof(Header) + nodeCount * sizeof(Node) + edgeCount * sizeof(Edge)
+        + pathRuleCount * sizeof(PathRule) + stringBytes;
+    if (nodeCount == 0 || expected != quint64(size)) {
+        return false;
+    }
+
+    const Node* nodes = reinterpret_cast<const Node*>(data + sizeof(Header));
+    const Edge* edges = reinterpret_cast<const Edge*>(nodes + nodeCount);
+    const PathRule* pathRules = reinterpret_cast<const PathRule*>(edges + edgeCount);
+    const char* strings = reinterpret_cast<const char*>(pathRules + pathRuleCount);
+
+    quint32 hostRules = 0;
+    for (quint64 i = 0; i < nodeCount; ++i) {
+        if (quint64(nodes[i].firstEdge) + nodes[i].edgeCount > edgeCount) {
+            return false;
+        }
+        if (nodes[i].categories != 0) {
+            ++hostRules;
+        }
+    }
+    for (quint64 i = 0; i < edgeCount; ++i) {
+        if (edges[i].child >= nodeCount || quint64(edges[i].labelOffset) + edges[i].labelLength > stringBytes) {
+            return false;
+        }
+    }
+    for (quint64 i = 0; i < pathRuleCount; ++i) {
+        if (quint64(pathRules[i].textOffset) + pathRules[i].textLength > stringBytes) {
+            return false;
+        }
+    }
+
+    m_nodes = nodes;
+    m_edges = edges;
+    m_pathRules = pathRules;
+    m_strings = strings;
+    m_nodeCount = quint32(nodeCount);
+    m_edgeCount = quint32(edgeCount);
+    m_pathRuleCount = quint32(pathRuleCount);
+    m_hostRuleCount = hostRules;
+    return true;
+}
+
+quint32 Blocklist::matchHost(QByteArrayView host) const
+{
+    if (!m_nodes) {
+        return 0;
+    }
+
+    qsizetype end = host.size();
+    if (end > 0 && host[end - 1] == '.') {
+        --end;  // Fully qualified form
+    }
+
+    quint32 node = 0;
+    while (end > 0) {
+        qsizetype start = end;
+        while (start > 0 && host[start - 1] != '.') {
+            --start;
+        }
+        const QByteArrayView label = host.sliced(start, end - start);
+        const quint32 hash = hashLower(label);
+
+        // Children are sorted by hash; equal hashes are compared by text
+        const Edge* first = m_edges + m_nodes[node].firstEdge;
+        const Edge* last = first + m_nodes[node].edgeCount;
+        const Edge* edge = std::lower_bound(first, last, hash, [](const Edge& e, quint32 h) {
+            return e.hash < h;
+        });
+        quint32 child = NO_NODE;
+        for (; edge != last && edge->hash == hash; ++edge) {
+            if (equalsLower(label, m_strings + edge->labelOffset, edge->labelLength)) {
+                child = edge->child;
+                break;
+            }
+        }
+        if (child == NO_NODE) {
+            return 0;
+        }
+        if (m_nodes[child].categories != 0) {
+            return m_nodes[child].categories;
+        }
+
+        node = child;
+        end = start - 1;
+    }
+    return 0;
+}
+
+quint32 Blocklist::findPathRule(quint32 kind, QByteArrayView text) const
+{
+    const quint32 hash = hashLower(text);
+    const PathRule* last = m_pathRules + m_pathRuleCount;
+    const PathRule* rule = std::lower_bound(m_pathRules, last, hash, [](const PathRule& r, quint32 h) {
+        return r.hash < h;
+    });
+    for (; rule != last && rule->hash == hash; ++rule) {
+        if (rule->kind == kind && equalsLower(text, m_strings + rule->textOffset, rule->textLength)) {
+            return rule->categories;
+        }
+    }
+    return 0;
+}
+
+quint32 Blocklist::matchPath(QByteArrayView path) const
+{
+    if (!m_pathRules || m_pathRuleCount == 0) {
+        return 0;
+    }
+
+    qsizetype start = 0;
+    while (start < path.size()) {
+        qsizetype end = start;
+        while (end < path.size() && path[end] != '/') {
+            ++end;
+        }
+
+        if (end > start) {
+            const QByteArrayView segment = path.sliced(start, end - start);
+            if (quint32 categories = findPathRule(SegmentRule, segment)) {
+                return categories;
+            }
+            if (end == path.size()) {
+                // The file name's extension
+                const qsizetype dot = segment.lastIndexOf('.');
+                if (dot >= 0 && dot + 1 < segment.size()) {
+                    if (quint32 categories = findPathRule(ExtensionRule, segment.sliced(dot + 1))) {
+                        return categories;
+                    }
+                }
+            }
+        }
+        start = end + 1;
+    }
+    return 0;
+}
+
+quint32 Blocklist::match(QByteArrayView host, QByteArrayView path) const
+{
+    if (quint32 categories = matchHost(host)) {
+        return categories;
+    }
+    return matchPath(path);
+}
+
+QString Blocklist::categoryName(quint32 categories)
+{
+    if (categories & Ads) {
+        return "ads";
+    }
+    if (categories & Trackers) {
+        return "trackers";
+    }
+    if (categories & Heavy) {
+        return "heavy";
+    }
+    return QString();
+}
+
+bool Blocklist::compile(const QStringList& listPaths, QByteArray* image, QString* error)
+{
+    struct BuildNode
+    {
+        quint32 categories = 0;
+        QMap<QByteArray, quint32> children;
+    };
+    std::vector<BuildNode> trie(1);
+    QMap<QPair<quint32, QByteArray>, quint32> pathRules;  // (kind, text) -> categories
+
+    static const QHash<QString, quint32> sections = {
+        {"ads", Ads}, {"trackers", Trackers}, {"heavy", Heavy}
+    };
+
+    for (const QString& listPath : listPaths) {
+        QFile file(listPath);
+        if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            *error = QString("%1: %2").arg(listPath, file.errorString());
+            return false;
+        }
+
+        quint32 category = 0;
+        int lineNumber = 0;
+        QTextStream in(&file);
+        while (!in.atEnd()) {
+            ++lineNumber;
+            QString line = in.readLine();
+            const int comment = line.indexOf('#');
+            if (comment >= 0) {
+                line.truncate(comment);
+            }
+            line = line.trimmed().toLower();
+            if (line.isEmpty()) {
+                continue;
+            }
+
+            const QString where = QString("%1:%2").arg(listPath).arg(lineNumber);
+            if (line.startsWith('[') && line.endsWith(']')) {
+                category = sections.value(line.mid(1, line.size() - 2));
+                if (category == 0) {
+                    *error = QString("%1: unknown section %2").arg(where, line);
+                    return false;
+                }
+                continue;
+            }
+            if (category == 0) {
+                *error = QString("%1: rule before the first [section]").arg(where);
+                return false;
+            }
+
+            const QByteArray rule = line.toUtf8();
+            if (rule.startsWith("*.") && !rule.mid(2).contains('.')) {
+                const QByteArray extension = rule.mid(2);
+                if (extension.isEmpty() || extension.contains('/')) {
+                    *error = QString("%1: bad extension rule %2").arg(where, line);
+                    return false;
+                }
+                pathRules[qMakePair(quint32(ExtensionRule), extension)] |= category;
+            } else if (rule.startsWith('/')) {
+                const QByteArray segment = rule.mid(1, rule.size() - 2);
+                if (rule.size() < 3 || !rule.endsWith('/') || segment.contains('/')) {
+                    *error = QString("%1: path rules are a single /segment/, got %2").arg(where, line);
+                    return false;
+                }
+                pathRules[qMakePair(quint32(SegmentRule), segment)] |= category;
+            } else {
+                // Hosts; a leading "*." is redundant since subdomains are covered anyway
+                QByteArray host = rule.startsWith("*.") ? rule.mid(2) : rule;
+                if (host.endsWith('.')) {
+                    host.chop(1);
+                }
+                const QList<QByteArray> labels = host.split('.');
+                for (const QByteArray& label : labels) {
+                    bool valid = !label.isEmpty();
+                    for (char c : label) {
+                        valid = valid && ((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '-' || c == '_');
+                    }
+                    if (!valid) {
+                        *error = QString("%1: bad host rule %2").arg(where, line);
+                        return false;
+                    }
+                }
+
+                quint32 node = 0;
+                for (auto it = labels.crbegin(); it != labels.crend(); ++it) {
+                    auto child = trie[node].children.constFind(*it);
+                    if (child == trie[node].children.constEnd()) {
+                        trie.emplace_back();
+                        child = trie[node].children.insert(*it, quint32(trie.size() - 1));
+                    }
+                    node = *child;
+                }
+                trie[node].categories |= category;
+            }
+        }
+    }
+
+    // Shared string table; identical labels are stored once
+    QByteArray strings;
+    QHash<QByteArray, quint32> stringOffsets;
+    auto intern = [&strings, &stringOffsets](const QByteArray& text) {
+        auto it = stringOffsets.constFind(text);
+        if (it != stringOffsets.constEnd()) {
+            return *it;
+        }
+        const quint32 offset = quint32(strings.size());
+        strings.append(text);
+        stringOffsets.insert(text, offset);
+        return offset;
+    };
+
+    std::vector<Node> nodes(trie.size());
+    std::vector<Edge> edges;
+    for (size_t i = 0; i < trie.size(); ++i) {
+        std::vector<Edge> children;
+        for (auto it = trie[i].children.constBegin(); it != trie[i].children.constEnd(); ++it) {
+            Edge edge;
+            edge.hash = hashLower(it.key());
+            edge.labelOffset = intern(it.key());
+            edge.labelLength = quint32(it.key().size());
+            edge.child = it.value();
+            children.push_back(edge);
+        }
+        std::stable_sort(children.begin(), children.end(), [](const Edge& a, const Edge& b) {
+            return a.hash < b.hash;
+        });
+
+        nodes[i].firstEdge = quint32(edges.size());
+        nodes[i].edgeCount = quint32(children.size());
+        nodes[i].categories = trie[i].categories;
+        edges.insert(edges.end(), children.begin(), children.end());
+    }
+
+    std::vector<PathRule> rules;
+    for (auto it = pathRules.constBegin(); it != pathRules.constEnd(); ++it) {
+        PathRule rule;
+        rule.hash = hashLower(it.key().second);
+        rule.textOffset = intern(it.key().second);
+        rule.textLength = quint32(it.key().second.size());
+        rule.kind = it.key().first;
+        rule.categories = it.value();
+        rules.push_back(rule);
+    }
+    std::stable_sort(rules.begin(), rules.end(), [](const PathRule& a, const PathRule& b) {
+        return a.hash < b.hash;
+    });
+
+    Header header;
+    std::memcpy(header.magic, BLOCKLIST_MAGIC, sizeof(BLOCKLIST_MAGIC));
+    header.version = FORMAT_VERSION;
+    header.nodeCount = quint32(nodes.size());
+    header.edgeCount = quint32(edges.size());
+    header.pathRuleCount = quint32(rules.size());
+    header.stringBytes = quint32(strings.size());
+
+    image->clear();
+    image->append(reinterpret_cast<const char*>(&header), sizeof(header));
+    image->append(reinterpret_cast<const char*>(nodes.data()), qsizetype(nodes.size() * sizeof(Node)));
+    image->append(reinterpret_cast<const char*>(edges.data()), qsizetype(edges.size() * sizeof(Edge)));
+    image->append(reinterpret_cast<const char*>(rules.data()), qsizetype(rules.size() * sizeof(PathRule)));
+    image->append(strings);
+    return true;
+}
@@ -1,5 +1,10 @@
 #include "BrowserWidget.h"
 #include "DatabaseManager.h"
+#include "PageCache.h"
+#include "Tracer.h"
+#include "Log.h"
+#include "MetricsRegistry.h"
+#include "EventLoopMonitor.h"
 #include <QApplication>
 #include <QClipboard>
 #include <QDesktopServices>
@@ -19,9 +24,21 @@
 #include <QMouseEvent>
 #include <QGraphicsOpacityEffect>
 #include <QPropertyAnimation>
+#include <QPointer>
+#include <QPaintEvent>
+#include <QEvent>
+#include <QEnterEvent>
+#include <QRandomGenerator>
+
+const int BrowserWidget::THUMBNAIL_SETTLE_MS = 1500;        // Thawed page repaints before the grab
+const int BrowserWidget::THUMBNAIL_MAX_SETTLE_ATTEMPTS = 10; // A page still loading gets this many settles
+const int BrowserWidget::LIVE_RELEASE_MS = 800;
 
 BrowserWidget::BrowserWidget(int windowId, QWidget *parent)
     : QWidget(parent)
+    , m_toolbarLayout(nullptr)  // FIXED: Explicitly initialize to null if not already
+    , m_viewStack(nullptr)
+    , m_thumbnailLabel(nullptr)
     , m_windowId(windowId)
     , m_subWindowId(-1)  // Initialize to invalid ID
     , m_isFullscreen(false)
@@ -30,13 +47,21 @@ BrowserWidget::BrowserWidget(int windowId, QWidget *parent)
     , m_saveTimer(new QTimer(this))
     , m_currentZoomFactor(1.0)
     , m_referenceSize(1920, 1080)  // Default reference resolution
+    , m_screenSize(1920, 1080)
     , m_autoResolutionEnabled(true)
     , m_hoverTimer(new QTimer(this))
     , m_autoHideTimer(new QTimer(this))
     , m_buttonsVisible(false)
-    , m_toolbarLayout(nullptr)  // FIXED: Explicitly initialize to null if not already
     , m_isLoaded(false)  // New: Initialize to false
+    , m_createdNs(Tracer::getInstance()->now())
+    , m_hud(nullptr)
+    , m_thumbnailInterval(DatabaseManager::DEFAULT_THUMBNAIL_INTERVAL)
+    , m_thumbnailTimer(new QTimer(this))
+    , m_captureTimer(new QTimer(this))
+    , m_liveReleaseTimer(new QTimer(this))
 {
+    TRACE_SCOPE_ARG("BrowserWidget::BrowserWidget", "tile", windowId);
+
     setupUI();
 
     setupContextMenu();
@@ -70,6 +95,20 @@ BrowserWidget::BrowserWidget(int windowId, QWidget *parent)
     QShortcut* closeShortcut = new QShortcut(QKeySequence("Ctrl+W"), this);
     connect(closeShortcut, &QShortcut::activated, this, &BrowserWidget::onCloseClicked);
 
+    // Performance HUD, refreshed with each ResourceSampler pass while shown
+    m_hud = new TileHud(this);
+    
+    // Thumbnail wall timers; idle unless thumbnail mode is on
+    m_thumbnailTimer->setSingleShot(true);
+    connect(m_thumbnailTimer, &QTimer::timeout, this, &BrowserWidget::onThumbnailTimeout);
+    m_captureTimer->setSingleShot(true);
+    m_captureTimer->setInterval(THUMBNAIL_SETTLE_MS);
+    connect(m_captureTimer, &QTimer::timeout, this, &BrowserWidget::onCaptureSettled);
+    m_liveReleaseTimer->setSingleShot(true);
+    m_liveReleaseTimer->setInterval(LIVE_RELEASE_MS);
+    connect(m_liveReleaseTimer, &QTimer::timeout, this, &BrowserWidget::onLiveReleaseTimeout);
+    connect(qApp, &QApplication::focusChanged, this, &BrowserWidget::updateLiveState);
+
     setMouseTracking(true);
 }
 
@@ -77,14 +116,7 @@ BrowserWidget::~BrowserWidget()
 {
     saveState();  // Save before destroy
 
-    // FIXED: Flush Profile destruction to ensure HistoryBackend closes properly (fixes HasPath conflict for next profile)
-    if (m_profile) {
-        // Use Qt's destroy mechanism to flush Backend
-        m_profile->deleteLater();  // Async delete with event loop flush
-        // Optional: Set a task to ensure Backend shutdown
-        m_profile->setHttpUserAgent("");  // Trigger cleanup
-    }
-
+    // Pages and profiles belong to the PageCache; only the view goes with the widget
     if (m_webView) {
         m_webView->deleteLater();
     }
@@ -189,55 +221,32 @@ void BrowserWidget::setupToolbar()
 void BrowserWidget::setupWebView()
 {
     
-    // FIXED: Use unique in-memory Profile to avoid History DB lock/conflict (no persistent storage)
-    static int s_profileCounter = 0;
-    QString profileName = QString("BrowserWidget_%1_%2").arg(m_windowId).arg(++s_profileCounter);
-    m_profile = new QWebEngineProfile(profileName, this);
-    qDebug() << "BrowserWidget::setupWebView: Profile created:" << (m_profile ? "SUCCESS (unique in-memory)" : "FAILED");
-    // FIXED: Temporarily disable persistent storage to prevent DB lock; restore later if needed
-    // QString storagePath = QDir::homePath() + QString("/.browser_split_screen/profiles/%1").arg(m_windowId);
-    // m_profile->setPersistentStoragePath(storagePath);
-    
-    m_webView = new QWebEngineView(m_profile, this);
-    qDebug() << "BrowserWidget::setupWebView: WebView created:" << (m_webView ? "SUCCESS" : "FAILED");
+    // The view starts without a sub-window page; WindowManager attaches one from the
+    // PageCache (per-sub-window profile, settings and RequestBlocker) when a sub-window is assigned
+    m_webView = new QWebEngineView(this);
+    LOG_DEBUG("tile") << "BrowserWidget::setupWebView: WebView created:" << (m_webView ? "SUCCESS" : "FAILED");
     if (m_webView) {
         m_webView->setContextMenuPolicy(Qt::CustomContextMenu);
     }
     
-    if (m_webView) {
-        QWebEngineSettings* settings = m_webView->settings();
-        qDebug() << "BrowserWidget::setupWebView: Settings obtained:" << (settings ? "SUCCESS" : "FAILED");
-        
-        if (settings) {
-            settings->setAttribute(QWebEngineSettings::JavascriptEnabled, true);
-            settings->setAttribute(QWebEngineSettings::LocalContentCanAccessRemoteUrls, true);
-            settings->setAttribute(QWebEngineSettings::LocalContentCanAccessFileUrls, true);
-            settings->setAttribute(QWebEngineSettings::AutoLoadImages, true);
-            settings->setAttribute(QWebEngineSettings::PluginsEnabled, true);
-            settings->setAttribute(QWebEngineSettings::WebGLEnabled, true);
-            settings->setAttribute(QWebEngineSettings::Accelerated2dCanvasEnabled, true);
-            settings->setAttribute(QWebEngineSettings::AutoLoadIconsForPage, true);
-            settings->setAttribute(QWebEngineSettings::TouchIconsEnabled, true);
-            settings->setAttribute(QWebEngineSettings::FocusOnNavigationEnabled, true);
-            settings->setAttribute(QWebEngineSettings::PrintElementBackgrounds, true);
-            settings->setAttribute(QWebEngineSettings::AllowRunningInsecureContent, true);
-            settings->setAttribute(QWebEngineSettings::AllowGeolocationOnInsecureOrigins, true);
-            settings->setAttribute(QWebEngineSettings::AllowWindowActivationFromJavaScript, true);
-            settings->setAttribute(QWebEngineSettings::ShowScrollBars, true);
-            settings->setAttribute(QWebEngineSettings::PlaybackRequiresUserGesture, false);
-            settings->setAttribute(QWebEngineSettings::JavascriptCanOpenWindows, true);
-            settings->setAttribute(QWebEngineSettings::JavascriptCanAccessClipboard, true);
-            settings->setAttribute(QWebEngineSettings::LinksIncludedInFocusChain, true);
-            settings->setAttribute(QWebEngineSettings::LocalStorageEnabled, true);
-            qDebug() << "BrowserWidget::setupWebView: All web settings applied";
-        }
-    }
+    // The thumbnail sits on top of the view in the same slot; StackAll keeps the view
+    // laid out (and grabbable) underneath it while a snapshot is being taken
+    m_thumbnailLabel = new QLabel(this);
+    m_thumbnailLabel->setScaledContents(true);
+    m_thumbnailLabel->setSizePolicy(QSizePolicy::Ignored, QSizePolicy::Ignored);
+    m_thumbnailLabel->setStyleSheet("QLabel { background-color: #e8e8e8; }");
     
-    m_mainLayout->addWidget(m_webView);
+    m_viewStack = new QStackedLayout();
+    m_viewStack->setStackingMode(QStackedLayout::StackAll);
+    m_viewStack->addWidget(m_webView);
+    m_viewStack->addWidget(m_thumbnailLabel);
+    m_thumbnailLabel->hide();
+    m_mainLayout->addLayout(m_viewStack);
     
     // Connect web view signals
     connect(m_webView, &QWebEngineView::urlChanged, this, &BrowserWidget::onUrlChanged);
     connect(m_webView, &QWebEngineView::titleChanged, this, &BrowserWidget::onTitleChanged);
+    connect(m_webView, &QWebEngineView::loadStarted, this, &BrowserWidget::onLoadStarted);
     connect(m_webView, &QWebEngineView::loadProgress, this, &BrowserWidget::onLoadProgress);
     connect(m_webView, &QWebEngineView::loadFinished, this, &BrowserWidget::onLoadFinished);
     connect(m_webView, &QWebEngineView::customContextMenuRequested, 
@@ -309,11 +318,37 @@ void BrowserWidget::onLoadFinished(bool success)
         m_statusLabel->setText(success ? "加载完成" : "加载失败");
     }
     
+    if (m_loadStartNs >= 0) {
+        Tracer* tracer = Tracer::getInstance();
+        m_lastNavigationNs = tracer->now() - m_loadStartNs;
+        tracer->record("tile-load", "tile", m_loadStartNs, m_lastNavigationNs, m_windowId);
+        if (success) {
+            MetricsRegistry::getInstance()->observe("bss_tile_load_seconds",
+                                                    MetricsRegistry::label("sub_window", m_subWindowId),
+                                                    m_lastNavigationNs / 1e9);
+        }
+        m_loadStartNs = -1;
+        updateHud();
+    }
+    
+    if (!success) {
+        MetricsRegistry::getInstance()->increment("bss_navigation_failures",
+                                                  MetricsRegistry::label("sub_window", m_subWindowId));
+    }
+    
     if (success && !m_currentUrl.isEmpty()) {
         addToHistory(m_currentUrl, m_currentTitle);
         
         // Execute pending cookie script if any (for loading cookies)
         executeCookieScript();
+
+        // Restore the scroll position persisted in window_configs
+        if (!m_pendingScrollPosition.isNull()) {
+            m_webView->page()->runJavaScript(QString("window.scrollTo(%1, %2);")
+                                             .arg(m_pendingScrollPosition.x())
+                                             .arg(m_pendingScrollPosition.y()));
+            m_pendingScrollPosition = QPointF();
+        }
         
         // Save cookies after successful page load (only if subWindowId is set)
         if (m_subWindowId > 0) {
@@ -324,11 +359,6 @@ void BrowserWidget::onLoadFinished(bool success)
     
     emit loadFinished(success);
     updateToolbarState();
-    
-    // Update web view resolution after page loads
-    if (success && m_autoResolutionEnabled && m_webView) {
-        QTimer::singleShot(500, this, &BrowserWidget::updateWebViewResolution);
-    }
 }
 
 void BrowserWidget::onFullscreenClicked()
@@ -348,6 +378,8 @@ void BrowserWidget::onForwardClicked()
 
 void BrowserWidget::onRefreshClicked()
 {
+    ++m_reloadCount;
+    MetricsRegistry::getInstance()->increment("bss_tile_reloads", MetricsRegistry::label("sub_window", m_subWindowId));
     m_webView->reload();
 }
 
@@ -376,7 +408,7 @@ void BrowserWidget::updateToolbarState()
 {
     // FIXED: Null check - if no toolbar, skip
     if (!m_toolbarLayout) {
-        qDebug() << "updateToolbarState: m_toolbarLayout is null, nothing to update (setupToolbar commented)";
+        LOG_DEBUG("tile") << "updateToolbarState: m_toolbarLayout is null, nothing to update (setupToolbar commented)";
         return;
     }
     
@@ -385,52 +417,72 @@ void BrowserWidget::updateToolbarState()
 
 void BrowserWidget::saveWindowState()
 {
-    QJsonObject geometry;
-    geometry["x"] = x();
-    geometry["y"] = y();
-    geometry["width"] = width();
-    geometry["height"] = height();
-    
-    m_windowState = geometry;
+    m_windowState = captureWindowConfig();
+}
+
+WindowConfig BrowserWidget::captureWindowConfig() const
+{
+    WindowConfig config;
+    config.windowId = m_subWindowId;
+    config.subId = m_subWindowId;
+    config.url = m_currentUrl;
+    config.title = m_currentTitle;
+    config.geometry = geometry();
+    config.zoomFactor = m_currentZoomFactor;
+
+    if (m_webView && m_webView->page()) {
+        QWebEnginePage* page = m_webView->page();
+        config.scrollPosition = page->scrollPosition();
+        switch (page->lifecycleState()) {
+            case QWebEnginePage::LifecycleState::Frozen:
+                config.lifecycleState = WindowConfig::Frozen;
+                break;
+            case QWebEnginePage::LifecycleState::Discarded:
+                config.lifecycleState = WindowConfig::Discarded;
+                break;
+            default:
+                config.lifecycleState = m_isLoaded ? WindowConfig::Active : WindowConfig::Unloaded;
+                break;
+        }
+    }
+
+    return config;
 }
 
-// FIXED: Restore loadUrl in loadWindowState but with the delayed version from loadUrl
 void BrowserWidget::loadWindowState()
 {
+    TRACE_SCOPE_ARG("BrowserWidget::loadWindowState", "tile", m_windowId);
+
+    // Pool widgets are constructed before any sub-window is assigned; nothing to restore yet
+    if (m_subWindowId <= 0) {
+        return;
+    }
+
     DatabaseManager* dbManager = DatabaseManager::getInstance();
-    qDebug() << "BrowserWidget::loadWindowState: DatabaseManager obtained:" << (dbManager ? "SUCCESS" : "FAILED");
-    
     if (!dbManager) {
-        qDebug() << "BrowserWidget::loadWindowState: ERROR - DatabaseManager is null, skipping";
+        LOG_WARNING("tile") << "BrowserWidget::loadWindowState: ERROR - DatabaseManager is null, skipping";
         return;
     }
     
-    QJsonObject config = dbManager->loadWindowConfig(m_windowId);
-    
-    if (config.contains("geometry")) {
-        QJsonObject geometry = config["geometry"].toObject();
-        if (geometry.contains("x") && geometry.contains("y") &&
-            geometry.contains("width") && geometry.contains("height")) {
-        }
-    }
-    
-    // 从sub_window表获取URL进行加载，不再从window_configs获取
-    // 需要有subWindowId，才能去数据库查sub_window表
-    if (m_subWindowId > 0) {
-        DatabaseManager* dbManager = DatabaseManager::getInstance();
-        if (dbManager) {
-            QJsonObject subWindow = dbManager->getSubWindow(m_subWindowId);
-            QString url = subWindow.value("url").toString();
-            if (!url.isEmpty()) {
-                loadUrl(url);
-            } else {
-            }
-        } else {
-            qDebug() << "BrowserWidget::loadWindowState: DatabaseManager unavailable, cannot fetch sub_window";
+    // window_configs is keyed by subId (1:1 mapping with sub_windows)
+    WindowConfig config = dbManager->loadWindowConfig(m_subWindowId);
+
+    QString url;
+    if (config.isValid()) {
+        m_currentZoomFactor = config.zoomFactor > 0.0 ? config.zoomFactor : 1.0;
+        if (m_webView) {
+            m_webView->setZoomFactor(m_currentZoomFactor);
         }
+        m_pendingScrollPosition = config.scrollPosition;
+        url = config.homeUrl;
     } else {
+        // 从sub_window表获取URL进行加载，不再从window_configs获取
+        url = dbManager->getSubWindow(m_subWindowId).value("url").toString();
+    }
+
+    if (!url.isEmpty()) {
+        loadUrl(url);
     }
-    
 }
 
 void BrowserWidget::addToHistory(const QString& url, const QString& title)
@@ -469,19 +521,19 @@ QString BrowserWidget::formatUrl(const QString& url)
 void BrowserWidget::loadUrl(const QString& url)
 {
 
-    // Early return if already loaded with same URL
+    // Early return if already loaded with same URL (redirects change m_currentUrl, not the request)
     QString formattedUrl = formatUrl(url);
-    if (m_isLoaded && m_currentUrl == formattedUrl) {
+    if (m_isLoaded && getRequestedUrl() == formattedUrl) {
         return;
     }
 
     // FIXED: Sanity check - ensure webview and page are valid before load
     if (!m_webView) {
-        qDebug() << "loadUrl: CRITICAL - m_webView is null, cannot load URL";
+        LOG_WARNING("tile") << "loadUrl: CRITICAL - m_webView is null, cannot load URL";
         return;
     }
     if (!m_webView->page()) {
-        qDebug() << "loadUrl: WARNING - m_webView->page() is null, delaying load";
+        LOG_WARNING("tile") << "loadUrl: WARNING - m_webView->page() is null, delaying load";
         // Delay to allow page init
         QTimer::singleShot(100, [this, url]() { loadUrl(url); });
         return;
@@ -489,22 +541,27 @@ void BrowserWidget::loadUrl(const QString& url)
 
     // Store URL for later loading if widget not visible yet
     m_currentUrl = formattedUrl;
+    PageCache::setRequestedUrl(m_webView->page(), formattedUrl);
 
     // PERFORMANCE: Only load if widget is visible (lazy loading strategy)
     if (!isVisible()) {
-        qDebug() << "loadUrl: Widget not visible, deferring load until shown (lazy load)";
+        LOG_DEBUG("tile") << "loadUrl: Widget not visible, deferring load until shown (lazy load)";
         m_isLoaded = false;  // Mark as not loaded so showEvent will trigger load
         return;
     }
 
     // FIXED: Delay load by 500ms to allow full WebEngine initialization (fixes connection_state crash)
-    QTimer::singleShot(500, [this, formattedUrl]() {
-        qDebug() << "loadUrl: Delayed load timer fired, calling m_webView->load";
-        if (m_webView && m_webView->page()) {
-            qDebug() << "loadUrl: Loading" << formattedUrl << "for widget" << m_windowId;
+    // The page is captured so a reassignment during the delay cannot load into another sub-window's page
+    QPointer<QWebEnginePage> targetPage = m_webView->page();
+    QTimer::singleShot(500, this, [this, formattedUrl, targetPage]() {
+        LOG_DEBUG("tile") << "loadUrl: Delayed load timer fired, calling m_webView->load";
+        if (m_webView && targetPage && m_webView->page() == targetPage) {
+            LOG_DEBUG("tile") << "loadUrl: Loading" << formattedUrl << "for widget" << m_windowId;
+            // Zoom is set before the navigation so the first layout already uses it
+            updateWebViewResolution();
             m_webView->load(QUrl(formattedUrl));
         } else {
-            qDebug() << "loadUrl: Delayed load failed - webview/page null";
+            LOG_DEBUG("tile") << "loadUrl: Delayed load skipped - page moved or view null";
         }
     });
     
@@ -517,6 +574,7 @@ void BrowserWidget::setWindowId(int id)
 
 void BrowserWidget::saveState()
 {
+    STALL_SCOPE("BrowserWidget::saveState");
     saveWindowState();
 
     // Only save window_config if this widget has been assigned a subwindow
@@ -524,9 +582,8 @@ void BrowserWidget::saveState()
     if (m_subWindowId > 0) {
         DatabaseManager* dbManager = DatabaseManager::getInstance();
         if (dbManager) {
-            dbManager->saveWindowConfig(m_subWindowId, m_subWindowId, m_currentUrl, m_currentTitle, m_windowState);
+            dbManager->saveWindowConfig(m_windowState);
         }
-    } else {
     }
 
     // Also save cookies
@@ -551,13 +608,13 @@ void BrowserWidget::setFullscreenMode(bool fullscreen)
         m_fullscreenButton->setText(fullscreen ? "取消全屏" : "⛶");
         m_fullscreenButton->setToolTip(fullscreen ? "退出全屏 (ESC)" : "全屏");
     } else {
-        qDebug() << "setFullscreenMode: WARNING - m_fullscreenButton is null (setupToolbar commented)";
+        LOG_WARNING("tile") << "setFullscreenMode: WARNING - m_fullscreenButton is null (setupToolbar commented)";
     }
     
     if (m_refreshButton) {
         // Update refresh button if needed
     } else {
-        qDebug() << "setFullscreenMode: WARNING - m_refreshButton is null";
+        LOG_WARNING("tile") << "setFullscreenMode: WARNING - m_refreshButton is null";
     }
     
     // In fullscreen mode, remove size constraints to allow full screen usage
@@ -663,8 +720,11 @@ void BrowserWidget::setFullscreenMode(bool fullscreen)
     
     // Update web view resolution when switching fullscreen mode
     if (m_autoResolutionEnabled) {
-        QTimer::singleShot(200, this, &BrowserWidget::updateWebViewResolution);
+        emit zoomUpdateRequested();
     }
+    
+    // The fullscreen tile is always live in thumbnail mode
+    updateLiveState();
 }
 
 bool BrowserWidget::isFullscreenMode() const
@@ -689,6 +749,12 @@ QString BrowserWidget::getCurrentTitle() const
 
 void BrowserWidget::refresh()
 {
+    // A frozen page would not run the reload; thaw it and snapshot the result
+    if (m_thumbnailMode && !m_live) {
+        beginCapture();
+    }
+    ++m_reloadCount;
+    MetricsRegistry::getInstance()->increment("bss_tile_reloads", MetricsRegistry::label("sub_window", m_subWindowId));
     m_webView->reload();
 }
 
@@ -734,20 +800,20 @@ void BrowserWidget::setShowBrowserUI(bool show)
             }
         }
     } else {
-        qDebug() << "setShowBrowserUI: m_toolbarLayout is null (setupToolbar commented), skipping toolbar loop";
+        LOG_DEBUG("tile") << "setShowBrowserUI: m_toolbarLayout is null (setupToolbar commented), skipping toolbar loop";
     }
     
     // FIXED: Always handle progressBar and statusLabel with null checks
     if (m_progressBar) {
         m_progressBar->setVisible(show);
     } else {
-        qDebug() << "setShowBrowserUI: WARNING - m_progressBar is null";
+        LOG_WARNING("tile") << "setShowBrowserUI: WARNING - m_progressBar is null";
     }
     
     if (m_statusLabel) {
         m_statusLabel->setVisible(show);
     } else {
-        qDebug() << "setShowBrowserUI: WARNING - m_statusLabel is null";
+        LOG_WARNING("tile") << "setShowBrowserUI: WARNING - m_statusLabel is null";
     }
     
     // Always show sub window name label (as before)
@@ -785,6 +851,11 @@ void BrowserWidget::updateWebViewResolution()
     }
 }
 
+void BrowserWidget::setScreenSize(const QSize& screenSize)
+{
+    m_screenSize = screenSize;
+}
+
 double BrowserWidget::calculateOptimalZoomFactor() const
 {
     if (!m_webView) {
@@ -807,11 +878,9 @@ double BrowserWidget::calculateOptimalZoomFactor() const
     if (m_isFullscreen) {
         // In fullscreen mode, we want to use more of the screen space
         // Scale up by a factor that makes better use of the screen
-        QScreen* screen = QApplication::primaryScreen();
-        if (screen) {
-            QSize screenSize = screen->geometry().size();
-            double screenWidthRatio = static_cast<double>(screenSize.width()) / m_referenceSize.width();
-            double screenHeightRatio = static_cast<double>(screenSize.height()) / m_referenceSize.height();
+        if (m_screenSize.isValid()) {
+            double screenWidthRatio = static_cast<double>(m_screenSize.width()) / m_referenceSize.width();
+            double screenHeightRatio = static_cast<double>(m_screenSize.height()) / m_referenceSize.height();
             double screenZoomFactor = qMin(screenWidthRatio, screenHeightRatio);
             
             // Use a weighted average between base zoom and screen zoom
@@ -841,7 +910,7 @@ void BrowserWidget::resizeEvent(QResizeEvent* event)
         }
         m_fullscreenButton->raise();
     } else {
-        qDebug() << "resizeEvent: m_fullscreenButton null, skipping";
+        LOG_DEBUG("tile") << "resizeEvent: m_fullscreenButton null, skipping";
     }
     
     if (m_refreshButton) {
@@ -852,14 +921,80 @@ void BrowserWidget::resizeEvent(QResizeEvent* event)
         }
         m_refreshButton->raise();
     } else {
-        qDebug() << "resizeEvent: m_refreshButton null, skipping";
+        LOG_DEBUG("tile") << "resizeEvent: m_refreshButton null, skipping";
+    }
+    
+    // A snapshot is stretched until the next capture; take it now if the size changed a lot
+    if (m_thumbnailMode && !m_live && m_thumbnailLabel && !m_thumbnailLabel->pixmap().isNull() &&
+        (qAbs(m_thumbnailLabel->pixmap().width() - m_thumbnailLabel->width()) > m_thumbnailLabel->width() / 4 ||
+         qAbs(m_thumbnailLabel->pixmap().height() - m_thumbnailLabel->height()) > m_thumbnailLabel->height() / 4)) {
+        beginCapture();
     }
     
-    // FIXED: Update resolution only if webview exists
+    // Zoom is recomputed once per frame by WindowManager, not per resize event
     if (m_webView && m_autoResolutionEnabled) {
-        QTimer::singleShot(100, this, &BrowserWidget::updateWebViewResolution);
-    } else {
+        emit zoomUpdateRequested();
+    }
+}
+
+void BrowserWidget::attachPage(QWebEnginePage* page)
+{
+    if (!m_webView || !page || m_webView->page() == page) {
+        return;
+    }
+    
+    // Moves a live page into this view; a page shown elsewhere is unbound from that view
+    m_webView->setPage(page);
+    
+    QString requested = PageCache::requestedUrl(page);
+    m_currentUrl = page->url().isEmpty() ? requested : page->url().toString();
+    m_currentTitle = page->title();
+    m_currentZoomFactor = page->zoomFactor();
+    m_isLoaded = !requested.isEmpty() && !page->url().isEmpty();
+    m_pendingCookieScript.clear();
+    
+    if (m_progressBar) {
+        m_progressBar->setVisible(page->isLoading());
+    }
+    updateToolbarState();
+    
+    // The page may arrive frozen from another tile, and the old snapshot belongs to
+    // another sub-window: show the page until its own snapshot is ready
+    if (m_thumbnailMode && !m_live) {
+        m_thumbnailLabel->clear();
+        showLiveView();
+        beginCapture();
+    }
+}
+
+void BrowserWidget::clearSubWindow()
+{
+    // The page went to another tile; this pooled widget no longer represents a sub-window
+    m_subWindowId = -1;
+    m_currentUrl.clear();
+    m_currentTitle.clear();
+    m_isLoaded = false;
+    m_pendingScrollPosition = QPointF();
+    m_pendingCookieScript.clear();
+    m_thumbnailTimer->stop();
+    m_captureTimer->stop();
+    if (m_thumbnailLabel) {
+        m_thumbnailLabel->clear();
+    }
+    setSubWindowName(QString());
+}
+
+QString BrowserWidget::getRequestedUrl() const
+{
+    return m_webView ? PageCache::requestedUrl(m_webView->page()) : QString();
+}
+
+QWebEngineProfile* BrowserWidget::currentProfile() const
+{
+    if (!m_webView || !m_webView->page()) {
+        return nullptr;
     }
+    return m_webView->page()->profile();
 }
 
 void BrowserWidget::setSubWindowId(int subWindowId)
@@ -870,7 +1005,7 @@ void BrowserWidget::setSubWindowId(int subWindowId)
     if (m_subWindowId > 0) {
         loadCookies();
     } else {
-        qDebug() << "BrowserWidget::setSubWindowId: Invalid subWindowId" << subWindowId << ", skipping cookie load";
+        LOG_DEBUG("tile") << "BrowserWidget::setSubWindowId: Invalid subWindowId" << subWindowId << ", skipping cookie load";
     }
 }
 
@@ -881,16 +1016,17 @@ int BrowserWidget::getSubWindowId() const
 
 void BrowserWidget::saveCookies()
 {
-    if (m_subWindowId <= 0 || !m_webView || !m_profile) {
-        qDebug() << "BrowserWidget::saveCookies: Skipping cookie save - subWindowId:" << m_subWindowId << "webView:" << (m_webView ? "valid" : "null") << "profile:" << (m_profile ? "valid" : "null");
+    QWebEngineProfile* profile = currentProfile();
+    if (m_subWindowId <= 0 || !m_webView || !profile) {
+        LOG_DEBUG("tile") << "BrowserWidget::saveCookies: Skipping cookie save - subWindowId:" << m_subWindowId << "webView:" << (m_webView ? "valid" : "null") << "profile:" << (profile ? "valid" : "null");
         return;
     }
     
     
     // Get all cookies from the profile's cookie store
-    QWebEngineCookieStore* cookieStore = m_profile->cookieStore();
+    QWebEngineCookieStore* cookieStore = profile->cookieStore();
     if (!cookieStore) {
-        qDebug() << "BrowserWidget::saveCookies: Cookie store is null";
+        LOG_DEBUG("tile") << "BrowserWidget::saveCookies: Cookie store is null";
         return;
     }
     
@@ -921,23 +1057,24 @@ void BrowserWidget::saveCookies()
     )";
     
     m_webView->page()->runJavaScript(script, [this](const QVariant& result) {
+        STALL_SCOPE("BrowserWidget::saveCookies/runJavaScript");
         if (result.isValid()) {
             QString cookieData = result.toString();
             
             // Save to file
             if (saveCookiesToFile(cookieData)) {
             } else {
-                qDebug() << "BrowserWidget::saveCookies: Failed to save cookies for sub window" << m_subWindowId;
+                LOG_WARNING("tile") << "BrowserWidget::saveCookies: Failed to save cookies for sub window" << m_subWindowId;
             }
         } else {
-            qDebug() << "BrowserWidget::saveCookies: Failed to get cookie data for sub window" << m_subWindowId;
+            LOG_WARNING("tile") << "BrowserWidget::saveCookies: Failed to get cookie data for sub window" << m_subWindowId;
         }
     });
 }
 
 void BrowserWidget::loadCookies()
 {
-    if (m_subWindowId <= 0 || !m_webView || !m_profile) {
+    if (m_subWindowId <= 0 || !m_webView || !currentProfile()) {
         return;
     }
 
@@ -952,8 +1089,8 @@ void BrowserWidget::loadCookies()
     // Parse cookies from JSON
     QJsonDocument doc = QJsonDocument::fromJson(cookieData.toUtf8());
     if (!doc.isArray()) {
-        qDebug() << "BrowserWidget::loadCookies: Invalid cookie data format for sub window" << m_subWindowId;
-        qDebug() << "=== BrowserWidget::loadCookies END (invalid format) ===";
+        LOG_DEBUG("tile") << "BrowserWidget::loadCookies: Invalid cookie data format for sub window" << m_subWindowId;
+        LOG_DEBUG("tile") << "=== BrowserWidget::loadCookies END (invalid format) ===";
         return;
     }
     
@@ -1011,6 +1148,7 @@ QString BrowserWidget::getCookieFilePath()
 
 bool BrowserWidget::saveCookiesToFile(const QString& cookieData)
 {
+    STALL_SCOPE("BrowserWidget::saveCookiesToFile");
     if (m_subWindowId <= 0) {
         return false;
     }
@@ -1019,7 +1157,7 @@ bool BrowserWidget::saveCookiesToFile(const QString& cookieData)
     QFile file(filePath);
     
     if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        qDebug() << "BrowserWidget::saveCookiesToFile: Failed to open file for writing:" << filePath;
+        LOG_WARNING("tile") << "BrowserWidget::saveCookiesToFile: Failed to open file for writing:" << filePath;
         return false;
     }
     
@@ -1033,9 +1171,10 @@ bool BrowserWidget::saveCookiesToFile(const QString& cookieData)
 
 QString BrowserWidget::loadCookiesFromFile()
 {
+    STALL_SCOPE("BrowserWidget::loadCookiesFromFile");
     if (m_subWindowId <= 0) {
-        qDebug() << "BrowserWidget::loadCookiesFromFile: Invalid subWindowId, returning empty";
-        qDebug() << "=== BrowserWidget::loadCookiesFromFile END (invalid ID) ===";
+        LOG_DEBUG("tile") << "BrowserWidget::loadCookiesFromFile: Invalid subWindowId, returning empty";
+        LOG_DEBUG("tile") << "=== BrowserWidget::loadCookiesFromFile END (invalid ID) ===";
         return QString();
     }
     
@@ -1049,8 +1188,8 @@ QString BrowserWidget::loadCookiesFromFile()
     
     
     if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        qDebug() << "BrowserWidget::loadCookiesFromFile: Failed to open file for reading:" << filePath << "Error:" << file.errorString();
-        qDebug() << "=== BrowserWidget::loadCookiesFromFile END (open failed) ===";
+        LOG_WARNING("tile") << "BrowserWidget::loadCookiesFromFile: Failed to open file for reading:" << filePath << "Error:" << file.errorString();
+        LOG_WARNING("tile") << "=== BrowserWidget::loadCookiesFromFile END (open failed) ===";
         return QString();
     }
     
@@ -1098,10 +1237,12 @@ void BrowserWidget::clearLoginState()
     )";
     
     m_webView->page()->runJavaScript(clearCookiesScript, [this](const QVariant& result) {
-        
+        STALL_SCOPE("BrowserWidget::clearLoginState/runJavaScript");
+
         // Clear cookies from profile's cookie store
-        if (m_profile && m_profile->cookieStore()) {
-            m_profile->cookieStore()->deleteAllCookies();
+        QWebEngineProfile* profile = currentProfile();
+        if (profile && profile->cookieStore()) {
+            profile->cookieStore()->deleteAllCookies();
         }
         
         // Delete cookie file
@@ -1128,7 +1269,7 @@ void BrowserWidget::deleteCookieFile()
     if (file.exists()) {
         if (file.remove()) {
         } else {
-            qDebug() << "BrowserWidget::deleteCookieFile: Failed to delete cookie file for sub window" << m_subWindowId << ":" << filePath;
+            LOG_WARNING("tile") << "BrowserWidget::deleteCookieFile: Failed to delete cookie file for sub window" << m_subWindowId << ":" << filePath;
         }
     } else {
     }
@@ -1193,6 +1334,327 @@ void BrowserWidget::showEvent(QShowEvent *event)
     }
 }
 
+void BrowserWidget::paintEvent(QPaintEvent* event)
+{
+    QWidget::paintEvent(event);
+
+    // Construction-to-first-paint span for each tile
+    if (m_createdNs >= 0) {
+        Tracer* tracer = Tracer::getInstance();
+        tracer->record("tile-first-paint", "tile", m_createdNs, tracer->now() - m_createdNs, m_windowId);
+        m_createdNs = -1;
+    }
+}
+
+bool BrowserWidget::eventFilter(QObject* watched, QEvent* event)
+{
+    // First frame the renderer delivers after a navigation started
+    if (m_awaitingFirstPaint && m_webView && watched == m_webView->focusProxy() &&
+        event->type() == QEvent::Paint && m_loadStartNs >= 0) {
+        m_awaitingFirstPaint = false;
+        m_lastFirstPaintNs = Tracer::getInstance()->now() - m_loadStartNs;
+        emit firstPaint(m_lastFirstPaintNs);
+    }
+    return QWidget::eventFilter(watched, event);
+}
+
+void BrowserWidget::onLoadStarted()
+{
+    m_loadStartNs = Tracer::getInstance()->now();
+    m_awaitingFirstPaint = true;
+
+    // The render widget exists once the view has been shown; filtering it twice is harmless
+    if (m_webView && m_webView->focusProxy()) {
+        m_webView->focusProxy()->installEventFilter(this);
+    }
+}
+
+void BrowserWidget::setHudVisible(bool visible)
+{
+    if (!m_hud) {
+        return;
+    }
+
+    m_hud->setVisible(visible);
+    if (visible) {
+        updateHud();
+    }
+}
+
+bool BrowserWidget::isHudVisible() const
+{
+    return m_hud && !m_hud->isHidden();
+}
+
+void BrowserWidget::updateHud()
+{
+    if (m_hud && !m_hud->isHidden() && isVisible()) {
+        m_hud->setMetrics(getTileMetrics());
+    }
+}
+
+qint64 BrowserWidget::getRendererPid() const
+{
+    QWebEnginePage* page = m_webView ? m_webView->page() : nullptr;
+    return page ? page->renderProcessPid() : 0;
+}
+
+void BrowserWidget::setResourceReading(const ResourceReading& reading)
+{
+    m_resourceReading = reading;
+    updateHud();
+}
+
+void BrowserWidget::setThumbnailMode(bool enabled)
+{
+    if (m_thumbnailMode == enabled) {
+        return;
+    }
+    m_thumbnailMode = enabled;
+    
+    if (enabled) {
+        // Starts out live; the first snapshot is taken once the tile is not in use
+        m_live = true;
+        updateLiveState();
+    } else {
+        m_thumbnailTimer->stop();
+        m_captureTimer->stop();
+        m_liveReleaseTimer->stop();
+        m_live = true;
+        showLiveView();
+        m_thumbnailLabel->clear();
+    }
+}
+
+bool BrowserWidget::isThumbnailMode() const
+{
+    return m_thumbnailMode;
+}
+
+void BrowserWidget::setThumbnailInterval(int seconds)
+{
+    if (seconds <= 0 || seconds == m_thumbnailInterval) {
+        return;
+    }
+    m_thumbnailInterval = seconds;
+    if (m_thumbnailTimer->isActive()) {
+        scheduleNextCapture();
+    }
+}
+
+int BrowserWidget::getThumbnailInterval() const
+{
+    return m_thumbnailInterval;
+}
+
+bool BrowserWidget::isLive() const
+{
+    return !m_thumbnailMode || m_live;
+}
+
+bool BrowserWidget::wantsLive() const
+{
+    return m_isFullscreen || m_hovered || isAncestorOf(QApplication::focusWidget());
+}
+
+void BrowserWidget::updateLiveState()
+{
+    if (!m_thumbnailMode) {
+        return;
+    }
+    
+    if (wantsLive()) {
+        m_liveReleaseTimer->stop();
+        if (!m_live) {
+            m_live = true;
+            m_thumbnailTimer->stop();
+            m_captureTimer->stop();
+            showLiveView();
+        }
+    } else if (m_live && !m_liveReleaseTimer->isActive()) {
+        // Debounced so that sweeping the pointer across the wall does not thaw every tile
+        m_liveReleaseTimer->start();
+    }
+}
+
+void BrowserWidget::onLiveReleaseTimeout()
+{
+    if (!m_thumbnailMode || !m_live || wantsLive()) {
+        return;
+    }
+    
+    // The page is live and on screen: snapshot what the operator left and freeze it
+    m_live = false;
+    if (isVisible() && m_subWindowId > 0) {
+        captureThumbnail();
+    }
+    showThumbnail();
+    scheduleNextCapture();
+}
+
+void BrowserWidget::onThumbnailTimeout()
+{
+    if (!m_thumbnailMode || m_live) {
+        return;
+    }
+    
+    // Pooled tiles that are off the wall have nothing to show; check again next interval
+    if (!isVisible() || m_subWindowId <= 0) {
+        scheduleNextCapture();
+        return;
+    }
+    beginCapture();
+}
+
+void BrowserWidget::beginCapture()
+{
+    QWebEnginePage* page = m_webView ? m_webView->page() : nullptr;
+    if (!page) {
+        return;
+    }
+    
+    // Thaw the page under the snapshot; it is grabbed once it has had time to repaint
+    m_thumbnailTimer->stop();
+    if (page->lifecycleState() != QWebEnginePage::LifecycleState::Active) {
+        page->setLifecycleState(QWebEnginePage::LifecycleState::Active);
+    }
+    m_webView->show();
+    m_captureAttempts = 0;
+    m_captureTimer->start();
+}
+
+void BrowserWidget::onCaptureSettled()
+{
+    if (!m_thumbnailMode || m_live) {
+        return;
+    }
+    
+    QWebEnginePage* page = m_webView ? m_webView->page() : nullptr;
+    if (page && page->isLoading() && ++m_captureAttempts < THUMBNAIL_MAX_SETTLE_ATTEMPTS) {
+        m_captureTimer->start();
+        return;
+    }
+    
+    captureThumbnail();
+    showThumbnail();
+    scheduleNextCapture();
+}
+
+void BrowserWidget::captureThumbnail()
+{
+    TRACE_SCOPE_ARG("BrowserWidget::captureThumbnail", "tile", m_windowId);
+    if (!m_webView || m_webView->size().isEmpty()) {
+        return;
+    }
+    
+    // Kept at logical size: on scaled screens this is a fraction of the device pixels
+    QPixmap snapshot = m_webView->grab();
+    if (snapshot.isNull()) {
+        LOG_WARNING("tile") << "captureThumbnail: grab failed for sub window" << m_subWindowId;
+        return;
+    }
+    if (snapshot.devicePixelRatio() > 1.0) {
+        snapshot = snapshot.scaled(m_webView->size(), Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        snapshot.setDevicePixelRatio(1.0);
+    }
+    m_thumbnailLabel->setPixmap(snapshot);
+    MetricsRegistry::getInstance()->increment("bss_tile_thumbnails", MetricsRegistry::label("sub_window", m_subWindowId));
+}
+
+void BrowserWidget::showThumbnail()
+{
+    m_viewStack->setCurrentWidget(m_thumbnailLabel);
+    raiseOverlays();
+    
+    // A page may only be frozen while its view is hidden
+    m_webView->hide();
+    QWebEnginePage* page = m_webView->page();
+    if (page && page->lifecycleState() == QWebEnginePage::LifecycleState::Active) {
+        page->setLifecycleState(QWebEnginePage::LifecycleState::Frozen);
+    }
+}
+
+void BrowserWidget::showLiveView()
+{
+    QWebEnginePage* page = m_webView ? m_webView->page() : nullptr;
+    if (page && page->lifecycleState() != QWebEnginePage::LifecycleState::Active) {
+        page->setLifecycleState(QWebEnginePage::LifecycleState::Active);
+    }
+    m_viewStack->setCurrentWidget(m_webView);
+    m_thumbnailLabel->hide();
+    raiseOverlays();
+}
+
+void BrowserWidget::scheduleNextCapture()
+{
+    // +/-25% jitter so that tiles sharing an interval drift apart instead of thawing together
+    const int intervalMs = m_thumbnailInterval * 1000;
+    m_thumbnailTimer->start(intervalMs * 3 / 4 + QRandomGenerator::global()->bounded(intervalMs / 2 + 1));
+}
+
+void BrowserWidget::raiseOverlays()
+{
+    if (m_fullscreenButton) m_fullscreenButton->raise();
+    if (m_refreshButton) m_refreshButton->raise();
+    if (m_hud) m_hud->raise();
+}
+
+void BrowserWidget::enterEvent(QEnterEvent* event)
+{
+    QWidget::enterEvent(event);
+    m_hovered = true;
+    updateLiveState();
+}
+
+void BrowserWidget::leaveEvent(QEvent* event)
+{
+    QWidget::leaveEvent(event);
+    m_hovered = false;
+    updateLiveState();
+}
+
+TileMetrics BrowserWidget::getTileMetrics() const
+{
+    TileMetrics metrics;
+    metrics.windowId = m_windowId;
+    metrics.subWindowId = m_subWindowId;
+    metrics.navigationMs = m_lastNavigationNs >= 0 ? m_lastNavigationNs / 1000000 : -1;
+    metrics.firstPaintMs = m_lastFirstPaintNs >= 0 ? m_lastFirstPaintNs / 1000000 : -1;
+    metrics.reloadCount = m_reloadCount;
+
+    QWebEnginePage* page = m_webView ? m_webView->page() : nullptr;
+    if (!page) {
+        metrics.lifecycleState = "无页面";
+        return metrics;
+    }
+
+    switch (page->lifecycleState()) {
+        case QWebEnginePage::LifecycleState::Active:
+            metrics.lifecycle = TileLifecycle::Active;
+            metrics.lifecycleState = "活动";
+            break;
+        case QWebEnginePage::LifecycleState::Frozen:
+            metrics.lifecycle = TileLifecycle::Frozen;
+            metrics.lifecycleState = "冻结";
+            break;
+        case QWebEnginePage::LifecycleState::Discarded:
+            metrics.lifecycle = TileLifecycle::Discarded;
+            metrics.lifecycleState = "已丢弃";
+            break;
+    }
+
+    metrics.rendererPid = page->renderProcessPid();
+
+    // Usage figures come from the ResourceSampler; a reading for another renderer is stale
+    if (m_resourceReading.rendererPid == metrics.rendererPid) {
+        metrics.rssBytes = m_resourceReading.rssBytes;
+        metrics.pssBytes = m_resourceReading.pssBytes;
+        metrics.cpuPercent = m_resourceReading.cpuPercent;
+        metrics.threadCount = m_resourceReading.threadCount;
+    }
+    return metrics;
+}
+
 void BrowserWidget::showButtons()
 {
     if (!m_isFullscreen || m_buttonsVisible) {
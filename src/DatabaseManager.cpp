@@ -1,4 +1,8 @@
 #include "DatabaseManager.h"
+#include "Tracer.h"
+#include "Log.h"
+#include "MetricsRegistry.h"
+#include "EventLoopMonitor.h"
 #include <QDir>
 #include <QDebug>
 #include <QApplication>
@@ -8,6 +12,7 @@
 #include <QIODevice>
 
 DatabaseManager* DatabaseManager::instance = nullptr;
+const int DatabaseManager::DEFAULT_THUMBNAIL_INTERVAL = 60;
 
 DatabaseManager::DatabaseManager(QObject *parent)
     : QObject(parent)
@@ -29,17 +34,25 @@ DatabaseManager* DatabaseManager::getInstance()
 
 bool DatabaseManager::initialize()
 {
+    TRACE_SCOPE("DatabaseManager::initialize", "db");
     QString dbPath = getDatabasePath();
 
-    
     // Create directory if it doesn't exist
-    QDir().mkpath(QFileInfo(dbPath).absolutePath());
+    if (dbPath != ":memory:") {
+        QDir().mkpath(QFileInfo(dbPath).absolutePath());
+    }
     
-    database = QSqlDatabase::addDatabase("QSQLITE");
+    // Re-initializing (e.g. after setDatabasePath) reuses the default connection
+    close();
+    if (QSqlDatabase::contains(QSqlDatabase::defaultConnection)) {
+        database = QSqlDatabase::database(QSqlDatabase::defaultConnection, false);
+    } else {
+        database = QSqlDatabase::addDatabase("QSQLITE");
+    }
     database.setDatabaseName(dbPath);
     
     if (!database.open()) {
-        qDebug() << "Failed to open database:" << database.lastError().text();
+        LOG_WARNING("db") << "Failed to open database:" << database.lastError().text();
         return false;
     }
     
@@ -53,8 +66,22 @@ void DatabaseManager::close()
     }
 }
 
+void DatabaseManager::setDatabasePath(const QString& path)
+{
+    m_databasePath = path;
+}
+
 QString DatabaseManager::getDatabasePath()
 {
+    if (!m_databasePath.isEmpty()) {
+        return m_databasePath;
+    }
+
+    QString environmentPath = qEnvironmentVariable("BSS_DB_PATH");
+    if (!environmentPath.isEmpty()) {
+        return environmentPath;
+    }
+
     QString executableDir = QCoreApplication::applicationDirPath();
     if (executableDir.isEmpty()) {
         executableDir = QDir::currentPath();
@@ -77,6 +104,7 @@ bool DatabaseManager::createTables()
 
 bool DatabaseManager::createUsersTable()
 {
+    TRACE_SCOPE("DatabaseManager::createUsersTable", "db");
     QSqlQuery query(database);
     QString sql = R"(
         CREATE TABLE IF NOT EXISTS users (
@@ -89,7 +117,7 @@ bool DatabaseManager::createUsersTable()
     )";
     
     if (!query.exec(sql)) {
-        qDebug() << "Failed to create users table:" << query.lastError().text();
+        LOG_WARNING("db") << "Failed to create users table:" << query.lastError().text();
         return false;
     }
     
@@ -98,6 +126,7 @@ bool DatabaseManager::createUsersTable()
 
 bool DatabaseManager::createSubWindowsTable()
 {
+    TRACE_SCOPE("DatabaseManager::createSubWindowsTable", "db");
     QSqlQuery query(database);
     QString sql = R"(
         CREATE TABLE IF NOT EXISTS sub_windows (
@@ -106,20 +135,44 @@ bool DatabaseManager::createSubWindowsTable()
             url TEXT NOT NULL,
             created_at DATETIME DEFAULT CURRENT_TIMESTAMP,
             updated_at DATETIME DEFAULT CURRENT_TIMESTAMP,
-            is_enabled BOOLEAN DEFAULT 1
+            is_enabled BOOLEAN DEFAULT 1,
+            thumbnail_interval INTEGER NOT NULL DEFAULT 60,
+            refresh_interval INTEGER NOT NULL DEFAULT 0
         )
     )";
     
     if (!query.exec(sql)) {
-        qDebug() << "Failed to create sub_windows table:" << query.lastError().text();
+        LOG_WARNING("db") << "Failed to create sub_windows table:" << query.lastError().text();
         return false;
     }
     
+    // Columns added after the first release
+    const QList<QPair<QString, QString>> addedColumns = {
+        {"thumbnail_interval", "INTEGER NOT NULL DEFAULT 60"},  // Seconds between snapshots in thumbnail wall mode
+        {"refresh_interval", "INTEGER NOT NULL DEFAULT 0"},     // Seconds between automatic reloads, 0 = off
+    };
+    const QStringList columns = tableColumns("sub_windows");
+    for (const auto& column : addedColumns) {
+        if (!columns.contains(column.first) &&
+            !query.exec(QString("ALTER TABLE sub_windows ADD COLUMN %1 %2").arg(column.first, column.second))) {
+            LOG_WARNING("db") << "Failed to add sub_windows." << column.first << ":" << query.lastError().text();
+            return false;
+        }
+    }
+    
     return true;
 }
 
 bool DatabaseManager::createWindowConfigsTable()
 {
+    TRACE_SCOPE("DatabaseManager::createWindowConfigsTable", "db");
+    // Older databases stored geometry as a JSON text column; convert those first
+    if (tableColumns("window_configs").contains("geometry")) {
+        if (!migrateLegacyWindowConfigs()) {
+            return false;
+        }
+    }
+
     QSqlQuery query(database);
     QString sql = R"(
         CREATE TABLE IF NOT EXISTS window_configs (
@@ -128,22 +181,131 @@ bool DatabaseManager::createWindowConfigsTable()
             sub_id INTEGER DEFAULT -1,
             url TEXT,
             title TEXT,
-            geometry TEXT,
+            geom_x INTEGER NOT NULL DEFAULT 0,
+            geom_y INTEGER NOT NULL DEFAULT 0,
+            geom_width INTEGER NOT NULL DEFAULT 0,
+            geom_height INTEGER NOT NULL DEFAULT 0,
+            zoom_factor REAL NOT NULL DEFAULT 1.0,
+            scroll_x REAL NOT NULL DEFAULT 0,
+            scroll_y REAL NOT NULL DEFAULT 0,
+            lifecycle_state INTEGER NOT NULL DEFAULT 0,
             created_at DATETIME DEFAULT CURRENT_TIMESTAMP,
             updated_at DATETIME DEFAULT CURRENT_TIMESTAMP
         )
     )";
     
     if (!query.exec(sql)) {
-        qDebug() << "Failed to create window_configs table:" << query.lastError().text();
+        LOG_WARNING("db") << "Failed to create window_configs table:" << query.lastError().text();
+        return false;
+    }
+
+    if (!query.exec("CREATE INDEX IF NOT EXISTS idx_window_configs_sub_id ON window_configs (sub_id)")) {
+        LOG_WARNING("db") << "Failed to create window_configs sub_id index:" << query.lastError().text();
         return false;
     }
     
     return true;
 }
 
+QStringList DatabaseManager::tableColumns(const QString& table)
+{
+    QStringList columns;
+    QSqlQuery query(database);
+    if (query.exec(QString("PRAGMA table_info(%1)").arg(table))) {
+        while (query.next()) {
+            columns.append(query.value(1).toString());
+        }
+    }
+    return columns;
+}
+
+bool DatabaseManager::migrateLegacyWindowConfigs()
+{
+    LOG_DEBUG("db") << "DatabaseManager: Migrating window_configs from JSON geometry to typed columns";
+
+    if (!database.transaction()) {
+        LOG_WARNING("db") << "Failed to start window_configs migration:" << database.lastError().text();
+        return false;
+    }
+
+    QSqlQuery query(database);
+    if (!query.exec("ALTER TABLE window_configs RENAME TO window_configs_legacy")) {
+        LOG_WARNING("db") << "Failed to rename legacy window_configs:" << query.lastError().text();
+        database.rollback();
+        return false;
+    }
+
+    if (!query.exec(R"(
+        CREATE TABLE window_configs (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            window_id INTEGER UNIQUE NOT NULL,
+            sub_id INTEGER DEFAULT -1,
+            url TEXT,
+            title TEXT,
+            geom_x INTEGER NOT NULL DEFAULT 0,
+            geom_y INTEGER NOT NULL DEFAULT 0,
+            geom_width INTEGER NOT NULL DEFAULT 0,
+            geom_height INTEGER NOT NULL DEFAULT 0,
+            zoom_factor REAL NOT NULL DEFAULT 1.0,
+            scroll_x REAL NOT NULL DEFAULT 0,
+            scroll_y REAL NOT NULL DEFAULT 0,
+            lifecycle_state INTEGER NOT NULL DEFAULT 0,
+            created_at DATETIME DEFAULT CURRENT_TIMESTAMP,
+            updated_at DATETIME DEFAULT CURRENT_TIMESTAMP
+        )
+    )")) {
+        LOG_WARNING("db") << "Failed to create migrated window_configs:" << query.lastError().text();
+        database.rollback();
+        return false;
+    }
+
+    // The JSON is parsed exactly once here; every later read is column based
+    QSqlQuery insert(database);
+    insert.prepare(R"(
+        INSERT INTO window_configs (window_id, sub_id, url, title, geom_x, geom_y, geom_width, geom_height,
+                                    created_at, updated_at)
+        VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
+    )");
+
+    if (!query.exec("SELECT window_id, sub_id, url, title, geometry, created_at, updated_at FROM window_configs_legacy")) {
+        LOG_WARNING("db") << "Failed to read legacy window_configs:" << query.lastError().text();
+        database.rollback();
+        return false;
+    }
+
+    while (query.next()) {
+        QJsonObject geometry = QJsonDocument::fromJson(query.value(4).toByteArray()).object();
+
+        insert.addBindValue(query.value(0).toInt());
+        insert.addBindValue(query.value(1).isNull() ? -1 : query.value(1).toInt());
+        insert.addBindValue(query.value(2).toString());
+        insert.addBindValue(query.value(3).toString());
+        insert.addBindValue(geometry.value("x").toInt());
+        insert.addBindValue(geometry.value("y").toInt());
+        insert.addBindValue(geometry.value("width").toInt());
+        insert.addBindValue(geometry.value("height").toInt());
+        insert.addBindValue(query.value(5));
+        insert.addBindValue(query.value(6));
+
+        if (!insert.exec()) {
+            LOG_WARNING("db") << "Failed to migrate window_config row:" << insert.lastError().text();
+            database.rollback();
+            return false;
+        }
+    }
+
+    if (!query.exec("DROP TABLE window_configs_legacy")) {
+        LOG_WARNING("db") << "Failed to drop legacy window_configs:" << query.lastError().text();
+        database.rollback();
+        return false;
+    }
+
+    return database.commit();
+}
+
 bool DatabaseManager::createHistoryTable()
 {
+    TRACE_SCOPE("DatabaseManager::createHistoryTable", "db");
     QSqlQuery query(database);
     QString sql = R"(
         CREATE TABLE IF NOT EXISTS history (
@@ -156,7 +318,7 @@ bool DatabaseManager::createHistoryTable()
     )";
     
     if (!query.exec(sql)) {
-        qDebug() << "Failed to create history table:" << query.lastError().text();
+        LOG_WARNING("db") << "Failed to create history table:" << query.lastError().text();
         return false;
     }
     
@@ -165,6 +327,7 @@ bool DatabaseManager::createHistoryTable()
 
 bool DatabaseManager::createBookmarksTable()
 {
+    TRACE_SCOPE("DatabaseManager::createBookmarksTable", "db");
     QSqlQuery query(database);
     QString sql = R"(
         CREATE TABLE IF NOT EXISTS bookmarks (
@@ -177,7 +340,7 @@ bool DatabaseManager::createBookmarksTable()
     )";
     
     if (!query.exec(sql)) {
-        qDebug() << "Failed to create bookmarks table:" << query.lastError().text();
+        LOG_WARNING("db") << "Failed to create bookmarks table:" << query.lastError().text();
         return false;
     }
     
@@ -186,6 +349,7 @@ bool DatabaseManager::createBookmarksTable()
 
 bool DatabaseManager::createAppSettingsTable()
 {
+    TRACE_SCOPE("DatabaseManager::createAppSettingsTable", "db");
     QSqlQuery query(database);
     QString sql = R"(
         CREATE TABLE IF NOT EXISTS app_settings (
@@ -195,7 +359,7 @@ bool DatabaseManager::createAppSettingsTable()
     )";
 
     if (!query.exec(sql)) {
-        qDebug() << "Failed to create app_settings table:" << query.lastError().text();
+        LOG_WARNING("db") << "Failed to create app_settings table:" << query.lastError().text();
         return false;
     }
 
@@ -204,6 +368,7 @@ bool DatabaseManager::createAppSettingsTable()
 
 bool DatabaseManager::createUserSessionsTable()
 {
+    TRACE_SCOPE("DatabaseManager::createUserSessionsTable", "db");
     QSqlQuery query(database);
     QString sql = R"(
         CREATE TABLE IF NOT EXISTS user_sessions (
@@ -215,7 +380,7 @@ bool DatabaseManager::createUserSessionsTable()
     )";
 
     if (!query.exec(sql)) {
-        qDebug() << "Failed to create user_sessions table:" << query.lastError().text();
+        LOG_WARNING("db") << "Failed to create user_sessions table:" << query.lastError().text();
         return false;
     }
 
@@ -227,7 +392,7 @@ QByteArray DatabaseManager::serializeVariant(const QVariant& value) const
     QByteArray buffer;
     QBuffer device(&buffer);
     if (!device.open(QIODevice::WriteOnly)) {
-        qWarning() << "Failed to open buffer for writing app setting";
+        LOG_WARNING("db") << "Failed to open buffer for writing app setting";
         return QByteArray();
     }
 
@@ -247,7 +412,7 @@ QVariant DatabaseManager::deserializeVariant(const QByteArray& data, const QVari
     QBuffer device;
     device.setData(data);
     if (!device.open(QIODevice::ReadOnly)) {
-        qWarning() << "Failed to open buffer for reading app setting";
+        LOG_WARNING("db") << "Failed to open buffer for reading app setting";
         return defaultValue;
     }
 
@@ -282,7 +447,7 @@ bool DatabaseManager::createUser(const QString& username, const QString& passwor
     query.addBindValue(hashPassword(password));
     
     if (!query.exec()) {
-        qDebug() << "Failed to create user:" << query.lastError().text();
+        LOG_WARNING("db") << "Failed to create user:" << query.lastError().text();
         return false;
     }
     
@@ -339,6 +504,8 @@ bool DatabaseManager::isUserExists(const QString& username)
 
 bool DatabaseManager::saveUserSession(const QString& username, bool remember)
 {
+    ScopedLatency latency("bss_db_write_seconds", MetricsRegistry::label("op", "save_user_session"));
+    STALL_SCOPE("DatabaseManager::saveUserSession");
     QSqlQuery query(database);
     query.prepare(R"(
         INSERT INTO user_sessions (id, username, remember, last_active)
@@ -352,7 +519,7 @@ bool DatabaseManager::saveUserSession(const QString& username, bool remember)
     query.addBindValue(remember ? 1 : 0);
 
     if (!query.exec()) {
-        qDebug() << "Failed to save user session:" << query.lastError().text();
+        LOG_WARNING("db") << "Failed to save user session:" << query.lastError().text();
         return false;
     }
 
@@ -384,7 +551,7 @@ bool DatabaseManager::loadUserSession(QString& username, bool& remember)
     }
 
     if (!timestamp.isValid()) {
-        qDebug() << "loadUserSession: Invalid session timestamp, clearing session";
+        LOG_DEBUG("db") << "loadUserSession: Invalid session timestamp, clearing session";
         clearUserSession();
         username.clear();
         remember = false;
@@ -407,49 +574,82 @@ void DatabaseManager::clearUserSession()
     query.prepare("DELETE FROM user_sessions WHERE id = 1");
 
     if (!query.exec()) {
-        qDebug() << "Failed to clear user session:" << query.lastError().text();
+        LOG_WARNING("db") << "Failed to clear user session:" << query.lastError().text();
     }
 }
 
-bool DatabaseManager::saveWindowConfig(int windowId, int subId, const QString& url, const QString& title,
-                                      const QJsonObject& geometry)
+bool DatabaseManager::saveWindowConfig(const WindowConfig& config)
 {
-
+    ScopedLatency latency("bss_db_write_seconds", MetricsRegistry::label("op", "save_window_config"));
+    STALL_SCOPE("DatabaseManager::saveWindowConfig");
     QSqlQuery query(database);
     query.prepare(R"(
-        INSERT OR REPLACE INTO window_configs (window_id, sub_id, url, title, geometry, updated_at)
-        VALUES (?, ?, ?, ?, ?, CURRENT_TIMESTAMP)
+        INSERT INTO window_configs (window_id, sub_id, url, title, geom_x, geom_y, geom_width, geom_height,
+                                    zoom_factor, scroll_x, scroll_y, lifecycle_state, updated_at)
+        VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, CURRENT_TIMESTAMP)
+        ON CONFLICT(window_id) DO UPDATE SET
+            sub_id = excluded.sub_id,
+            url = excluded.url,
+            title = excluded.title,
+            geom_x = excluded.geom_x,
+            geom_y = excluded.geom_y,
+            geom_width = excluded.geom_width,
+            geom_height = excluded.geom_height,
+            zoom_factor = excluded.zoom_factor,
+            scroll_x = excluded.scroll_x,
+            scroll_y = excluded.scroll_y,
+            lifecycle_state = excluded.lifecycle_state,
+            updated_at = excluded.updated_at
     )");
-    query.addBindValue(windowId);
-    query.addBindValue(subId);
-    query.addBindValue(url);
-    query.addBindValue(title);
-    query.addBindValue(QJsonDocument(geometry).toJson());
+    query.addBindValue(config.windowId);
+    query.addBindValue(config.subId);
+    query.addBindValue(config.url);
+    query.addBindValue(config.title);
+    query.addBindValue(config.geometry.x());
+    query.addBindValue(config.geometry.y());
+    query.addBindValue(config.geometry.width());
+    query.addBindValue(config.geometry.height());
+    query.addBindValue(config.zoomFactor);
+    query.addBindValue(config.scrollPosition.x());
+    query.addBindValue(config.scrollPosition.y());
+    query.addBindValue(config.lifecycleState);
 
     bool success = query.exec();
     if (!success) {
-        qDebug() << "DatabaseManager::saveWindowConfig: Failed to save window config:" << query.lastError().text();
-    } else {
+        LOG_WARNING("db") << "DatabaseManager::saveWindowConfig: Failed to save window config:" << query.lastError().text();
     }
 
     return success;
 }
 
-QJsonObject DatabaseManager::loadWindowConfig(int windowId)
+WindowConfig DatabaseManager::loadWindowConfig(int windowId)
 {
+    TRACE_SCOPE_ARG("DatabaseManager::loadWindowConfig", "db", windowId);
+    STALL_SCOPE("DatabaseManager::loadWindowConfig");
+    // One indexed row; the sub-window URL is joined in so callers need no second lookup
     QSqlQuery query(database);
-    query.prepare("SELECT url, title, geometry FROM window_configs WHERE window_id = ?");
+    query.prepare(R"(
+        SELECT wc.window_id, wc.sub_id, wc.url, wc.title,
+               wc.geom_x, wc.geom_y, wc.geom_width, wc.geom_height,
+               wc.zoom_factor, wc.scroll_x, wc.scroll_y, wc.lifecycle_state, sw.url
+        FROM window_configs wc
+        LEFT JOIN sub_windows sw ON sw.id = wc.sub_id
+        WHERE wc.window_id = ?
+    )");
     query.addBindValue(windowId);
     
-    QJsonObject config;
+    WindowConfig config;
     if (query.exec() && query.next()) {
-        config["url"] = query.value(0).toString();
-        config["title"] = query.value(1).toString();
-        
-        QJsonDocument doc = QJsonDocument::fromJson(query.value(2).toByteArray());
-        if (doc.isObject()) {
-            config["geometry"] = doc.object();
-        }
+        config.windowId = query.value(0).toInt();
+        config.subId = query.value(1).toInt();
+        config.url = query.value(2).toString();
+        config.title = query.value(3).toString();
+        config.geometry = QRect(query.value(4).toInt(), query.value(5).toInt(),
+                                query.value(6).toInt(), query.value(7).toInt());
+        config.zoomFactor = query.value(8).toDouble();
+        config.scrollPosition = QPointF(query.value(9).toDouble(), query.value(10).toDouble());
+        config.lifecycleState = query.value(11).toInt();
+        config.homeUrl = query.value(12).toString();
     }
     
     return config;
@@ -457,6 +657,8 @@ QJsonObject DatabaseManager::loadWindowConfig(int windowId)
 
 bool DatabaseManager::deleteWindowConfig(int windowId)
 {
+    ScopedLatency latency("bss_db_write_seconds", MetricsRegistry::label("op", "delete_window_config"));
+    STALL_SCOPE("DatabaseManager::deleteWindowConfig");
     QSqlQuery query(database);
     query.prepare("DELETE FROM window_configs WHERE window_id = ?");
     query.addBindValue(windowId);
@@ -464,23 +666,28 @@ bool DatabaseManager::deleteWindowConfig(int windowId)
     return query.exec();
 }
 
-QList<QJsonObject> DatabaseManager::getAllWindowConfigs()
+QList<WindowConfig> DatabaseManager::getAllWindowConfigs()
 {
-    QList<QJsonObject> configs;
+    QList<WindowConfig> configs;
     QSqlQuery query(database);
-    query.prepare("SELECT window_id, url, title, geometry FROM window_configs ORDER BY window_id");
+    query.prepare(R"(
+        SELECT window_id, sub_id, url, title, geom_x, geom_y, geom_width, geom_height,
+               zoom_factor, scroll_x, scroll_y, lifecycle_state
+        FROM window_configs ORDER BY window_id
+    )");
     
     if (query.exec()) {
         while (query.next()) {
-            QJsonObject config;
-            config["window_id"] = query.value(0).toInt();
-            config["url"] = query.value(1).toString();
-            config["title"] = query.value(2).toString();
-            
-            QJsonDocument doc = QJsonDocument::fromJson(query.value(3).toByteArray());
-            if (doc.isObject()) {
-                config["geometry"] = doc.object();
-            }
+            WindowConfig config;
+            config.windowId = query.value(0).toInt();
+            config.subId = query.value(1).toInt();
+            config.url = query.value(2).toString();
+            config.title = query.value(3).toString();
+            config.geometry = QRect(query.value(4).toInt(), query.value(5).toInt(),
+                                    query.value(6).toInt(), query.value(7).toInt());
+            config.zoomFactor = query.value(8).toDouble();
+            config.scrollPosition = QPointF(query.value(9).toDouble(), query.value(10).toDouble());
+            config.lifecycleState = query.value(11).toInt();
             
             configs.append(config);
         }
@@ -491,6 +698,8 @@ QList<QJsonObject> DatabaseManager::getAllWindowConfigs()
 
 bool DatabaseManager::addHistoryRecord(const QString& url, const QString& title, int windowId)
 {
+    ScopedLatency latency("bss_db_write_seconds", MetricsRegistry::label("op", "add_history_record"));
+    STALL_SCOPE("DatabaseManager::addHistoryRecord");
     QSqlQuery query(database);
     query.prepare("INSERT INTO history (url, title, window_id) VALUES (?, ?, ?)");
     query.addBindValue(url);
@@ -530,6 +739,8 @@ bool DatabaseManager::clearHistory()
 
 bool DatabaseManager::addBookmark(const QString& url, const QString& title, const QString& folder)
 {
+    ScopedLatency latency("bss_db_write_seconds", MetricsRegistry::label("op", "add_bookmark"));
+    STALL_SCOPE("DatabaseManager::addBookmark");
     QSqlQuery query(database);
     query.prepare("INSERT INTO bookmarks (url, title, folder) VALUES (?, ?, ?)");
     query.addBindValue(url);
@@ -588,6 +799,8 @@ bool DatabaseManager::updateBookmark(const QString& url, const QString& newTitle
 
 bool DatabaseManager::setAppSetting(const QString& key, const QVariant& value)
 {
+    ScopedLatency latency("bss_db_write_seconds", MetricsRegistry::label("op", "set_app_setting"));
+    STALL_SCOPE("DatabaseManager::setAppSetting");
     QByteArray serializedValue = serializeVariant(value);
 
     QSqlQuery query(database);
@@ -600,7 +813,7 @@ bool DatabaseManager::setAppSetting(const QString& key, const QVariant& value)
     query.addBindValue(serializedValue);
 
     if (!query.exec()) {
-        qDebug() << "Failed to persist app setting for key" << key << ":" << query.lastError().text();
+        LOG_WARNING("db") << "Failed to persist app setting for key" << key << ":" << query.lastError().text();
         return false;
     }
 
@@ -609,6 +822,7 @@ bool DatabaseManager::setAppSetting(const QString& key, const QVariant& value)
 
 QVariant DatabaseManager::getAppSetting(const QString& key, const QVariant& defaultValue)
 {
+    STALL_SCOPE("DatabaseManager::getAppSetting");
     QSqlQuery query(database);
     query.prepare("SELECT value FROM app_settings WHERE key = ?");
     query.addBindValue(key);
@@ -628,7 +842,7 @@ bool DatabaseManager::removeAppSetting(const QString& key)
     query.addBindValue(key);
 
     if (!query.exec()) {
-        qDebug() << "Failed to remove app setting for key" << key << ":" << query.lastError().text();
+        LOG_WARNING("db") << "Failed to remove app setting for key" << key << ":" << query.lastError().text();
         return false;
     }
 
@@ -638,13 +852,15 @@ bool DatabaseManager::removeAppSetting(const QString& key)
 // SubWindow management methods
 bool DatabaseManager::addSubWindow(const QString& name, const QString& url)
 {
+    ScopedLatency latency("bss_db_write_seconds", MetricsRegistry::label("op", "add_sub_window"));
+    STALL_SCOPE("DatabaseManager::addSubWindow");
     QSqlQuery query(database);
     query.prepare("INSERT INTO sub_windows (name, url) VALUES (?, ?)");
     query.addBindValue(name);
     query.addBindValue(url);
     
     if (!query.exec()) {
-        qDebug() << "Failed to add sub window:" << query.lastError().text();
+        LOG_WARNING("db") << "Failed to add sub window:" << query.lastError().text();
         return false;
     }
     
@@ -653,6 +869,8 @@ bool DatabaseManager::addSubWindow(const QString& name, const QString& url)
 
 bool DatabaseManager::updateSubWindow(int subWindowId, const QString& name, const QString& url)
 {
+    ScopedLatency latency("bss_db_write_seconds", MetricsRegistry::label("op", "update_sub_window"));
+    STALL_SCOPE("DatabaseManager::updateSubWindow");
     QSqlQuery query(database);
     query.prepare("UPDATE sub_windows SET name = ?, url = ?, updated_at = CURRENT_TIMESTAMP WHERE id = ?");
     query.addBindValue(name);
@@ -660,7 +878,7 @@ bool DatabaseManager::updateSubWindow(int subWindowId, const QString& name, cons
     query.addBindValue(subWindowId);
     
     if (!query.exec()) {
-        qDebug() << "Failed to update sub window:" << query.lastError().text();
+        LOG_WARNING("db") << "Failed to update sub window:" << query.lastError().text();
         return false;
     }
     
@@ -669,12 +887,14 @@ bool DatabaseManager::updateSubWindow(int subWindowId, const QString& name, cons
 
 bool DatabaseManager::deleteSubWindow(int subWindowId)
 {
+    ScopedLatency latency("bss_db_write_seconds", MetricsRegistry::label("op", "delete_sub_window"));
+    STALL_SCOPE("DatabaseManager::deleteSubWindow");
     QSqlQuery query(database);
     query.prepare("DELETE FROM sub_windows WHERE id = ?");
     query.addBindValue(subWindowId);
     
     if (!query.exec()) {
-        qDebug() << "Failed to delete sub window:" << query.lastError().text();
+        LOG_WARNING("db") << "Failed to delete sub window:" << query.lastError().text();
         return false;
     }
     
@@ -683,9 +903,10 @@ bool DatabaseManager::deleteSubWindow(int subWindowId)
 
 QList<QJsonObject> DatabaseManager::getAllSubWindows()
 {
+    STALL_SCOPE("DatabaseManager::getAllSubWindows");
     QList<QJsonObject> subWindows;
     QSqlQuery query(database);
-    query.prepare("SELECT id, name, url, created_at, updated_at, is_enabled FROM sub_windows ORDER BY created_at DESC");
+    query.prepare("SELECT id, name, url, created_at, updated_at, is_enabled, thumbnail_interval, refresh_interval FROM sub_windows ORDER BY created_at DESC");
     
     
     if (query.exec()) {
@@ -697,11 +918,13 @@ QList<QJsonObject> DatabaseManager::getAllSubWindows()
             subWindow["created_at"] = query.value(3).toString();
             subWindow["updated_at"] = query.value(4).toString();
             subWindow["is_enabled"] = query.value(5).toBool();
+            subWindow["thumbnail_interval"] = query.value(6).toInt();
+            subWindow["refresh_interval"] = query.value(7).toInt();
             
             subWindows.append(subWindow);
         }
     } else {
-        qDebug() << "DatabaseManager::getAllSubWindows: Query failed:" << query.lastError().text();
+        LOG_WARNING("db") << "DatabaseManager::getAllSubWindows: Query failed:" << query.lastError().text();
     }
     
     return subWindows;
@@ -711,7 +934,7 @@ QJsonObject DatabaseManager::getSubWindow(int subWindowId)
 {
     QJsonObject subWindow;
     QSqlQuery query(database);
-    query.prepare("SELECT id, name, url, created_at, updated_at, is_enabled FROM sub_windows WHERE id = ?");
+    query.prepare("SELECT id, name, url, created_at, updated_at, is_enabled, thumbnail_interval, refresh_interval FROM sub_windows WHERE id = ?");
     query.addBindValue(subWindowId);
     
     if (query.exec() && query.next()) {
@@ -721,19 +944,166 @@ QJsonObject DatabaseManager::getSubWindow(int subWindowId)
         subWindow["created_at"] = query.value(3).toString();
         subWindow["updated_at"] = query.value(4).toString();
         subWindow["is_enabled"] = query.value(5).toBool();
+        subWindow["thumbnail_interval"] = query.value(6).toInt();
+        subWindow["refresh_interval"] = query.value(7).toInt();
     }
     
     return subWindow;
 }
 
+bool DatabaseManager::applySubWindowChanges(const SubWindowChangeSet& changes, SubWindowChangeResult* result)
+{
+    ScopedLatency latency("bss_db_write_seconds", MetricsRegistry::label("op", "apply_sub_window_changes"));
+    STALL_SCOPE("DatabaseManager::applySubWindowChanges");
+    if (changes.isEmpty()) {
+        return true;
+    }
+
+    if (!database.transaction()) {
+        LOG_WARNING("db") << "Failed to start sub window change set:" << database.lastError().text();
+        return false;
+    }
+
+    SubWindowChangeResult applied;
+
+    // Statements are prepared once and re-bound for every row of the batch
+    QSqlQuery deleteSubWindowQuery(database);
+    deleteSubWindowQuery.prepare("DELETE FROM sub_windows WHERE id = ?");
+    QSqlQuery deleteConfigQuery(database);
+    deleteConfigQuery.prepare("DELETE FROM window_configs WHERE sub_id = ?");
+
+    for (int subWindowId : changes.deleted) {
+        deleteSubWindowQuery.addBindValue(subWindowId);
+        deleteConfigQuery.addBindValue(subWindowId);
+        if (!deleteSubWindowQuery.exec() || !deleteConfigQuery.exec()) {
+            LOG_WARNING("db") << "Failed to delete sub window" << subWindowId << "in change set:"
+                     << deleteSubWindowQuery.lastError().text() << deleteConfigQuery.lastError().text();
+            database.rollback();
+            return false;
+        }
+        if (deleteSubWindowQuery.numRowsAffected() > 0) {
+            applied.deleted.append(subWindowId);
+        }
+    }
+
+    QSqlQuery updateQuery(database);
+    updateQuery.prepare(R"(
+        UPDATE sub_windows
+        SET name = ?, url = ?, thumbnail_interval = COALESCE(?, thumbnail_interval),
+            refresh_interval = COALESCE(?, refresh_interval), updated_at = CURRENT_TIMESTAMP
+        WHERE id = ?
+    )");
+    // The tile's saved URL and title follow the edit; layout state in the row is kept
+    QSqlQuery updateConfigQuery(database);
+    updateConfigQuery.prepare(R"(
+        INSERT INTO window_configs (window_id, sub_id, url, title, geom_width, geom_height)
+        VALUES (?, ?, ?, ?, ?, ?)
+        ON CONFLICT(window_id) DO UPDATE SET url = excluded.url, title = excluded.title,
+            updated_at = CURRENT_TIMESTAMP
+    )");
+
+    for (const QJsonObject& subWindow : changes.updated) {
+        updateQuery.addBindValue(subWindow["name"].toString());
+        updateQuery.addBindValue(subWindow["url"].toString());
+        // Edits that do not carry an interval keep the stored one
+        updateQuery.addBindValue(subWindow.contains("thumbnail_interval")
+            ? QVariant(subWindow["thumbnail_interval"].toInt()) : QVariant(QMetaType(QMetaType::Int)));
+        updateQuery.addBindValue(subWindow.contains("refresh_interval")
+            ? QVariant(subWindow["refresh_interval"].toInt()) : QVariant(QMetaType(QMetaType::Int)));
+        updateQuery.addBindValue(subWindow["id"].toInt());
+        if (!updateQuery.exec()) {
+            LOG_WARNING("db") << "Failed to update sub window in change set:" << updateQuery.lastError().text();
+            database.rollback();
+            return false;
+        }
+        if (updateQuery.numRowsAffected() == 0) {
+            continue;  // Deleted meanwhile; no config to keep in step
+        }
+
+        updateConfigQuery.addBindValue(subWindow["id"].toInt());
+        updateConfigQuery.addBindValue(subWindow["id"].toInt());
+        updateConfigQuery.addBindValue(subWindow["url"].toString());
+        updateConfigQuery.addBindValue(subWindow["name"].toString());
+        updateConfigQuery.addBindValue(500);
+        updateConfigQuery.addBindValue(300);
+        if (!updateConfigQuery.exec()) {
+            LOG_WARNING("db") << "Failed to update window config in change set:" << updateConfigQuery.lastError().text();
+            database.rollback();
+            return false;
+        }
+        applied.updated.append(subWindow);
+    }
+
+    QSqlQuery insertQuery(database);
+    insertQuery.prepare("INSERT INTO sub_windows (name, url, thumbnail_interval, refresh_interval) VALUES (?, ?, ?, ?)");
+    QSqlQuery insertConfigQuery(database);
+    insertConfigQuery.prepare(R"(
+        INSERT INTO window_configs (window_id, sub_id, url, title, geom_width, geom_height)
+        VALUES (?, ?, ?, ?, ?, ?)
+        ON CONFLICT(window_id) DO NOTHING
+    )");
+
+    for (const QJsonObject& subWindow : changes.added) {
+        QString name = subWindow["name"].toString();
+        QString url = subWindow["url"].toString();
+        int thumbnailInterval = subWindow["thumbnail_interval"].toInt(DEFAULT_THUMBNAIL_INTERVAL);
+        int refreshInterval = subWindow["refresh_interval"].toInt(0);
+
+        insertQuery.addBindValue(name);
+        insertQuery.addBindValue(url);
+        insertQuery.addBindValue(thumbnailInterval);
+        insertQuery.addBindValue(refreshInterval);
+        if (!insertQuery.exec()) {
+            LOG_WARNING("db") << "Failed to add sub window in change set:" << insertQuery.lastError().text();
+            database.rollback();
+            return false;
+        }
+
+        // window_configs uses the sub-window ID as window_id (1:1 mapping)
+        int subWindowId = insertQuery.lastInsertId().toInt();
+        insertConfigQuery.addBindValue(subWindowId);
+        insertConfigQuery.addBindValue(subWindowId);
+        insertConfigQuery.addBindValue(url);
+        insertConfigQuery.addBindValue(name);
+        insertConfigQuery.addBindValue(500);
+        insertConfigQuery.addBindValue(300);
+        if (!insertConfigQuery.exec()) {
+            LOG_WARNING("db") << "Failed to add window config in change set:" << insertConfigQuery.lastError().text();
+            database.rollback();
+            return false;
+        }
+
+        QJsonObject added;
+        added["id"] = subWindowId;
+        added["name"] = name;
+        added["url"] = url;
+        added["thumbnail_interval"] = thumbnailInterval;
+        added["refresh_interval"] = refreshInterval;
+        applied.added.append(added);
+    }
+
+    if (!database.commit()) {
+        LOG_WARNING("db") << "Failed to commit sub window change set:" << database.lastError().text();
+        database.rollback();
+        return false;
+    }
+
+    if (result) {
+        *result = applied;
+    }
+    return true;
+}
+
 bool DatabaseManager::deleteWindowConfigsBySubId(int subId)
 {
+    ScopedLatency latency("bss_db_write_seconds", MetricsRegistry::label("op", "delete_window_configs_by_sub_id"));
+    STALL_SCOPE("DatabaseManager::deleteWindowConfigsBySubId");
     QSqlQuery query(database);
     query.prepare("DELETE FROM window_configs WHERE sub_id = ?");
     query.addBindValue(subId);
     
     if (!query.exec()) {
-        qDebug() << "Failed to delete window configs by subId:" << query.lastError().text();
+        LOG_WARNING("db") << "Failed to delete window configs by subId:" << query.lastError().text();
         return false;
     }
     
@@ -0,0 +1,231 @@
+#include "EventLoopMonitor.h"
+#include "Log.h"
+#include "MetricsRegistry.h"
+#include "ProcStats.h"
+#include <QEvent>
+#include <QMetaEnum>
+#include <QStringList>
+#include <QThread>
+#include <algorithm>
+#include <chrono>
+
+EventLoopMonitor* EventLoopMonitor::instance = nullptr;
+const int EventLoopMonitor::HEARTBEAT_INTERVAL_MS = 20;
+const int EventLoopMonitor::STALL_THRESHOLD_MS = 50;
+
+std::atomic<const char*> EventLoopMonitor::s_receiverClass{nullptr};
+std::atomic<int> EventLoopMonitor::s_eventType{0};
+std::atomic<const char*> EventLoopMonitor::s_scopes[MAX_SCOPE_DEPTH];
+std::atomic<int> EventLoopMonitor::s_scopeDepth{0};
+
+EventLoopMonitor* EventLoopMonitor::getInstance()
+{
+    if (!instance) {
+        instance = new EventLoopMonitor();
+    }
+    return instance;
+}
+
+EventLoopMonitor::EventLoopMonitor(QObject* parent)
+    : QObject(parent)
+    , m_running(false)
+    , m_outstandingSentNs(0)
+    , m_lastLagNs(0)
+{
+    MetricsRegistry::getInstance()->defineCounter("bss_event_loop_stalls",
+        "GUI thread stalls above the threshold, by the handler that was running.");
+}
+
+EventLoopMonitor::~EventLoopMonitor()
+{
+    stop();
+}
+
+bool EventLoopMonitor::isGuiThread()
+{
+    return QCoreApplication::instance() && QThread::currentThread() == QCoreApplication::instance()->thread();
+}
+
+void EventLoopMonitor::start()
+{
+    if (m_running.exchange(true)) {
+        return;
+    }
+    m_watchdog = std::thread(&EventLoopMonitor::watchdogLoop, this);
+}
+
+void EventLoopMonitor::stop()
+{
+    if (!m_running.exchange(false)) {
+        return;
+    }
+    if (m_watchdog.joinable()) {
+        m_watchdog.join();
+    }
+}
+
+bool EventLoopMonitor::isRunning() const
+{
+    return m_running.load();
+}
+
+void EventLoopMonitor::watchdogLoop()
+{
+    const auto sampleInterval = std::chrono::milliseconds(5);
+    const qint64 thresholdNs = STALL_THRESHOLD_MS * 1000000LL;
+
+    QHash<QString, int> stallSamples;
+    qint64 nextHeartbeatNs = 0;
+
+    while (m_running.load()) {
+        std::this_thread::sleep_for(sampleInterval);
+        const qint64 nowNs = ProcStats::monotonicNs();
+        const qint64 sentNs = m_outstandingSentNs.load();
+
+        if (sentNs == 0) {
+            // Previous heartbeat was handled; close the stall it may have ended
+            if (!stallSamples.isEmpty()) {
+                finishStall(stallSamples, m_lastLagNs.load());
+                stallSamples.clear();
+            }
+
+            if (nowNs >= nextHeartbeatNs) {
+                nextHeartbeatNs = nowNs + HEARTBEAT_INTERVAL_MS * 1000000LL;
+                m_outstandingSentNs.store(nowNs);
+                QMetaObject::invokeMethod(this, [this, nowNs]() { onHeartbeat(nowNs); }, Qt::QueuedConnection);
+            }
+        } else if (nowNs - sentNs > thresholdNs) {
+            // Stalled: sample what the GUI thread is busy with
+            ++stallSamples[currentHandler()];
+        }
+    }
+}
+
+void EventLoopMonitor::onHeartbeat(qint64 sentNs)
+{
+    const qint64 lagNs = ProcStats::monotonicNs() - sentNs;
+    m_lastLagNs.store(lagNs);
+    m_outstandingSentNs.store(0);
+    MetricsRegistry::getInstance()->observe("bss_event_loop_lag_seconds", QString(), lagNs / 1e9);
+}
+
+QString EventLoopMonitor::currentHandler() const
+{
+    const int depth = qBound(0, s_scopeDepth.load(), MAX_SCOPE_DEPTH);
+    if (depth > 0) {
+        if (const char* scope = s_scopes[depth - 1].load()) {
+            return QString::fromLatin1(scope);
+        }
+    }
+
+    const char* receiver = s_receiverClass.load();
+    if (!receiver) {
+        return QString("(idle or native)");
+    }
+
+    // Queued slot calls arrive as MetaCall events on the receiver
+    const int type = s_eventType.load();
+    const char* typeName = QMetaEnum::fromType<QEvent::Type>().valueToKey(type);
+    return QString("%1 / %2").arg(QString::fromLatin1(receiver),
+                                   typeName ? QString::fromLatin1(typeName) : QString::number(type));
+}
+
+void EventLoopMonitor::finishStall(const QHash<QString, int>& samples, qint64 durationNs)
+{
+    QString handler;
+    int best = -1;
+    for (auto it = samples.constBegin(); it != samples.constEnd(); ++it) {
+        if (it.value() > best) {
+            best = it.value();
+            handler = it.key();
+        }
+    }
+
+    {
+        QMutexLocker locker(&m_mutex);
+        Offender& offender = m_offenders[handler];
+        offender.handler = handler;
+        ++offender.stalls;
+        offender.totalNs += durationNs;
+        offender.maxNs = qMax(offender.maxNs, durationNs);
+    }
+
+    MetricsRegistry::getInstance()->increment("bss_event_loop_stalls", MetricsRegistry::label("handler", handler));
+    LOG_WARNING("event-loop") << "EventLoopMonitor: GUI thread stalled" << durationNs / 1000000 << "ms in" << handler;
+}
+
+QList<EventLoopMonitor::Offender> EventLoopMonitor::topOffenders(int count) const
+{
+    QList<Offender> offenders;
+    {
+        QMutexLocker locker(&m_mutex);
+        offenders = m_offenders.values();
+    }
+
+    std::sort(offenders.begin(), offenders.end(), [](const Offender& a, const Offender& b) {
+        return a.totalNs > b.totalNs;
+    });
+    return offenders.mid(0, count);
+}
+
+QString EventLoopMonitor::report(int count) const
+{
+    QStringList lines;
+    lines << QString("Event-loop stalls over %1 ms, by total time:").arg(STALL_THRESHOLD_MS);
+    for (const Offender& offender : topOffenders(count)) {
+        lines << QString("  %1 stalls, %2 ms total, %3 ms max  %4")
+                     .arg(offender.stalls, 4)
+                     .arg(offender.totalNs / 1000000, 6)
+                     .arg(offender.maxNs / 1000000, 5)
+                     .arg(offender.handler);
+    }
+    if (lines.size() == 1) {
+        lines << "  (none)";
+    }
+    return lines.join('\n');
+}
+
+void EventLoopMonitor::enterScope(const char* label)
+{
+    if (!isGuiThread()) {
+        return;
+    }
+    const int depth = s_scopeDepth.load(std::memory_order_relaxed);
+    if (depth < MAX_SCOPE_DEPTH) {
+        s_scopes[depth].store(label, std::memory_order_relaxed);
+    }
+    s_scopeDepth.store(depth + 1, std::memory_order_release);
+}
+
+void EventLoopMonitor::leaveScope()
+{
+    if (!isGuiThread()) {
+        return;
+    }
+    s_scopeDepth.store(qMax(0, s_scopeDepth.load(std::memory_order_relaxed) - 1), std::memory_order_release);
+}
+
+MonitoredApplication::MonitoredApplication(int& argc, char** argv)
+    : QApplication(argc, argv)
+{
+}
+
+bool MonitoredApplication::notify(QObject* receiver, QEvent* event)
+{
+    if (!EventLoopMonitor::isGuiThread()) {
+        return QApplication::notify(receiver, event);
+    }
+
+    // Innermost dispatch wins; the outer one is restored when it returns
+    const char* previousClass = EventLoopMonitor::s_receiverClass.load(std::memory_order_relaxed);
+    const int previousType = EventLoopMonitor::s_eventType.load(std::memory_order_relaxed);
+    EventLoopMonitor::s_receiverClass.store(receiver ? receiver->metaObject()->className() : nullptr,
+                                            std::memory_order_relaxed);
+    EventLoopMonitor::s_eventType.store(event ? static_cast<int>(event->type()) : 0, std::memory_order_relaxed);
+
+    bool result = QApplication::notify(receiver, event);
+
+    EventLoopMonitor::s_receiverClass.store(previousClass, std::memory_order_relaxed);
+    EventLoopMonitor::s_eventType.store(previousType, std::memory_order_relaxed);
+    return result;
+}
@@ -0,0 +1,335 @@
+#include "Log.h"
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QStandardPaths>
+#include <QStringList>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const int RING_SIZE = 1024;                       // Records per thread before dropping
+const qint64 MAX_FILE_BYTES = 5 * 1024 * 1024;
+const int MAX_ROTATED_FILES = 3;
+const int WRITER_IDLE_MS = 50;
+
+struct LogEntry
+{
+    qint64 wallMs = 0;
+    int level = 0;
+    const char* category = nullptr;
+    int threadId = 0;
+    QString message;
+};
+
+// Single producer (the owning thread), single consumer (the writer)
+struct LogRing
+{
+    LogEntry entries[RING_SIZE];
+    std::atomic<quint32> head{0};  // Next entry to read; written by the consumer
+    std::atomic<quint32> tail{0};  // Next entry to write; written by the producer
+    int threadId = 0;
+
+    bool push(LogEntry&& entry)
+    {
+        const quint32 t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) >= static_cast<quint32>(RING_SIZE)) {
+            return false;
+        }
+        entries[t % RING_SIZE] = std::move(entry);
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(LogEntry& entry)
+    {
+        const quint32 h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        entry = std::move(entries[h % RING_SIZE]);
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+};
+
+// Immutable once published; replaced wholesale when a level changes
+struct LevelConfig
+{
+    int defaultLevel = Log::Debug;
+    QHash<QByteArray, int> categories;
+};
+
+QMutex g_ringsMutex;                       // Only taken when a thread logs for the first time
+std::vector<LogRing*> g_rings;             // Never freed: a thread's ring outlives it until drained
+std::atomic<int> g_nextThreadId{1};
+std::atomic<const LevelConfig*> g_config{new LevelConfig()};
+std::atomic<quint64> g_dropped{0};
+std::atomic<bool> g_running{false};
+std::thread g_writer;
+QString g_filePath;
+QtMessageHandler g_previousHandler = nullptr;
+
+LogRing* threadRing()
+{
+    thread_local LogRing* ring = nullptr;
+    if (!ring) {
+        ring = new LogRing();
+        ring->threadId = g_nextThreadId.fetch_add(1);
+        QMutexLocker locker(&g_ringsMutex);
+        g_rings.push_back(ring);
+    }
+    return ring;
+}
+
+const char* levelName(int level)
+{
+    static const char* names[] = {"trace", "debug", "info", "warning", "error"};
+    return names[qBound(0, level, 4)];
+}
+
+int parseLevel(const QByteArray& name, int fallback)
+{
+    const QByteArray lower = name.trimmed().toLower();
+    for (int level = Log::Trace; level <= Log::Error; ++level) {
+        if (lower == levelName(level)) {
+            return level;
+        }
+    }
+    return fallback;
+}
+
+void rotate(QFile& file)
+{
+    file.close();
+    for (int i = MAX_ROTATED_FILES - 1; i >= 1; --i) {
+        QString older = QString("%1.%2").arg(g_filePath).arg(i + 1);
+        QString newer = QString("%1.%2").arg(g_filePath).arg(i);
+        QFile::remove(older);
+        QFile::rename(newer, older);
+    }
+    QFile::remove(g_filePath + ".1");
+    QFile::rename(g_filePath, g_filePath + ".1");
+    file.open(QIODevice::WriteOnly | QIODevice::Append);
+}
+
+// Moves every queued record to the file; returns whether anything was written
+bool drainOnce(QFile& file)
+{
+    std::vector<LogRing*> rings;
+    {
+        QMutexLocker locker(&g_ringsMutex);
+        rings = g_rings;
+    }
+
+    std::vector<LogEntry> batch;
+    LogEntry entry;
+    for (LogRing* ring : rings) {
+        while (ring->pop(entry)) {
+            entry.threadId = ring->threadId;
+            batch.push_back(std::move(entry));
+        }
+    }
+
+    static quint64 reportedDrops = 0;
+    const quint64 dropped = g_dropped.load();
+    if (batch.empty() && dropped == reportedDrops) {
+        return false;
+    }
+
+    std::stable_sort(batch.begin(), batch.end(), [](const LogEntry& a, const LogEntry& b) {
+        return a.wallMs < b.wallMs;
+    });
+
+    const bool mirrorAll = qEnvironmentVariableIntValue("BSS_LOG_STDERR") != 0;
+    QByteArray out;
+    for (const LogEntry& record : batch) {
+        QJsonObject line;
+        line["ts"] = QDateTime::fromMSecsSinceEpoch(record.wallMs).toString(Qt::ISODateWithMs);
+        line["level"] = levelName(record.level);
+        line["cat"] = QString::fromLatin1(record.category ? record.category : "default");
+        line["tid"] = record.threadId;
+        line["msg"] = record.message;
+        out += QJsonDocument(line).toJson(QJsonDocument::Compact) + '\n';
+
+        if (mirrorAll || record.level >= Log::Warning) {
+            fprintf(stderr, "%s [%s] %s\n", levelName(record.level), record.category ? record.category : "default",
+                    qPrintable(record.message));
+        }
+    }
+    if (dropped != reportedDrops) {
+        QJsonObject line;
+        line["ts"] = QDateTime::currentDateTime().toString(Qt::ISODateWithMs);
+        line["level"] = "warning";
+        line["cat"] = "log";
+        line["msg"] = QString("dropped %1 records (ring full)").arg(dropped - reportedDrops);
+        out += QJsonDocument(line).toJson(QJsonDocument::Compact) + '\n';
+        reportedDrops = dropped;
+    }
+
+    if (file.isOpen()) {
+        if (file.size() + out.size() > MAX_FILE_BYTES) {
+            rotate(file);
+        }
+        file.write(out);
+        file.flush();
+    }
+    return true;
+}
+
+void writerLoop()
+{
+    QFile file(g_filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        fprintf(stderr, "Log: cannot open %s, records go to stderr only\n", qPrintable(g_filePath));
+    }
+
+    while (g_running.load()) {
+        if (!drainOnce(file)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(WRITER_IDLE_MS));
+        }
+    }
+    while (drainOnce(file)) {
+    }
+}
+
+void qtMessageHandler(QtMsgType type, const QMessageLogContext& context, const QString& message)
+{
+    Log::Level level = Log::Debug;
+    switch (type) {
+        case QtDebugMsg:    level = Log::Debug; break;
+        case QtInfoMsg:     level = Log::Info; break;
+        case QtWarningMsg:  level = Log::Warning; break;
+        case QtCriticalMsg: level = Log::Error; break;
+        case QtFatalMsg:    level = Log::Error; break;
+    }
+
+    // Qt's own categories are kept ("qt.webengine..."); plain qDebug() lands in "default"
+    const char* category = context.category && strcmp(context.category, "default") != 0 ? context.category : "default";
+    if (static_cast<int>(level) >= BSS_LOG_MIN_LEVEL && Log::isEnabled(level, category)) {
+        QString copy = message;
+        Log::submit(level, category, std::move(copy));
+    }
+
+    if (type == QtFatalMsg) {
+        Log::shutdown();
+        if (g_previousHandler) {
+            g_previousHandler(type, context, message);
+        }
+        abort();
+    }
+}
+
+}
+
+void Log::install()
+{
+    if (g_running.exchange(true)) {
+        return;
+    }
+
+    // "info,layout=debug,db=warning"
+    LevelConfig* config = new LevelConfig();
+    for (const QByteArray& part : qgetenv("BSS_LOG").split(',')) {
+        if (part.trimmed().isEmpty()) {
+            continue;
+        }
+        int equals = part.indexOf('=');
+        if (equals < 0) {
+            config->defaultLevel = parseLevel(part, config->defaultLevel);
+        } else {
+            config->categories.insert(part.left(equals).trimmed(),
+                                      parseLevel(part.mid(equals + 1), config->defaultLevel));
+        }
+    }
+    g_config.store(config);
+
+    QString directory = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
+    if (directory.isEmpty()) {
+        directory = QDir::currentPath();
+    }
+    directory = QDir(directory).filePath("logs");
+    QDir().mkpath(directory);
+    g_filePath = QDir(directory).filePath("browser_split_screen.log");
+
+    g_writer = std::thread(writerLoop);
+    g_previousHandler = qInstallMessageHandler(qtMessageHandler);
+}
+
+void Log::shutdown()
+{
+    if (!g_running.exchange(false)) {
+        return;
+    }
+    qInstallMessageHandler(g_previousHandler);
+    if (g_writer.joinable() && g_writer.get_id() != std::this_thread::get_id()) {
+        g_writer.join();
+    }
+}
+
+bool Log::isEnabled(Level level, const char* category)
+{
+    const LevelConfig* config = g_config.load(std::memory_order_acquire);
+    if (!config->categories.isEmpty() && category) {
+        auto it = config->categories.constFind(QByteArray::fromRawData(category, static_cast<int>(strlen(category))));
+        if (it != config->categories.constEnd()) {
+            return level >= it.value();
+        }
+    }
+    return level >= config->defaultLevel;
+}
+
+void Log::setDefaultLevel(Level level)
+{
+    // Old configs are leaked on purpose: another thread may still be reading one
+    LevelConfig* config = new LevelConfig(*g_config.load());
+    config->defaultLevel = level;
+    g_config.store(config, std::memory_order_release);
+}
+
+void Log::setCategoryLevel(const QByteArray& category, Level level)
+{
+    LevelConfig* config = new LevelConfig(*g_config.load());
+    config->categories.insert(category, level);
+    g_config.store(config, std::memory_order_release);
+}
+
+void Log::submit(Level level, const char* category, QString&& message)
+{
+    // Before install() (or after shutdown()) there is no writer; fall back to stderr
+    if (!g_running.load(std::memory_order_relaxed)) {
+        fprintf(stderr, "%s [%s] %s\n", levelName(level), category ? category : "default", qPrintable(message));
+        return;
+    }
+
+    LogEntry entry;
+    entry.wallMs = QDateTime::currentMSecsSinceEpoch();
+    entry.level = level;
+    entry.category = category;
+    entry.message = std::move(message);
+    if (!threadRing()->push(std::move(entry))) {
+        g_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+QString Log::filePath()
+{
+    return g_filePath;
+}
+
+quint64 Log::droppedCount()
+{
+    return g_dropped.load();
+}
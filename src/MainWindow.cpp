@@ -1,6 +1,10 @@
 #include "MainWindow.h"
+#include "Log.h"
 #include <QApplication>
 #include <QScreen>
+#include <QElapsedTimer>
+#include <QSet>
+#include <algorithm>
 #include <QShortcut>
 #include <QInputDialog>
 #include <QFileDialog>
@@ -12,12 +16,14 @@
 #include <QDialogButtonBox>
 #include <QShowEvent>
 #include <QLineEdit> // Added for password fields
+#include <QPaintEvent>
+#include "StartupPipeline.h"
+#include "Tracer.h"
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , m_windowManager(nullptr)
     , m_fullscreenBrowser(nullptr)
-    , m_fullscreenWidgetPosition(-1)
     , m_loginDialog(nullptr)
     , m_subWindowManager(nullptr)
     , m_isLoggedIn(false)
@@ -26,11 +32,19 @@ MainWindow::MainWindow(QWidget *parent)
     , m_initialized(false)
     , m_loadingSubwindows(false) // Added for loading guard
 {
+    TRACE_SCOPE("MainWindow::MainWindow", "startup");
+
     // Create toolbar actions here (independent of menu)
     m_refreshAllAction = new QAction("刷新全部(&R)", this);
     m_refreshAllAction->setShortcut(QKeySequence::Refresh);
     m_refreshAllAction->setIcon(QIcon(":/icons/refresh.png"));
     
+    // Snapshot wall for CPU-only machines: only the tile in use renders continuously
+    m_thumbnailModeAction = new QAction("缩略图模式(&T)", this);
+    m_thumbnailModeAction->setCheckable(true);
+    m_thumbnailModeAction->setShortcut(QKeySequence("Ctrl+Shift+M"));
+    m_thumbnailModeAction->setToolTip("子窗口显示定时刷新的快照，仅悬停、聚焦或全屏的子窗口保持实时");
+    
     m_subWindowManagerAction = new QAction("子窗口管理(&W)", this);
     m_subWindowManagerAction->setShortcut(QKeySequence("Ctrl+Shift+W"));
     m_subWindowManagerAction->setIcon(QIcon(":/icons/window.png"));
@@ -47,35 +61,32 @@ MainWindow::MainWindow(QWidget *parent)
     setupConnections();
     setupShortcuts();
     
+    StartupPipeline* pipeline = StartupPipeline::getInstance();
+
     // Load settings
-    loadSettings();
+    pipeline->runStage(StartupPipeline::Settings, [this]() {
+        loadSettings();
+        return true;
+    });
     
-    // Check login
-    bool hasValidSession = checkLogin();
+    // Check login: the stored session is read once
+    bool hasValidSession = pipeline->runStage(StartupPipeline::SessionCheck, [this]() {
+        return checkLogin();
+    });
     if (hasValidSession) {
-        // Load user from session
-        DatabaseManager* dbManager = DatabaseManager::getInstance();
-        QString username;
-        bool remember;
-        if (dbManager->loadUserSession(username, remember)) {
-            m_currentUser = username;
-            m_isLoggedIn = true;
-            
-            
-            // Update status bar
-            QLabel* userLabel = qobject_cast<QLabel*>(m_statusBar->children().last());
-            if (userLabel) {
-                userLabel->setText(QString("用户: %1").arg(m_currentUser));
-            }
-            
-            // Set window title
-            setWindowTitle(QString("Browser Split Screen - %1").arg(m_currentUser));
-            
-            // Show main interface but defer loading subwindows
-            showMainInterface();
-        } else {
-            showLoginDialog();
+        m_isLoggedIn = true;
+        
+        // Update status bar
+        QLabel* userLabel = qobject_cast<QLabel*>(m_statusBar->children().last());
+        if (userLabel) {
+            userLabel->setText(QString("用户: %1").arg(m_currentUser));
         }
+        
+        // Set window title
+        setWindowTitle(QString("Browser Split Screen - %1").arg(m_currentUser));
+        
+        // Show main interface; sub-windows are loaded by the startup pipeline on first show
+        showMainInterface();
     } else {
         showLoginDialog();
     }
@@ -86,10 +97,10 @@ MainWindow::MainWindow(QWidget *parent)
     connect(m_autoSaveTimer, &QTimer::timeout, this, &MainWindow::onAutoSave);
     m_autoSaveTimer->start();
     
-    // Update status bar every 5 seconds
+    // Update status bar (layout and renderer usage) every 2 seconds
     QTimer* statusTimer = new QTimer(this);
     connect(statusTimer, &QTimer::timeout, this, &MainWindow::updateStatusBar);
-    statusTimer->start(5000);
+    statusTimer->start(2000);
     updateStatusBar();
 }
 
@@ -189,6 +200,7 @@ void MainWindow::setupToolBar()
     
     // Add toolbar actions (menu removed, so only these)
     m_toolBar->addAction(m_refreshAllAction);
+    m_toolBar->addAction(m_thumbnailModeAction);
     m_toolBar->addSeparator();
     m_toolBar->addAction(m_subWindowManagerAction);
     m_toolBar->addAction(m_settingsAction);
@@ -205,8 +217,13 @@ void MainWindow::setupStatusBar()
     m_globalProgressBar = new QProgressBar();
     m_globalProgressBar->setVisible(false);
     m_globalProgressBar->setMaximumWidth(200);
+    m_globalProgressBar->setRange(0, 100);
     m_statusBar->addPermanentWidget(m_globalProgressBar);
     
+    // Aggregate renderer usage of all visible tiles
+    m_resourceLabel = new QLabel();
+    m_statusBar->addPermanentWidget(m_resourceLabel);
+    
     QLabel* userLabel = new QLabel("用户: 未登录");
     m_statusBar->addPermanentWidget(userLabel);
 }
@@ -219,7 +236,7 @@ void MainWindow::setupCentralWidget()
     m_centralLayout = new QVBoxLayout(m_centralWidget);
     m_centralLayout->setContentsMargins(0, 0, 0, 0);
     
-    // Create stacked widget for main view, logout view and fullscreen view
+    // Create stacked widget for main view and logout view
     m_stackedWidget = new QStackedWidget(this);
     m_centralLayout->addWidget(m_stackedWidget);
     
@@ -238,10 +255,6 @@ void MainWindow::setupCentralWidget()
     m_stackedWidget->addWidget(m_logoutWidget);
     setupLogoutWidget();
     
-    // Fullscreen widget (placeholder)
-    m_fullscreenWidget = new QWidget();
-    m_stackedWidget->addWidget(m_fullscreenWidget);
-    
     // Initialize window manager
     m_windowManager = new WindowManager(m_mainWidget, this);
 }
@@ -313,6 +326,27 @@ void MainWindow::setupConnections()
 {
     // Toolbar actions only
     connect(m_refreshAllAction, &QAction::triggered, this, &MainWindow::onRefreshAll);
+    
+    // Refresh All progress, aggregated over the queued tiles
+    RefreshQueue* refreshQueue = m_windowManager->getRefreshQueue();
+    connect(refreshQueue, &RefreshQueue::progressChanged, this, [this](int percent, int completed, int total) {
+        m_globalProgressBar->setValue(percent);
+        m_globalProgressBar->setFormat(QString("刷新 %1/%2").arg(completed).arg(total));
+        m_globalProgressBar->setVisible(true);
+    });
+    connect(refreshQueue, &RefreshQueue::finished, this, [this, refreshQueue]() {
+        m_globalProgressBar->setVisible(false);
+        int deferred = refreshQueue->deferred();
+        if (deferred > 0) {
+            m_statusBar->showMessage(QString("刷新完成，%1 个未显示的子窗口将在滚动到可见区域时刷新").arg(deferred), 5000);
+        }
+    });
+    connect(m_thumbnailModeAction, &QAction::toggled, this, [this](bool enabled) {
+        if (m_windowManager) {
+            m_windowManager->setThumbnailMode(enabled);
+        }
+        DatabaseManager::getInstance()->setAppSetting("thumbnailWall", enabled);
+    });
     connect(m_subWindowManagerAction, &QAction::triggered, this, &MainWindow::onSubWindowManager);
     connect(m_settingsAction, &QAction::triggered, this, &MainWindow::onSettings);
     connect(m_accountManagerAction, &QAction::triggered, this, &MainWindow::onAccountManager);
@@ -320,32 +354,68 @@ void MainWindow::setupConnections()
     // Window manager signals (unchanged)
     connect(m_windowManager, &WindowManager::fullscreenRequested, 
             this, &MainWindow::onFullscreenRequested);
-    connect(m_windowManager, &WindowManager::allWidgetsCreated, this, &MainWindow::onAllWidgetsCreated);
+    connect(m_windowManager, &WindowManager::promotionChanged, 
+            this, &MainWindow::onPromotionChanged);
+    connect(m_windowManager, &WindowManager::layoutUpdated, this, [this](int movedTiles, qint64 elapsedNs) {
+        LOG_DEBUG("layout") << "MainWindow: Layout switch moved" << movedTiles << "tiles in" << elapsedNs / 1000 << "us";
+        updateStatusBar();
+    });
 }
 
 void MainWindow::setupShortcuts()
 {
     // Global shortcuts
+    // F11 toggles the main window itself; tile fullscreen is an overlay inside it
     new QShortcut(QKeySequence("F11"), this, [this]() {
-        if (m_fullscreenBrowser) {
-            hideFullscreenWindow();
+        if (isFullScreen()) {
+            showNormal();
+        } else {
+            showFullScreen();
         }
     });
     
     new QShortcut(QKeySequence("Escape"), this, [this]() {
         if (m_fullscreenBrowser) {
             hideFullscreenWindow();
+        } else if (isFullScreen()) {
+            showNormal();
+        }
+    });
+    
+    // Per-tile performance HUD
+    new QShortcut(QKeySequence("Ctrl+Shift+H"), this, [this]() {
+        if (!m_windowManager) {
+            return;
+        }
+        bool visible = !m_windowManager->isHudVisible();
+        m_windowManager->setHudVisible(visible);
+        DatabaseManager::getInstance()->setAppSetting("showTileHud", visible);
+    });
+    
+    // Dump the span trace (startup critical path and everything since) on request
+    new QShortcut(QKeySequence("Ctrl+Shift+T"), this, [this]() {
+        Tracer* tracer = Tracer::getInstance();
+        QString path = tracer->defaultDumpPath();
+        if (tracer->writeChromeTrace(path)) {
+            m_statusBar->showMessage(QString("跟踪已保存: %1").arg(path), 5000);
+        } else {
+            m_statusBar->showMessage("跟踪保存失败", 5000);
         }
     });
 }
 
 bool MainWindow::checkLogin()
 {
+    TRACE_SCOPE("MainWindow::checkLogin", "startup");
     DatabaseManager* dbManager = DatabaseManager::getInstance();
     QString username;
     bool remember;
     
-    return dbManager->loadUserSession(username, remember);
+    if (!dbManager->loadUserSession(username, remember)) {
+        return false;
+    }
+    m_currentUser = username;
+    return true;
 }
 
 void MainWindow::showLoginDialog()
@@ -361,40 +431,49 @@ void MainWindow::handleLogin()
     
     if (m_loginDialog && m_loginDialog->isLoginSuccessful()) {
         // Login through dialog
-        m_currentUser = m_loginDialog->getUsername();
-        m_isLoggedIn = true;
-        
-        
-        // Update status bar
-        QLabel* userLabel = qobject_cast<QLabel*>(m_statusBar->children().last());
-        if (userLabel) {
-            userLabel->setText(QString("用户: %1").arg(m_currentUser));
-        }
-        
-        // Set window title
-        setWindowTitle(QString("Browser Split Screen - %1").arg(m_currentUser));
-        
-        // FIXED: Explicitly load subwindows after login to initialize windowManager
-        loadSubWindowsToLayout();
-        m_initialized = true;  // FIXED: Set to true to prevent duplicate loading in showEvent
-        
-        // Show main interface
-        showMainInterface();
+        completeLogin(m_loginDialog->getUsername());
         
         m_loginDialog->deleteLater();
         m_loginDialog = nullptr;
     } else if (!m_loginDialog) {
         close();
     } else {
-        qDebug() << "Login failed, closing application";
+        LOG_INFO("session") << "Login failed, closing application";
         close();
     }
 }
 
+void MainWindow::completeLogin(const QString& username)
+{
+    m_currentUser = username;
+    m_isLoggedIn = true;
+    
+    // Update status bar
+    QLabel* userLabel = qobject_cast<QLabel*>(m_statusBar->children().last());
+    if (userLabel) {
+        userLabel->setText(QString("用户: %1").arg(m_currentUser));
+    }
+    
+    // Set window title
+    setWindowTitle(QString("Browser Split Screen - %1").arg(m_currentUser));
+    
+    // First login runs the remaining startup stages; a later re-login just reloads
+    if (StartupPipeline::getInstance()->isDone(StartupPipeline::NavigationScheduling)) {
+        m_windowManager->loadSubWindowSettings();  // Auto-refresh was stopped on logout
+        loadSubWindowsToLayout();
+    } else {
+        runStartupPipeline();
+    }
+    
+    // Show main interface
+    showMainInterface();
+}
+
 void MainWindow::handleLogout()
 {
     DatabaseManager* dbManager = DatabaseManager::getInstance();
     dbManager->clearUserSession();
+    m_windowManager->stopRefreshing();
     
     m_isLoggedIn = false;
     m_currentUser.clear();
@@ -406,7 +485,7 @@ void MainWindow::saveSettings()
 {
     DatabaseManager* dbManager = DatabaseManager::getInstance();
     if (!dbManager) {
-        qWarning() << "MainWindow::saveSettings: DatabaseManager instance unavailable";
+        LOG_WARNING("settings") << "MainWindow::saveSettings: DatabaseManager instance unavailable";
         return;
     }
 
@@ -418,9 +497,10 @@ void MainWindow::saveSettings()
 
 void MainWindow::loadSettings()
 {
+    TRACE_SCOPE("MainWindow::loadSettings", "startup");
     DatabaseManager* dbManager = DatabaseManager::getInstance();
     if (!dbManager) {
-        qWarning() << "MainWindow::loadSettings: DatabaseManager instance unavailable";
+        LOG_WARNING("settings") << "MainWindow::loadSettings: DatabaseManager instance unavailable";
         return;
     }
 
@@ -442,100 +522,59 @@ void MainWindow::loadSettings()
     dbManager->setAppSetting("windowCount", windowCount); // Ensure it's saved
     
     // 布局现在由子窗口数据自动决定，不需要手动设置
+    
+    if (m_windowManager) {
+        m_windowManager->setHudVisible(dbManager->getAppSetting("showTileHud", false).toBool());
+    }
+    m_thumbnailModeAction->setChecked(dbManager->getAppSetting("thumbnailWall", false).toBool());
 }
 
 void MainWindow::showFullscreenWindow(BrowserWidget* widget)
 {
     
     if (!widget) {
-        qDebug() << "MainWindow::showFullscreenWindow: Widget is null, returning";
+        LOG_DEBUG("layout") << "MainWindow::showFullscreenWindow: Widget is null, returning";
         return;
     }
     
-    m_fullscreenBrowser = widget;
-    
-    // Find the position of this widget in the layout
-    QList<BrowserWidget*> widgets = m_windowManager->getBrowserWidgets();
-    m_fullscreenWidgetPosition = widgets.indexOf(widget);
-    
-    // Detach widget from the main layout
-    m_windowManager->detachWidgetFromLayout(widget);
-    
-    // Clear any existing layout
-    QLayout* existingLayout = m_fullscreenWidget->layout();
-    if (existingLayout) {
-        QLayoutItem* item;
-        while ((item = existingLayout->takeAt(0)) != nullptr) {
-            // Don't delete the widget, just remove it from layout
-            if (item->widget()) {
-                qDebug() << "MainWindow::showFullscreenWindow: Setting widget parent to null";
-                item->widget()->setParent(nullptr);
-            }
-            delete item;
-        }
-        delete existingLayout;
-    } else {
-    }
-    
-    // Create fullscreen layout
-    QVBoxLayout* fullscreenLayout = new QVBoxLayout(m_fullscreenWidget);
-    fullscreenLayout->setContentsMargins(0, 0, 0, 0);
-    fullscreenLayout->setSpacing(0);
+    QElapsedTimer timer;
+    timer.start();
     
-    // Add widget to fullscreen layout
-    // Note: We don't change the parent to avoid WebView recreation
-    // The widget will be added to the layout without changing its parent
-    fullscreenLayout->addWidget(widget);
-    
-    // Switch to fullscreen view
-    m_stackedWidget->setCurrentWidget(m_fullscreenWidget);
+    m_fullscreenBrowser = widget;
     
     // Save cookies before entering fullscreen to ensure state is preserved
     if (widget->getSubWindowId() > 0) {
         widget->saveCookies();
     }
     
-    // Set fullscreen mode
+    // The tile stays in the wall; it is overlaid on the visible area with one geometry
+    // change, and its zoom is updated once in the next WindowManager frame pass
     widget->setFullscreenMode(true);
+    m_windowManager->promoteWidget(widget);
     
-    // Hide menu bar and tool bar
-    // m_menuBar->hide(); // Removed
-    m_toolBar->hide();
-    m_statusBar->hide();
-    
-    // Set window to fullscreen
-    showFullScreen();
-    
-    // Force the widget to resize to fill the entire screen
-    QTimer::singleShot(100, [this, widget]() {
-        if (widget && m_fullscreenBrowser == widget) {
-            // Get the available screen geometry
-            QScreen* screen = QApplication::primaryScreen();
-            if (screen) {
-                QRect screenGeometry = screen->geometry();
-                widget->setGeometry(0, 0, screenGeometry.width(), screenGeometry.height());
-                widget->setMinimumSize(screenGeometry.size());
-                widget->setMaximumSize(screenGeometry.size());
-            } else {
-            }
-        } else {
-        }
-    });
+    logFullscreenToggle("enter", timer.nsecsElapsed());
 }
 
 void MainWindow::hideFullscreenWindow()
 {
     if (!m_fullscreenBrowser) return;
     
-    // Exit fullscreen mode
-    showNormal();
+    QElapsedTimer timer;
+    timer.start();
     
-    // Show menu bar and tool bar
-    // m_menuBar->show(); // Removed
-    m_toolBar->show();
-    m_statusBar->show();
+    // Puts the tile back into its cell; onPromotionChanged restores normal mode
+    m_windowManager->demoteWidget();
+    
+    logFullscreenToggle("exit", timer.nsecsElapsed());
+}
+
+void MainWindow::onPromotionChanged(BrowserWidget* widget)
+{
+    if (widget || !m_fullscreenBrowser) {
+        return;
+    }
     
-    // Set widget back to normal mode
+    // Demoted, either explicitly or because the tile left the wall
     m_fullscreenBrowser->setFullscreenMode(false);
     
     // Reload cookies after exiting fullscreen to ensure login state is preserved
@@ -543,67 +582,53 @@ void MainWindow::hideFullscreenWindow()
         m_fullscreenBrowser->loadCookies();
     }
     
-    // Return widget to main view
-    // Note: We don't change the parent here to avoid WebView recreation
-    // The widget will be re-attached to the layout without changing its parent
-    m_windowManager->setParentWidget(m_mainWidget);
-    
-    // Re-attach widget to its original position in the layout
-    if (m_fullscreenWidgetPosition >= 0) {
-        m_windowManager->attachWidgetToLayout(m_fullscreenBrowser, m_fullscreenWidgetPosition);
-    }
-    
-    // Force layout update to ensure proper sizing
-    m_windowManager->forceLayoutUpdate();
-    
-    // Ensure all widgets have consistent widths after exiting fullscreen
-    m_windowManager->synchronizeWidgetWidths();
-    
-    // Reset the widget's size constraints after exiting fullscreen
-    QTimer::singleShot(50, [this]() {
-        if (m_fullscreenBrowser) {
-            m_fullscreenBrowser->setMinimumSize(300, 200);
-            m_fullscreenBrowser->setMaximumSize(QWIDGETSIZE_MAX, QWIDGETSIZE_MAX);
-            m_fullscreenBrowser->setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Preferred);
-        }
-    });
-    
-    // Switch back to main view
-    m_stackedWidget->setCurrentWidget(m_mainWidget);
-    
     m_fullscreenBrowser = nullptr;
-    m_fullscreenWidgetPosition = -1;
+}
+
+void MainWindow::logFullscreenToggle(const char* direction, qint64 elapsedNs)
+{
+    // Target: toggling in or out fits in one frame at 60 Hz
+    const qint64 frameBudgetNs = 16667000;
+    if (elapsedNs > frameBudgetNs) {
+        LOG_WARNING("layout") << "MainWindow: Fullscreen" << direction << "took" << elapsedNs / 1000 << "us, over the frame budget";
+    } else {
+        LOG_DEBUG("layout") << "MainWindow: Fullscreen" << direction << "took" << elapsedNs / 1000 << "us";
+    }
 }
 
 
 void MainWindow::onRefreshAll()
 {
-    QList<BrowserWidget*> widgets = m_windowManager->getBrowserWidgets();
-    for (BrowserWidget* widget : widgets) {
-        widget->refresh();
-    }
+    // Fullscreen and visible tiles first, a few at a time; pool members off the wall are skipped
+    m_windowManager->getRefreshQueue()->start();
 }
 
 
 
 
 void MainWindow::onSubWindowManager()
+{
+    SubWindowManager* manager = subWindowManager();
+    manager->show();
+    manager->raise();
+    manager->activateWindow();
+}
+
+WindowManager* MainWindow::windowManager() const
+{
+    return m_windowManager;
+}
+
+SubWindowManager* MainWindow::subWindowManager()
 {
     if (!m_subWindowManager) {
         m_subWindowManager = new SubWindowManager(this);
-        connect(m_subWindowManager, &SubWindowManager::subWindowAdded, 
-                this, &MainWindow::onSubWindowAdded);
         connect(m_subWindowManager, &SubWindowManager::subWindowRefreshRequested, 
                 this, &MainWindow::onNewSubWindowRefresh);
-        connect(m_subWindowManager, &SubWindowManager::subWindowUpdated, 
-                this, &MainWindow::onSubWindowUpdated);
-        connect(m_subWindowManager, &SubWindowManager::subWindowDeleted, 
-                this, &MainWindow::onSubWindowDeleted);
+        connect(m_subWindowManager, &SubWindowManager::subWindowsChanged, 
+                this, &MainWindow::onSubWindowsChanged);
     }
-    
-    m_subWindowManager->show();
-    m_subWindowManager->raise();
-    m_subWindowManager->activateWindow();
+    return m_subWindowManager;
 }
 
 void MainWindow::onSettings()
@@ -624,17 +649,34 @@ void MainWindow::onSettings()
     windowLayout->addWidget(windowLabel);
     
     QComboBox* windowCountCombo = new QComboBox(windowGroup);
-    windowCountCombo->addItems({"1列", "2列", "3列"});
+    for (int columns = WindowManager::MIN_COLUMNS; columns <= WindowManager::MAX_COLUMNS; ++columns) {
+        windowCountCombo->addItem(QString("%1列").arg(columns), columns);
+    }
     
     // Set current value
     DatabaseManager* dbSettings = DatabaseManager::getInstance();
     int currentColumns = dbSettings ? dbSettings->getAppSetting("windowColumns", 2).toInt() : 2; // Default to 2 columns
-    int index = currentColumns - 1; // Convert to 0-based index
-    if (index >= 0 && index < 3) {
+    int index = windowCountCombo->findData(currentColumns);
+    if (index >= 0) {
         windowCountCombo->setCurrentIndex(index);
     }
     
     windowLayout->addWidget(windowCountCombo);
+    
+    // Layout preset (overrides the column count when set)
+    QLabel* presetLabel = new QLabel("布局预设", windowGroup);
+    windowLayout->addWidget(presetLabel);
+    
+    QComboBox* presetCombo = new QComboBox(windowGroup);
+    presetCombo->addItem("按列数", QString());
+    for (const QString& preset : TileLayoutSpec::presetNames()) {
+        presetCombo->addItem(preset, preset);
+    }
+    QString currentPreset = dbSettings ? dbSettings->getAppSetting("layoutPreset", QString()).toString() : QString();
+    int presetIndex = presetCombo->findData(currentPreset);
+    presetCombo->setCurrentIndex(presetIndex >= 0 ? presetIndex : 0);
+    
+    windowLayout->addWidget(presetCombo);
     mainLayout->addWidget(windowGroup);
     
     // Dialog buttons
@@ -647,12 +689,15 @@ void MainWindow::onSettings()
     connect(cancelButton, &QPushButton::clicked, &settingsDialog, &QDialog::reject);
     
     if (settingsDialog.exec() == QDialog::Accepted) {
-        int newColumns = windowCountCombo->currentIndex() + 1; // Convert from 0-based to 1-based
+        int newColumns = windowCountCombo->currentData().toInt();
+        QString newPreset = presetCombo->currentData().toString();
         if (dbSettings) {
             dbSettings->setAppSetting("windowColumns", newColumns);
+            dbSettings->setAppSetting("layoutPreset", newPreset);
         }
         
-        // Apply the new column count
+        // Apply the new column count and preset
+        m_windowManager->setLayoutPreset(newPreset);
         applyWindowColumns(newColumns);
         
         // QMessageBox::information(this, "设置", QString("窗口列数量已设置为 %1 列").arg(newColumns));
@@ -696,7 +741,26 @@ void MainWindow::updateStatusBar()
 {
     if (m_windowManager) {
         int windowCount = m_windowManager->getCurrentWindowCount();
-        m_statusLabel->setText(QString("当前布局: %1 窗口").arg(windowCount));
+        double layoutMs = m_windowManager->lastLayoutTimeNs() / 1000000.0;
+        m_statusLabel->setText(QString("当前布局: %1 窗口 (布局耗时 %2 ms)")
+                               .arg(windowCount)
+                               .arg(layoutMs, 0, 'f', 2));
+        
+        // Renderers are counted once each; browser, GPU and utility processes separately
+        ResourceTotals totals = m_windowManager->getResourceSampler()->totals();
+        QString resources = QString("渲染进程: %1 | 内存: %2 | CPU: %3% | 其他进程: %4 / %5%")
+                                .arg(totals.rendererCount)
+                                .arg(TileHud::formatBytes(totals.rendererRssBytes))
+                                .arg(totals.rendererCpuPercent, 0, 'f', 1)
+                                .arg(TileHud::formatBytes(totals.auxiliaryRssBytes))
+                                .arg(totals.auxiliaryCpuPercent, 0, 'f', 1);
+        BrowserWidget* busiest = m_windowManager->findWidgetBySubId(totals.busiestSubId);
+        if (busiest && totals.busiestCpuPercent > 0.0) {
+            resources += QString(" | 最高: %1 (%2%)")
+                             .arg(busiest->getSubWindowName())
+                             .arg(totals.busiestCpuPercent, 0, 'f', 1);
+        }
+        m_resourceLabel->setText(resources);
     }
 }
 
@@ -732,145 +796,119 @@ void MainWindow::keyPressEvent(QKeyEvent *event)
     }
 }
 
-void MainWindow::onSubWindowAdded(const QJsonObject& subWindow)
+void MainWindow::onSubWindowsChanged(const SubWindowChangeResult& changes)
 {
-    int newSubId = subWindow["id"].toInt();
-    QString newName = subWindow["name"].toString();
-    QString newUrl = subWindow["url"].toString();
-
     if (!m_windowManager) {
-        qWarning() << "MainWindow::onSubWindowAdded: m_windowManager is null, cannot add";
+        LOG_WARNING("layout") << "MainWindow::onSubWindowsChanged: m_windowManager is null, cannot apply changes";
         return;
     }
 
-    // Reload all subwindows from database to ensure proper assignment
-    loadSubWindowsToLayout();
+    // The whole batch is one layout diff: removed tiles free their slots, edited tiles
+    // are retargeted in place, added tiles append; the window geometry stays as it is.
+    // window_configs rows were added, updated and deleted in the same DB transaction.
+    m_windowManager->applyChangeSet(changes);
 
+    m_currentLayout = m_windowManager->getCurrentWindowCount();
+    if (m_emptyStateLabel) {
+        m_emptyStateLabel->setVisible(m_currentLayout == 0);
+    }
+    updateStatusBar();
 }
 
-void MainWindow::onSubWindowUpdated(const QJsonObject& subWindow)
+void MainWindow::runStartupPipeline()
 {
-    if (!m_windowManager) return;
-
-    int subId = subWindow["id"].toInt();
-    QString newUrl = subWindow["url"].toString();
-    QString newName = subWindow["name"].toString();
-
+    StartupPipeline* pipeline = StartupPipeline::getInstance();
+    if (pipeline->isDone(StartupPipeline::NavigationScheduling)) {
+        return;
+    }
+    if (!m_windowManager) {
+        LOG_ERROR("startup") << "ERROR: m_windowManager is null!";
+        return;
+    }
 
-    BrowserWidget* targetWidget = m_windowManager->findWidgetBySubId(subId);
-    if (targetWidget) {
-        targetWidget->setSubWindowName(newName);
-        if (!newUrl.isEmpty() && targetWidget->getCurrentUrl() != newUrl) {
-            targetWidget->loadUrl(newUrl);
-        } else {
-        }
+    m_loadingSubwindows = true;
 
-        // Update window_configs with new URL from sub_windows (use subId as window_id)
-        DatabaseManager* dbManager = DatabaseManager::getInstance();
-        if (dbManager) {
-            QJsonObject geometry;
-            geometry["x"] = targetWidget->x();
-            geometry["y"] = targetWidget->y();
-            geometry["width"] = targetWidget->width();
-            geometry["height"] = targetWidget->height();
+    // Each stage needs the previous one; a failed stage stops the rest
+    QList<QJsonObject> subWindows;
+    const bool ready = pipeline->runStage(StartupPipeline::RegistryLoad, [this, &subWindows]() {
+            return loadSubWindowRegistry(subWindows);
+        })
+        && pipeline->runStage(StartupPipeline::PoolSizing, [this, &subWindows]() {
+            applyPoolSizing(subWindows.size());
+            return true;
+        })
+        && pipeline->runStage(StartupPipeline::NavigationScheduling, [this, &subWindows]() {
+            scheduleNavigations(subWindows);
+            return true;
+        });
+    if (!ready) {
+        LOG_WARNING("startup") << "MainWindow: Start-up stopped after a failed stage:" << pipeline->summary();
+    }
 
-            if (dbManager->saveWindowConfig(subId, subId, newUrl, newName, geometry)) {
-            } else {
-                qWarning() << "Failed to update window_config for subId:" << subId;
-            }
-        }
-    } else {
-        loadSubWindowsToLayout();
+    // First paint of the tile wall closes the pipeline
+    if (!pipeline->isDone(StartupPipeline::FirstPaint)) {
+        m_mainWidget->installEventFilter(this);
+        m_mainWidget->update();
     }
+
+    updateStatusBar();
+    m_initialized = true;
+    m_loadingSubwindows = false;
 }
 
-void MainWindow::onSubWindowDeleted(int subWindowId)
+bool MainWindow::loadSubWindowRegistry(QList<QJsonObject>& subWindows)
 {
-    
     DatabaseManager* dbManager = DatabaseManager::getInstance();
-    if (dbManager) {
-        dbManager->deleteWindowConfigsBySubId(subWindowId);
+    if (!dbManager) {
+        LOG_WARNING("startup") << "loadSubWindowRegistry: DatabaseManager is null!";
+        return false;
     }
+    subWindows = dbManager->getAllSubWindows();
     
-    // Full reload to remove and re-layout
-    loadSubWindowsToLayout();
+    // Oldest first, so sub-windows added later append at the end of the wall
+    // (the same slot addTile() gives them) instead of shifting every tile
+    std::reverse(subWindows.begin(), subWindows.end());
+    return true;
 }
 
-void MainWindow::onAllWidgetsCreated()
+void MainWindow::applyPoolSizing(int windowCount)
 {
-    if (m_loadingSubwindows) {
-        return;
-    }
-    loadSubWindowsToLayout();
-}
-
-void MainWindow::loadSubWindowsToLayout()
-{
-    
-    if (m_loadingSubwindows) {
-        return;
-    }
-    m_loadingSubwindows = true;
-    
-    if (!m_windowManager) {
-        qDebug() << "ERROR: m_windowManager is null!";
-        m_loadingSubwindows = false;
-        return;
-    }
-    
     DatabaseManager* dbManager = DatabaseManager::getInstance();
-    if (!dbManager) {
-        qWarning() << "loadSubWindowsToLayout: DatabaseManager is null!";
-        m_loadingSubwindows = false;
-        return;
-    }
-    QList<QJsonObject> subWindows = dbManager->getAllSubWindows();
-    
-    for (int i = 0; i < subWindows.size(); ++i) {
-        QJsonObject subWindow = subWindows[i];
-    }
-    
-    int columnCount = dbManager->getAppSetting("windowColumns", 2).toInt();
-    int windowCount = subWindows.size();
-    
-    
-    if (windowCount == 0) {
-        m_windowManager->setLayout(0);
-        m_currentLayout = 0;
-        
-        if (m_emptyStateLabel) {
-            m_emptyStateLabel->show();
-        }
-        
-        updateStatusBar();
-        m_loadingSubwindows = false;
-        return;
-    }
     
     // Hide empty state label when there are sub windows
     if (m_emptyStateLabel) {
-        m_emptyStateLabel->hide();
+        m_emptyStateLabel->setVisible(windowCount == 0);
     }
     
-    m_windowManager->setColumnCount(columnCount);
+    if (windowCount > 0) {
+        m_windowManager->setColumnCount(dbManager->getAppSetting("windowColumns", 2).toInt());
+        m_windowManager->setLayoutPreset(dbManager->getAppSetting("layoutPreset", QString()).toString());
+    }
     m_windowManager->setLayout(windowCount);
     m_currentLayout = windowCount;
     
-    // Apply window width based on column count
-    int requiredWidth = calculateRequiredWindowWidth(columnCount);
-    setMinimumWidth(requiredWidth);
-    resize(requiredWidth, height());
-    centerWindowOnScreen();
-    
+    // Tiles are sized from the available viewport; the main window keeps its size
+}
+
+void MainWindow::scheduleNavigations(const QList<QJsonObject>& subWindows)
+{
     // Update each widget by index order (match subWindows to first N widgets 1:1)
     QList<BrowserWidget*> widgets = m_windowManager->getBrowserWidgets();
 
+    // Pages of deleted sub-windows are dropped; all others stay alive in the page cache
+    QSet<int> liveSubIds;
+    for (const QJsonObject& subWindow : subWindows) {
+        liveSubIds.insert(subWindow["id"].toInt());
+    }
+    m_windowManager->releaseStalePages(liveSubIds);
+
     // Assign subwindows to the first N widgets (where N = subWindows.size())
-    // Don't rely on isVisible() as widgets may not be visible yet during layout updates
+    // Don't rely on isVisible() as widgets may not be visible yet during layout updates.
+    // Each sub-window brings its live page along, so shifted tiles do not reload.
     for (int i = 0; i < subWindows.size() && i < widgets.size(); i++) {
         BrowserWidget* widget = widgets[i];
         if (!widget) {
-            qWarning() << "Widget at index" << i << "is null, skipping";
+            LOG_WARNING("startup") << "Widget at index" << i << "is null, skipping";
             continue;
         }
 
@@ -878,39 +916,41 @@ void MainWindow::loadSubWindowsToLayout()
         int subId = subWindow["id"].toInt();
         QString name = subWindow["name"].toString();
         QString url = subWindow["url"].toString();
-        int widgetId = widget->getWindowId();
-
-
-        widget->setSubWindowId(subId);
-        widget->setSubWindowName(name);
-        if (widget->getCurrentUrl() != url) {
-            widget->loadUrl(url);
-        } else {
-        }
+        m_windowManager->assignSubWindow(widget, subId, name, url);
     }
+}
 
+void MainWindow::loadSubWindowsToLayout()
+{
     
-    // Force UI update
+    if (m_loadingSubwindows) {
+        return;
+    }
+    m_loadingSubwindows = true;
+    
+    if (!m_windowManager) {
+        LOG_ERROR("startup") << "ERROR: m_windowManager is null!";
+        m_loadingSubwindows = false;
+        return;
+    }
+    
+    QList<QJsonObject> subWindows;
+    if (!loadSubWindowRegistry(subWindows)) {
+        m_loadingSubwindows = false;
+        return;
+    }
+    
+    applyPoolSizing(subWindows.size());
+    scheduleNavigations(subWindows);
+    
+    // Schedule a repaint instead of forcing a synchronous one
     m_mainWidget->update();
-    m_mainWidget->repaint();
     
     updateStatusBar();
     m_initialized = true;
     m_loadingSubwindows = false;
 }
 
-void MainWindow::applyWindowCount(int windowCount)
-{
-    if (!m_windowManager) return;
-    
-    // Set the layout to the specified window count
-    m_windowManager->setLayout(windowCount);
-    m_currentLayout = windowCount;
-    
-    // Reload sub windows to fit the new layout
-    loadSubWindowsToLayout();
-}
-
 void MainWindow::applyWindowColumns(int columns)
 {
     if (!m_windowManager) return;
@@ -918,11 +958,6 @@ void MainWindow::applyWindowColumns(int columns)
     
     m_windowManager->setColumnCount(columns);
     
-    int requiredWidth = calculateRequiredWindowWidth(columns);
-    setMinimumWidth(requiredWidth);
-    resize(requiredWidth, height());
-    centerWindowOnScreen();
-    
     // Update layout without full reload - just resize and manage visibility
     m_windowManager->forceLayoutUpdate();
     DatabaseManager* dbSettings2 = DatabaseManager::getInstance();
@@ -931,41 +966,6 @@ void MainWindow::applyWindowColumns(int columns)
     }
 }
 
-int MainWindow::calculateRequiredWindowWidth(int columns)
-{
-    // Calculate required window width based on column count
-    int widgetWidth = (columns == 1) ? 880 : 500;
-    int spacing = 5; // Spacing between widgets
-    int margins = 20; // Window margins
-    
-    int requiredWidth = (widgetWidth * columns) + (spacing * (columns - 1)) + margins;
-
-    return requiredWidth;
-}
-
-void MainWindow::centerWindowOnScreen()
-{
-    // Get the primary screen
-    QScreen* screen = QApplication::primaryScreen();
-    if (!screen) {
-        return;
-    }
-    
-    // Get screen geometry
-    QRect screenGeometry = screen->geometry();
-    
-    // Get current window size
-    QSize windowSize = size();
-    
-    // Calculate center position
-    int x = screenGeometry.x() + (screenGeometry.width() - windowSize.width()) / 2;
-    int y = screenGeometry.y() + (screenGeometry.height() - windowSize.height()) / 2;
-    
-    
-    // Move window to center
-    move(x, y);
-}
-
 void MainWindow::onLogout()
 {
     
@@ -978,6 +978,14 @@ void MainWindow::onLogout()
         return;
     }
     
+    logout();
+}
+
+void MainWindow::logout()
+{
+    // Nothing reloads behind the logout page
+    m_windowManager->stopRefreshing();
+    
     // Clear all browser widgets' login states
     QList<BrowserWidget*> widgets = m_windowManager->getBrowserWidgets();
     for (BrowserWidget* widget : widgets) {
@@ -1240,23 +1248,30 @@ void MainWindow::showEvent(QShowEvent* event) {
     QMainWindow::showEvent(event);
     
     if (m_isLoggedIn && !m_initialized) {
-        loadSubWindowsToLayout();
-        m_initialized = true;
-    } else if (!m_isLoggedIn) {
-    } else {
+        runStartupPipeline();
+    }
+}
+
+bool MainWindow::eventFilter(QObject* watched, QEvent* event)
+{
+    if (watched == m_mainWidget && event->type() == QEvent::Paint) {
+        m_mainWidget->removeEventFilter(this);
+        Tracer::getInstance()->instant("tile-wall-first-paint", "startup");
+        StartupPipeline::getInstance()->markStage(StartupPipeline::FirstPaint);
     }
+    return QMainWindow::eventFilter(watched, event);
 }
 
 void MainWindow::onNewSubWindowRefresh(int subId)
 {
     if (!m_windowManager) {
-        qWarning() << "MainWindow::onNewSubWindowRefresh: m_windowManager is null";
+        LOG_WARNING("tile") << "MainWindow::onNewSubWindowRefresh: m_windowManager is null";
         return;
     }
     
     DatabaseManager* dbManager = DatabaseManager::getInstance();
     if (!dbManager) {
-        qWarning() << "MainWindow::onNewSubWindowRefresh: DatabaseManager is null";
+        LOG_WARNING("tile") << "MainWindow::onNewSubWindowRefresh: DatabaseManager is null";
         return;
     }
     
@@ -1270,7 +1285,7 @@ void MainWindow::onNewSubWindowRefresh(int subId)
     }
     
     if (targetSubWindow.isEmpty()) {
-        qWarning() << "MainWindow::onNewSubWindowRefresh: No sub-window found for subId" << subId;
+        LOG_WARNING("tile") << "MainWindow::onNewSubWindowRefresh: No sub-window found for subId" << subId;
         return;
     }
     
@@ -1279,11 +1294,9 @@ void MainWindow::onNewSubWindowRefresh(int subId)
     
     BrowserWidget* targetWidget = m_windowManager->findWidgetBySubId(subId);
     if (targetWidget) {
-        targetWidget->setSubWindowId(subId);
-        targetWidget->setSubWindowName(name);
-        targetWidget->loadUrl(url);
+        m_windowManager->assignSubWindow(targetWidget, subId, name, url);
     } else {
-        qWarning() << "MainWindow::onNewSubWindowRefresh: No widget found for subId" << subId;
+        LOG_WARNING("tile") << "MainWindow::onNewSubWindowRefresh: No widget found for subId" << subId;
     }
 }
 
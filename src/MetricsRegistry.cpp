@@ -0,0 +1,214 @@
+#include "MetricsRegistry.h"
+#include "Log.h"
+#include <QMutexLocker>
+#include <algorithm>
+
+MetricsRegistry* MetricsRegistry::instance = nullptr;
+
+MetricsRegistry* MetricsRegistry::getInstance()
+{
+    // Created from main() before any worker thread runs
+    if (!instance) {
+        instance = new MetricsRegistry();
+    }
+    return instance;
+}
+
+MetricsRegistry::MetricsRegistry()
+    : m_nextCollectorId(1)
+{
+    // Families shared by several modules are declared in one place
+    defineHistogram("bss_tile_load_seconds", "Time from navigation start to load finished per tile.",
+                    latencyBuckets());
+    defineCounter("bss_navigation_failures", "Navigations that finished unsuccessfully.");
+    defineCounter("bss_tile_reloads", "Tile reloads requested by the user or the application.");
+    defineCounter("bss_tile_thumbnails", "Snapshots taken of frozen tiles in thumbnail wall mode.");
+    defineCounter("bss_auto_refresh_checks", "Scheduled refresh checks by result (changed, unchanged, forced, failed, unchecked).");
+    defineCounter("bss_blocked_requests", "Subresource requests dropped by the blocklist, by category (ads, trackers, heavy).");
+    defineHistogram("bss_db_write_seconds", "Latency of database writes by operation.", latencyBuckets());
+    defineHistogram("bss_event_loop_lag_seconds", "How late the GUI thread handled a heartbeat.",
+                    {0.001, 0.004, 0.008, 0.016, 0.033, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5});
+    defineGauge("bss_tiles", "Tiles by page lifecycle state.");
+    defineGauge("bss_renderer_rss_bytes", "Resident memory of the tile's renderer share.");
+    defineGauge("bss_renderer_pss_bytes", "Proportional memory of the tile's renderer share.");
+    defineGauge("bss_renderer_cpu_ratio", "CPU use of the tile's renderer share, 1.0 = one core.");
+}
+
+void MetricsRegistry::defineCounter(const QString& name, const QString& help)
+{
+    QMutexLocker locker(&m_mutex);
+    Family& family = m_families[name];
+    family.type = Type::Counter;
+    family.help = help;
+}
+
+void MetricsRegistry::defineGauge(const QString& name, const QString& help)
+{
+    QMutexLocker locker(&m_mutex);
+    Family& family = m_families[name];
+    family.type = Type::Gauge;
+    family.help = help;
+}
+
+void MetricsRegistry::defineHistogram(const QString& name, const QString& help, const QList<double>& buckets)
+{
+    QMutexLocker locker(&m_mutex);
+    Family& family = m_families[name];
+    family.type = Type::Histogram;
+    family.help = help;
+    family.buckets = buckets;
+    std::sort(family.buckets.begin(), family.buckets.end());
+}
+
+void MetricsRegistry::increment(const QString& name, const QString& labels, double amount)
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_families.find(name);
+    if (it == m_families.end() || it->type != Type::Counter || amount < 0.0) {
+        LOG_WARNING("metrics") << "MetricsRegistry: Unknown counter or negative increment:" << name;
+        return;
+    }
+    it->values[labels] += amount;
+}
+
+void MetricsRegistry::setGauge(const QString& name, const QString& labels, double value)
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_families.find(name);
+    if (it == m_families.end() || it->type != Type::Gauge) {
+        LOG_WARNING("metrics") << "MetricsRegistry: Unknown gauge:" << name;
+        return;
+    }
+    it->values[labels] = value;
+}
+
+void MetricsRegistry::clearGauge(const QString& name)
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_families.find(name);
+    if (it != m_families.end() && it->type == Type::Gauge) {
+        it->values.clear();
+    }
+}
+
+void MetricsRegistry::observe(const QString& name, const QString& labels, double value)
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_families.find(name);
+    if (it == m_families.end() || it->type != Type::Histogram) {
+        LOG_WARNING("metrics") << "MetricsRegistry: Unknown histogram:" << name;
+        return;
+    }
+
+    HistogramSample& sample = it->histograms[labels];
+    if (sample.bucketCounts.isEmpty()) {
+        sample.bucketCounts.resize(it->buckets.size());
+    }
+
+    // Values above the largest bound only land in +Inf (count)
+    auto bound = std::lower_bound(it->buckets.constBegin(), it->buckets.constEnd(), value);
+    if (bound != it->buckets.constEnd()) {
+        ++sample.bucketCounts[static_cast<int>(bound - it->buckets.constBegin())];
+    }
+    ++sample.count;
+    sample.sum += value;
+}
+
+int MetricsRegistry::addCollector(const Collector& collector)
+{
+    QMutexLocker locker(&m_mutex);
+    int id = m_nextCollectorId++;
+    m_collectors.insert(id, collector);
+    return id;
+}
+
+void MetricsRegistry::removeCollector(int id)
+{
+    QMutexLocker locker(&m_mutex);
+    m_collectors.remove(id);
+}
+
+QByteArray MetricsRegistry::exposition()
+{
+    // Collectors update gauges through the public API, so they run unlocked
+    QList<Collector> collectors;
+    {
+        QMutexLocker locker(&m_mutex);
+        collectors = m_collectors.values();
+    }
+    for (const Collector& collector : collectors) {
+        collector(*this);
+    }
+
+    auto number = [](double value) {
+        return QByteArray::number(value, 'g', 17);
+    };
+    auto withLabels = [](const QString& name, const QString& labels, const QString& extra = QString()) {
+        QString all = labels;
+        if (!extra.isEmpty()) {
+            all = all.isEmpty() ? extra : all + "," + extra;
+        }
+        return (all.isEmpty() ? name : QString("%1{%2}").arg(name, all)).toUtf8();
+    };
+
+    QMutexLocker locker(&m_mutex);
+    QByteArray out;
+    for (auto it = m_families.constBegin(); it != m_families.constEnd(); ++it) {
+        const QString& name = it.key();
+        const Family& family = it.value();
+
+        const char* type = family.type == Type::Counter ? "counter"
+                         : family.type == Type::Gauge ? "gauge" : "histogram";
+        out += "# TYPE " + name.toUtf8() + " " + type + "\n";
+        out += "# HELP " + name.toUtf8() + " " + family.help.toUtf8() + "\n";
+
+        if (family.type == Type::Counter) {
+            for (auto value = family.values.constBegin(); value != family.values.constEnd(); ++value) {
+                out += withLabels(name + "_total", value.key()) + " " + number(value.value()) + "\n";
+            }
+        } else if (family.type == Type::Gauge) {
+            for (auto value = family.values.constBegin(); value != family.values.constEnd(); ++value) {
+                out += withLabels(name, value.key()) + " " + number(value.value()) + "\n";
+            }
+        } else {
+            for (auto sample = family.histograms.constBegin(); sample != family.histograms.constEnd(); ++sample) {
+                quint64 cumulative = 0;
+                for (int i = 0; i < family.buckets.size(); ++i) {
+                    cumulative += sample->bucketCounts.value(i);
+                    out += withLabels(name + "_bucket", sample.key(), label("le", QString::number(family.buckets[i], 'g', 17)))
+                         + " " + QByteArray::number(cumulative) + "\n";
+                }
+                out += withLabels(name + "_bucket", sample.key(), label("le", "+Inf"))
+                     + " " + QByteArray::number(sample->count) + "\n";
+                out += withLabels(name + "_count", sample.key()) + " " + QByteArray::number(sample->count) + "\n";
+                out += withLabels(name + "_sum", sample.key()) + " " + number(sample->sum) + "\n";
+            }
+        }
+    }
+    out += "# EOF\n";
+    return out;
+}
+
+QString MetricsRegistry::label(const QString& key, const QString& value)
+{
+    return QString("%1=\"%2\"").arg(key, escapeLabelValue(value));
+}
+
+QString MetricsRegistry::label(const QString& key, int value)
+{
+    return label(key, QString::number(value));
+}
+
+QString MetricsRegistry::escapeLabelValue(const QString& value)
+{
+    QString escaped = value;
+    escaped.replace('\\', "\\\\");
+    escaped.replace('"', "\\\"");
+    escaped.replace('\n', "\\n");
+    return escaped;
+}
+
+QList<double> MetricsRegistry::latencyBuckets()
+{
+    return {0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0, 30.0};
+}
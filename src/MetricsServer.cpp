@@ -0,0 +1,123 @@
+#include "MetricsServer.h"
+#include "Log.h"
+#include "MetricsRegistry.h"
+#include "DatabaseManager.h"
+#include <QTcpSocket>
+#include <QHostAddress>
+
+const int MetricsServer::MAX_REQUEST_BYTES = 8192;
+
+MetricsServer::MetricsServer(QObject* parent)
+    : QObject(parent)
+    , m_server(new QTcpServer(this))
+{
+    connect(m_server, &QTcpServer::newConnection, this, &MetricsServer::onNewConnection);
+}
+
+MetricsServer::~MetricsServer()
+{
+    stop();
+}
+
+quint16 MetricsServer::configuredPort()
+{
+    bool ok = false;
+    int port = qEnvironmentVariableIntValue("BSS_METRICS_PORT", &ok);
+    if (!ok) {
+        DatabaseManager* dbManager = DatabaseManager::getInstance();
+        port = dbManager ? dbManager->getAppSetting("metricsPort", 0).toInt() : 0;
+    }
+    return (port > 0 && port <= 65535) ? static_cast<quint16>(port) : 0;
+}
+
+bool MetricsServer::start(quint16 port)
+{
+    if (port == 0) {
+        return false;
+    }
+
+    // Loopback only: the endpoint has no authentication
+    if (!m_server->listen(QHostAddress::LocalHost, port)) {
+        LOG_WARNING("metrics") << "MetricsServer: Failed to listen on 127.0.0.1:" << port << m_server->errorString();
+        return false;
+    }
+
+    LOG_INFO("metrics") << "MetricsServer: Serving OpenMetrics on http://127.0.0.1:" << port << "/metrics";
+    return true;
+}
+
+void MetricsServer::stop()
+{
+    m_server->close();
+    for (QTcpSocket* socket : m_requests.keys()) {
+        socket->abort();
+        socket->deleteLater();
+    }
+    m_requests.clear();
+}
+
+bool MetricsServer::isListening() const
+{
+    return m_server->isListening();
+}
+
+quint16 MetricsServer::port() const
+{
+    return m_server->serverPort();
+}
+
+void MetricsServer::onNewConnection()
+{
+    while (QTcpSocket* socket = m_server->nextPendingConnection()) {
+        m_requests.insert(socket, QByteArray());
+        connect(socket, &QTcpSocket::readyRead, this, &MetricsServer::onReadyRead);
+        connect(socket, &QTcpSocket::disconnected, this, [this, socket]() {
+            m_requests.remove(socket);
+            socket->deleteLater();
+        });
+    }
+}
+
+void MetricsServer::onReadyRead()
+{
+    QTcpSocket* socket = qobject_cast<QTcpSocket*>(sender());
+    if (!socket || !m_requests.contains(socket)) {
+        return;
+    }
+
+    QByteArray& request = m_requests[socket];
+    request += socket->readAll();
+    if (request.size() > MAX_REQUEST_BYTES) {
+        respond(socket, "431 Request Header Fields Too Large", "text/plain", "request too large\n");
+        return;
+    }
+    if (!request.contains("\r\n\r\n")) {
+        return;  // Headers not complete yet
+    }
+
+    // "GET /metrics HTTP/1.1"
+    const QList<QByteArray> requestLine = request.left(request.indexOf("\r\n")).split(' ');
+    const QByteArray method = requestLine.value(0);
+    const QByteArray path = requestLine.value(1);
+
+    if (method != "GET") {
+        respond(socket, "405 Method Not Allowed", "text/plain", "only GET is supported\n");
+    } else if (path == "/metrics" || path.startsWith("/metrics?")) {
+        respond(socket, "200 OK", "application/openmetrics-text; version=1.0.0; charset=utf-8",
+                MetricsRegistry::getInstance()->exposition());
+    } else {
+        respond(socket, "404 Not Found", "text/plain", "see /metrics\n");
+    }
+}
+
+void MetricsServer::respond(QTcpSocket* socket, const QByteArray& status, const QByteArray& contentType,
+                            const QByteArray& body)
+{
+    QByteArray response = "HTTP/1.1 " + status + "\r\n"
+                          "Content-Type: " + contentType + "\r\n"
+                          "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+                          "Connection: close\r\n\r\n" + body;
+    socket->write(response);
+    socket->disconnectFromHost();
+    m_requests.remove(socket);
+}
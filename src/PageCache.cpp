@@ -0,0 +1,160 @@
+#include "PageCache.h"
+#include "Log.h"
+#include "RequestBlocker.h"
+#include <QWebEngineView>
+#include <QWebEngineSettings>
+
+static const char* const REQUESTED_URL_PROPERTY = "requestedUrl";
+
+PageCache::PageCache(int capacity, QObject* parent)
+    : QObject(parent)
+    , m_capacity(qMax(1, capacity))
+{
+}
+
+PageCache::~PageCache()
+{
+    const QList<int> subIds = m_entries.keys();
+    for (int subId : subIds) {
+        release(subId);
+    }
+}
+
+QWebEnginePage* PageCache::acquire(int subId)
+{
+    if (subId <= 0) {
+        return nullptr;
+    }
+
+    QWebEnginePage* page = find(subId);
+    if (page) {
+        m_lru.removeOne(subId);
+    } else {
+        page = createPage(subId);
+    }
+
+    m_lru.prepend(subId);
+    evict();
+    return page;
+}
+
+QWebEnginePage* PageCache::find(int subId) const
+{
+    auto it = m_entries.constFind(subId);
+    return it != m_entries.constEnd() ? it->page : nullptr;
+}
+
+void PageCache::release(int subId)
+{
+    auto it = m_entries.find(subId);
+    if (it == m_entries.end()) {
+        return;
+    }
+
+    Entry entry = it.value();
+    m_entries.erase(it);
+    m_lru.removeOne(subId);
+
+    // The page must go before its profile. The profile goes right away, not later: the
+    // sub-window may be acquired again in this event-loop turn, and a second profile
+    // with the same name must not share its storage with one still alive.
+    delete entry.page;
+    delete entry.profile;
+}
+
+void PageCache::retainOnly(const QSet<int>& subIds)
+{
+    const QList<int> cached = m_entries.keys();
+    for (int subId : cached) {
+        if (!subIds.contains(subId)) {
+            release(subId);
+        }
+    }
+}
+
+void PageCache::setCapacity(int capacity)
+{
+    m_capacity = qMax(1, capacity);
+    evict();
+}
+
+int PageCache::capacity() const
+{
+    return m_capacity;
+}
+
+int PageCache::size() const
+{
+    return m_entries.size();
+}
+
+QString PageCache::requestedUrl(const QWebEnginePage* page)
+{
+    return page ? page->property(REQUESTED_URL_PROPERTY).toString() : QString();
+}
+
+void PageCache::setRequestedUrl(QWebEnginePage* page, const QString& url)
+{
+    if (page) {
+        page->setProperty(REQUESTED_URL_PROPERTY, url);
+    }
+}
+
+QWebEnginePage* PageCache::createPage(int subId)
+{
+    // One profile per sub-window; only one profile with a given name is alive at a time
+    Entry entry;
+    entry.profile = new QWebEngineProfile(QString("SubWindow_%1").arg(subId), this);
+    RequestBlocker* blocker = RequestBlocker::getInstance();
+    if (blocker->isEnabled()) {
+        entry.profile->setUrlRequestInterceptor(blocker);
+    }
+    entry.page = new QWebEnginePage(entry.profile, this);
+    applySettings(entry.page->settings());
+
+    m_entries.insert(subId, entry);
+    return entry.page;
+}
+
+void PageCache::applySettings(QWebEngineSettings* settings)
+{
+    if (!settings) {
+        return;
+    }
+
+    settings->setAttribute(QWebEngineSettings::JavascriptEnabled, true);
+    settings->setAttribute(QWebEngineSettings::LocalContentCanAccessRemoteUrls, true);
+    settings->setAttribute(QWebEngineSettings::LocalContentCanAccessFileUrls, true);
+    settings->setAttribute(QWebEngineSettings::AutoLoadImages, true);
+    settings->setAttribute(QWebEngineSettings::PluginsEnabled, true);
+    settings->setAttribute(QWebEngineSettings::WebGLEnabled, true);
+    settings->setAttribute(QWebEngineSettings::Accelerated2dCanvasEnabled, true);
+    settings->setAttribute(QWebEngineSettings::AutoLoadIconsForPage, true);
+    settings->setAttribute(QWebEngineSettings::TouchIconsEnabled, true);
+    settings->setAttribute(QWebEngineSettings::FocusOnNavigationEnabled, true);
+    settings->setAttribute(QWebEngineSettings::PrintElementBackgrounds, true);
+    settings->setAttribute(QWebEngineSettings::AllowRunningInsecureContent, true);
+    settings->setAttribute(QWebEngineSettings::AllowGeolocationOnInsecureOrigins, true);
+    settings->setAttribute(QWebEngineSettings::AllowWindowActivationFromJavaScript, true);
+    settings->setAttribute(QWebEngineSettings::ShowScrollBars, true);
+    settings->setAttribute(QWebEngineSettings::PlaybackRequiresUserGesture, false);
+    settings->setAttribute(QWebEngineSettings::JavascriptCanOpenWindows, true);
+    settings->setAttribute(QWebEngineSettings::JavascriptCanAccessClipboard, true);
+    settings->setAttribute(QWebEngineSettings::LinksIncludedInFocusChain, true);
+    settings->setAttribute(QWebEngineSettings::LocalStorageEnabled, true);
+}
+
+void PageCache::evict()
+{
+    // Walk from the least recently used end; pages on screen are never evicted
+    for (int i = m_lru.size() - 1; i >= 0 && m_entries.size() > m_capacity; --i) {
+        int subId = m_lru[i];
+        QWebEngineView* view = QWebEngineView::forPage(m_entries.value(subId).page);
+        if (view && view->isVisible()) {
+            continue;
+        }
+
+        LOG_DEBUG("cache") << "PageCache: Evicting page for sub window" << subId;
+        release(subId);
+    }
+}
@@ -0,0 +1,165 @@
+#include "ProcStats.h"
+#include <QByteArray>
+#include <QDir>
+#include <QFile>
+#include <QHash>
+#include <QList>
+#include <chrono>
+
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+
+ProcessSample ProcStats::read(qint64 pid)
+{
+    ProcessSample sample;
+    sample.pid = pid;
+    sample.sampledAtNs = monotonicNs();
+
+#ifdef Q_OS_LINUX
+    if (pid <= 0) {
+        return sample;
+    }
+
+    QFile statFile(QString("/proc/%1/stat").arg(pid));
+    if (!statFile.open(QIODevice::ReadOnly)) {
+        return sample;
+    }
+    const QByteArray stat = statFile.readAll();
+
+    // The command name (field 2) may contain spaces; fields are counted after its ')'
+    const int nameEnd = stat.lastIndexOf(')');
+    if (nameEnd < 0) {
+        return sample;
+    }
+    const QList<QByteArray> fields = stat.mid(nameEnd + 2).split(' ');
+
+    // After ')': [0]=state [1]=ppid ... [11]=utime [12]=stime ... [17]=num_threads ... [21]=rss (pages)
+    if (fields.size() < 22) {
+        return sample;
+    }
+    sample.parentPid = fields[1].toLongLong();
+    sample.cpuTicks = fields[11].toULongLong() + fields[12].toULongLong();
+    sample.threadCount = fields[17].toInt();
+    sample.rssBytes = fields[21].toLongLong() * pageSize();
+    sample.valid = true;
+#endif
+
+    return sample;
+}
+
+qint64 ProcStats::readPss(qint64 pid)
+{
+#ifdef Q_OS_LINUX
+    // smaps_rollup (Linux 4.14+) is one pre-summed record instead of one per mapping
+    QFile file(QString("/proc/%1/smaps_rollup").arg(pid));
+    if (pid <= 0 || !file.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine();
+        if (line.startsWith("Pss:")) {
+            // "Pss:              12345 kB"
+            return line.mid(4).trimmed().split(' ').value(0).toLongLong() * 1024;
+        }
+    }
+#else
+    Q_UNUSED(pid);
+#endif
+    return -1;
+}
+
+QString ProcStats::chromiumProcessType(qint64 pid)
+{
+#ifdef Q_OS_LINUX
+    QFile file(QString("/proc/%1/cmdline").arg(pid));
+    if (pid <= 0 || !file.open(QIODevice::ReadOnly)) {
+        return QString();
+    }
+
+    // Arguments are NUL separated
+    for (const QByteArray& argument : file.readAll().split('\0')) {
+        if (argument.startsWith("--type=")) {
+            return QString::fromLatin1(argument.mid(7));
+        }
+    }
+#else
+    Q_UNUSED(pid);
+#endif
+    return QString();
+}
+
+QList<qint64> ProcStats::descendants(qint64 pid)
+{
+    QList<qint64> result;
+#ifdef Q_OS_LINUX
+    // One pass to build the parent map, then a breadth-first walk from pid
+    QHash<qint64, QList<qint64>> children;
+    const QStringList entries = QDir("/proc").entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const QString& entry : entries) {
+        bool isPid = false;
+        qint64 candidate = entry.toLongLong(&isPid);
+        if (!isPid) {
+            continue;
+        }
+        ProcessSample sample = read(candidate);
+        if (sample.valid) {
+            children[sample.parentPid].append(candidate);
+        }
+    }
+
+    QList<qint64> pending = children.value(pid);
+    while (!pending.isEmpty()) {
+        qint64 child = pending.takeFirst();
+        result.append(child);
+        pending.append(children.value(child));
+    }
+#else
+    Q_UNUSED(pid);
+#endif
+    return result;
+}
+
+double ProcStats::cpuPercent(const ProcessSample& previous, const ProcessSample& current)
+{
+    if (!previous.valid || !current.valid || previous.pid != current.pid ||
+        current.cpuTicks < previous.cpuTicks) {
+        return -1.0;
+    }
+
+    const qint64 elapsedNs = current.sampledAtNs - previous.sampledAtNs;
+    if (elapsedNs <= 0) {
+        return -1.0;
+    }
+
+    // Percent of one core, like top
+    const double cpuSeconds = static_cast<double>(current.cpuTicks - previous.cpuTicks) / ticksPerSecond();
+    return cpuSeconds * 100.0 * 1e9 / elapsedNs;
+}
+
+qint64 ProcStats::monotonicNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+qint64 ProcStats::ticksPerSecond()
+{
+#ifdef Q_OS_LINUX
+    static const qint64 ticks = qMax<long>(1, sysconf(_SC_CLK_TCK));
+    return ticks;
+#else
+    return 100;
+#endif
+}
+
+qint64 ProcStats::pageSize()
+{
+#ifdef Q_OS_LINUX
+    static const qint64 size = qMax<long>(1, sysconf(_SC_PAGESIZE));
+    return size;
+#else
+    return 4096;
+#endif
+}
@@ -0,0 +1,217 @@
+#include "RefreshQueue.h"
+#include "WindowManager.h"
+#include "BrowserWidget.h"
+#include "Log.h"
+
+const int RefreshQueue::MAX_CONCURRENT_LOADS = 3;
+const int RefreshQueue::LOAD_TIMEOUT_MS = 30000;  // A hung load gives up its slot
+
+RefreshQueue::RefreshQueue(WindowManager* windowManager, QObject* parent)
+    : QObject(parent)
+    , m_windowManager(windowManager)
+    , m_watchdog(new QTimer(this))
+    , m_completed(0)
+    , m_running(false)
+    , m_busy(false)
+{
+    m_clock.start();
+    m_watchdog->setInterval(1000);
+    connect(m_watchdog, &QTimer::timeout, this, &RefreshQueue::onWatchdog);
+}
+
+void RefreshQueue::start()
+{
+    // Tiles already reloading keep their slot; everything else is queued again
+    if (!m_running) {
+        m_completed = 0;
+    }
+    m_pending.clear();
+
+    QList<BrowserWidget*> onScreen;
+    QList<BrowserWidget*> offScreen;
+    BrowserWidget* promoted = m_windowManager->getPromotedWidget();
+    const QList<BrowserWidget*> widgets = m_windowManager->getBrowserWidgets();
+    const int wallCount = qMin(m_windowManager->getCurrentWindowCount(), static_cast<int>(widgets.size()));
+    for (int i = 0; i < wallCount; ++i) {
+        BrowserWidget* widget = widgets[i];
+        if (!widget || widget->getSubWindowId() <= 0 || m_inFlight.contains(widget->getSubWindowId())) {
+            continue;  // Unassigned pool members have nothing to refresh
+        }
+        if (widget == promoted) {
+            m_pending.append(widget->getSubWindowId());
+        } else if (m_windowManager->isTileOnScreen(widget)) {
+            onScreen.append(widget);
+        } else {
+            offScreen.append(widget);
+        }
+    }
+    for (BrowserWidget* widget : onScreen + offScreen) {
+        m_pending.append(widget->getSubWindowId());
+    }
+
+    LOG_DEBUG("refresh") << "RefreshQueue: queued" << m_pending.size() << "tiles," << offScreen.size() << "off screen";
+    m_running = true;
+    pump();
+}
+
+void RefreshQueue::cancel()
+{
+    for (int subId : m_inFlight.keys()) {
+        disconnectTile(m_windowManager->findWidgetBySubId(subId));
+    }
+    m_pending.clear();
+    m_inFlight.clear();
+    m_startedMs.clear();
+    m_watchdog->stop();
+
+    const bool wasBusy = m_busy;
+    m_running = false;
+    m_busy = false;
+    if (wasBusy) {
+        emit finished();
+    }
+}
+
+void RefreshQueue::pump()
+{
+    if (!m_running) {
+        return;
+    }
+
+    for (int i = 0; i < m_pending.size() && m_inFlight.size() < MAX_CONCURRENT_LOADS; ) {
+        const int subId = m_pending[i];
+        BrowserWidget* widget = m_windowManager->findWidgetBySubId(subId);
+        if (!widget) {
+            m_pending.removeAt(i);  // Left the wall while queued
+            continue;
+        }
+        if (!m_windowManager->isTileOnScreen(widget)) {
+            ++i;
+            continue;
+        }
+
+        m_pending.removeAt(i);
+        m_inFlight.insert(subId, 0);
+        m_startedMs.insert(subId, m_clock.elapsed());
+        connectTile(widget);
+        widget->refresh();
+    }
+
+    if (!m_inFlight.isEmpty()) {
+        m_busy = true;
+        if (!m_watchdog->isActive()) {
+            m_watchdog->start();
+        }
+        updateProgress();
+        return;
+    }
+
+    // Nothing loading and nothing on screen left; off-screen tiles wait for a scroll
+    m_watchdog->stop();
+    if (m_pending.isEmpty()) {
+        m_running = false;
+    }
+    if (m_busy) {
+        m_busy = false;
+        updateProgress();
+        emit finished();
+    }
+}
+
+bool RefreshQueue::isRunning() const
+{
+    return m_running;
+}
+
+int RefreshQueue::deferred() const
+{
+    int count = 0;
+    for (int subId : m_pending) {
+        BrowserWidget* widget = m_windowManager->findWidgetBySubId(subId);
+        if (widget && !m_windowManager->isTileOnScreen(widget)) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+int RefreshQueue::total() const
+{
+    return m_completed + m_inFlight.size() + m_pending.size() - deferred();
+}
+
+int RefreshQueue::completed() const
+{
+    return m_completed;
+}
+
+void RefreshQueue::updateProgress()
+{
+    const int tiles = total();
+    if (tiles <= 0) {
+        return;
+    }
+
+    // Finished tiles count fully, loading ones by their own progress
+    int sum = m_completed * 100;
+    for (int progress : m_inFlight) {
+        sum += progress;
+    }
+    emit progressChanged(sum / tiles, m_completed, tiles);
+}
+
+void RefreshQueue::connectTile(BrowserWidget* widget)
+{
+    connect(widget, &BrowserWidget::loadProgress, this, &RefreshQueue::onTileLoadProgress, Qt::UniqueConnection);
+    connect(widget, &BrowserWidget::loadFinished, this, &RefreshQueue::onTileLoadFinished, Qt::UniqueConnection);
+}
+
+void RefreshQueue::disconnectTile(BrowserWidget* widget)
+{
+    if (widget) {
+        disconnect(widget, &BrowserWidget::loadProgress, this, &RefreshQueue::onTileLoadProgress);
+        disconnect(widget, &BrowserWidget::loadFinished, this, &RefreshQueue::onTileLoadFinished);
+    }
+}
+
+void RefreshQueue::onTileLoadProgress(int progress)
+{
+    BrowserWidget* widget = qobject_cast<BrowserWidget*>(sender());
+    if (!widget || !m_inFlight.contains(widget->getSubWindowId())) {
+        return;
+    }
+    m_inFlight[widget->getSubWindowId()] = qBound(0, progress, 100);
+    updateProgress();
+}
+
+void RefreshQueue::onTileLoadFinished()
+{
+    BrowserWidget* widget = qobject_cast<BrowserWidget*>(sender());
+    if (!widget) {
+        return;
+    }
+    disconnectTile(widget);
+    if (m_inFlight.contains(widget->getSubWindowId())) {
+        finishTile(widget->getSubWindowId());
+    }
+}
+
+void RefreshQueue::onWatchdog()
+{
+    const qint64 now = m_clock.elapsed();
+    for (int subId : m_inFlight.keys()) {
+        if (now - m_startedMs.value(subId) >= LOAD_TIMEOUT_MS) {
+            LOG_WARNING("refresh") << "RefreshQueue: sub window" << subId << "did not finish loading, moving on";
+            disconnectTile(m_windowManager->findWidgetBySubId(subId));
+            finishTile(subId);
+        }
+    }
+}
+
+void RefreshQueue::finishTile(int subId)
+{
+    m_inFlight.remove(subId);
+    m_startedMs.remove(subId);
+    ++m_completed;
+    pump();
+}
@@ -0,0 +1,244 @@
+#include "RefreshScheduler.h"
+#include "WindowManager.h"
+#include "BrowserWidget.h"
+#include "MetricsRegistry.h"
+#include "Log.h"
+#include <QApplication>
+#include <QCryptographicHash>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QRandomGenerator>
+#include <QUrl>
+#include <limits>
+
+const int RefreshScheduler::MIN_INTERVAL_S = 10;
+const int RefreshScheduler::JITTER_PERCENT = 10;
+const int RefreshScheduler::MIN_SPACING_MS = 2000;   // Between two reloads anywhere on the wall
+const int RefreshScheduler::CHECK_TIMEOUT_MS = 10000;
+const int RefreshScheduler::MAX_SKIPPED_CHECKS = 10;
+const int RefreshScheduler::FOCUS_DEFER_MS = 30000;  // Do not reload a page the operator is typing in
+
+RefreshScheduler::RefreshScheduler(WindowManager* windowManager, QObject* parent)
+    : QObject(parent)
+    , m_windowManager(windowManager)
+    , m_network(new QNetworkAccessManager(this))
+    , m_timer(new QTimer(this))
+    , m_pendingSubId(-1)
+    , m_lastReloadMs(-MIN_SPACING_MS)
+{
+    m_clock.start();
+    m_timer->setSingleShot(true);
+    connect(m_timer, &QTimer::timeout, this, &RefreshScheduler::onTimeout);
+}
+
+void RefreshScheduler::setInterval(int subId, int seconds)
+{
+    if (seconds <= 0) {
+        remove(subId);
+        return;
+    }
+    seconds = qMax(seconds, MIN_INTERVAL_S);
+
+    Entry& entry = m_entries[subId];
+    if (entry.intervalSeconds == seconds) {
+        return;
+    }
+
+    // A new sub-window is first due anywhere within its interval, so that sub-windows
+    // loaded together at startup do not come due together
+    const bool isNew = entry.intervalSeconds == 0;
+    entry.intervalSeconds = seconds;
+    entry.dueMs = m_clock.elapsed() + (isNew
+        ? 1 + QRandomGenerator::global()->bounded(qint64(seconds) * 1000)
+        : jitteredIntervalMs(seconds));
+    arm();
+}
+
+int RefreshScheduler::interval(int subId) const
+{
+    return m_entries.value(subId).intervalSeconds;
+}
+
+void RefreshScheduler::remove(int subId)
+{
+    // A check in flight for it finds no entry and is dropped
+    if (m_entries.remove(subId)) {
+        arm();
+    }
+}
+
+void RefreshScheduler::clear()
+{
+    m_entries.clear();
+    if (m_pendingCheck) {
+        m_pendingCheck->abort();
+    }
+    m_timer->stop();
+}
+
+QList<int> RefreshScheduler::subWindowIds() const
+{
+    return m_entries.keys();
+}
+
+qint64 RefreshScheduler::jitteredIntervalMs(int seconds) const
+{
+    const qint64 base = qint64(seconds) * 1000;
+    const qint64 spread = base * JITTER_PERCENT / 100;
+    return base - spread + QRandomGenerator::global()->bounded(2 * spread + 1);
+}
+
+void RefreshScheduler::arm()
+{
+    if (m_pendingCheck || m_entries.isEmpty()) {
+        m_timer->stop();
+        return;
+    }
+
+    qint64 earliest = std::numeric_limits<qint64>::max();
+    for (const Entry& entry : m_entries) {
+        earliest = qMin(earliest, entry.dueMs);
+    }
+
+    const qint64 at = qMax(earliest, m_lastReloadMs + MIN_SPACING_MS);
+    const qint64 delay = qBound<qint64>(0, at - m_clock.elapsed(), std::numeric_limits<int>::max());
+    m_timer->start(static_cast<int>(delay));
+}
+
+void RefreshScheduler::onTimeout()
+{
+    if (m_pendingCheck) {
+        return;
+    }
+
+    // One sub-window per tick: the most overdue one
+    const qint64 now = m_clock.elapsed();
+    int subId = -1;
+    qint64 earliest = std::numeric_limits<qint64>::max();
+    for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+        if (it->dueMs <= now && it->dueMs < earliest) {
+            earliest = it->dueMs;
+            subId = it.key();
+        }
+    }
+    if (subId < 0) {
+        arm();
+        return;
+    }
+
+    Entry& entry = m_entries[subId];
+    BrowserWidget* widget = m_windowManager->findWidgetBySubId(subId);
+    if (!widget || !widget->isVisible()) {
+        // Pool members off the wall are not reloaded; they catch up next interval
+        entry.dueMs = now + jitteredIntervalMs(entry.intervalSeconds);
+        arm();
+        return;
+    }
+    if (widget->isAncestorOf(QApplication::focusWidget())) {
+        entry.dueMs = now + FOCUS_DEFER_MS;
+        arm();
+        return;
+    }
+
+    startCheck(subId, widget->getCurrentUrl());
+}
+
+void RefreshScheduler::startCheck(int subId, const QString& url)
+{
+    QUrl target(url);
+    if (!target.isValid() || (target.scheme() != "http" && target.scheme() != "https")) {
+        complete(subId, "unchecked", true);
+        return;
+    }
+
+    const Entry& entry = m_entries[subId];
+    QNetworkRequest request(target);
+    request.setTransferTimeout(CHECK_TIMEOUT_MS);
+    request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysNetwork);
+    // The check carries no tile cookies: a logged-in page answers it with a redirect to
+    // its login page, which must not be followed and hashed as if it were the content
+    request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::ManualRedirectPolicy);
+    if (entry.checkedUrl == url) {
+        if (!entry.etag.isEmpty()) {
+            request.setRawHeader("If-None-Match", entry.etag);
+        }
+        if (!entry.lastModified.isEmpty()) {
+            request.setRawHeader("If-Modified-Since", entry.lastModified);
+        }
+    }
+
+    m_pendingSubId = subId;
+    m_pendingCheck = m_network->get(request);
+    m_pendingCheck->setProperty("checkedUrl", url);
+    connect(m_pendingCheck, &QNetworkReply::finished, this, &RefreshScheduler::onCheckFinished);
+    m_timer->stop();
+}
+
+void RefreshScheduler::onCheckFinished()
+{
+    QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
+    if (!reply) {
+        return;
+    }
+    reply->deleteLater();
+
+    const int subId = m_pendingSubId;
+    m_pendingCheck = nullptr;
+    m_pendingSubId = -1;
+
+    auto it = m_entries.find(subId);
+    if (it == m_entries.end()) {
+        arm();  // Removed while the check was in flight
+        return;
+    }
+    Entry& entry = *it;
+
+    const QString url = reply->property("checkedUrl").toString();
+    const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+
+    bool unchanged = false;
+    if (status == 304) {
+        unchanged = true;
+    } else if (reply->error() == QNetworkReply::NoError && status == 200) {
+        // The first check has nothing to compare with and counts as changed
+        QByteArray hash = QCryptographicHash::hash(reply->readAll(), QCryptographicHash::Sha1);
+        unchanged = entry.checkedUrl == url && !entry.contentHash.isEmpty() && entry.contentHash == hash;
+        entry.checkedUrl = url;
+        entry.etag = reply->rawHeader("ETag");
+        entry.lastModified = reply->rawHeader("Last-Modified");
+        entry.contentHash = hash;
+    } else {
+        // Errors, redirects and 401/403 say nothing about the tile's content
+        LOG_DEBUG("refresh") << "RefreshScheduler: check failed for sub window" << subId << "status" << status
+                             << reply->errorString() << "- reloading";
+        complete(subId, "failed", true);
+        return;
+    }
+
+    if (!unchanged) {
+        complete(subId, "changed", true);
+    } else if (entry.skippedChecks + 1 >= MAX_SKIPPED_CHECKS) {
+        complete(subId, "forced", true);
+    } else {
+        ++entry.skippedChecks;
+        complete(subId, "unchanged", false);
+    }
+}
+
+void RefreshScheduler::complete(int subId, const QString& result, bool reloadTile)
+{
+    Entry& entry = m_entries[subId];
+    if (reloadTile) {
+        entry.skippedChecks = 0;
+        if (BrowserWidget* widget = m_windowManager->findWidgetBySubId(subId)) {
+            widget->refresh();
+            m_lastReloadMs = m_clock.elapsed();
+        }
+    }
+    MetricsRegistry::getInstance()->increment("bss_auto_refresh_checks", MetricsRegistry::label("result", result));
+
+    entry.dueMs = m_clock.elapsed() + jitteredIntervalMs(entry.intervalSeconds);
+    emit checked(subId, reloadTile);
+    arm();
+}
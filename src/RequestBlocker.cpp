@@ -0,0 +1,199 @@
+#include "RequestBlocker.h"
+#include "MetricsRegistry.h"
+#include "Log.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QUrl>
+#include <QWebEngineUrlRequestInfo>
+
+RequestBlocker* RequestBlocker::instance = nullptr;
+
+RequestBlocker* RequestBlocker::getInstance()
+{
+    if (!instance) {
+        instance = new RequestBlocker(QCoreApplication::instance());
+    }
+    return instance;
+}
+
+RequestBlocker::RequestBlocker(QObject* parent)
+    : QWebEngineUrlRequestInterceptor(parent)
+    , m_enabled(false)
+    , m_blocked(0)
+{
+    if (qEnvironmentVariableIsSet("BSS_BLOCKLIST") && qEnvironmentVariableIntValue("BSS_BLOCKLIST") == 0) {
+        LOG_INFO("blocklist") << "RequestBlocker: disabled by BSS_BLOCKLIST=0";
+        return;
+    }
+
+    // A missing list only costs the savings; tiles load as before
+    m_enabled = m_blocklist.load(defaultPath());
+}
+
+QString RequestBlocker::defaultPath()
+{
+    QString environmentPath = qEnvironmentVariable("BSS_BLOCKLIST_PATH");
+    if (!environmentPath.isEmpty()) {
+        return environmentPath;
+    }
+
+    QString executableDir = QCoreApplication::applicationDirPath();
+    if (executableDir.isEmpty()) {
+        executableDir = QDir::currentPath();
+    }
+    return QDir(executableDir).filePath("blocklist.bin");
+}
+
+const int RequestBlocker::FIRST_PARTY_CACHE_SIZE = 64;  // Pages with a cached first-party domain
+
+// Index of the last '.' before position end, or -1
+static qsizetype previousDot(QByteArrayView host, qsizetype end)
+{
+    for (qsizetype i = end - 1; i >= 0; --i) {
+        if (host[i] == '.') {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Latin-1 copy of an encoded URL component into buffer; longer text goes to overflow
+static QByteArrayView asciiView(QStringView text, char* buffer, qsizetype capacity, QByteArray* overflow)
+{
+    if (text.size() > capacity) {
+        *overflow = text.toLatin1();
+        return *overflow;
+    }
+    for (qsizetype i = 0; i < text.size(); ++i) {
+        buffer[i] = char(text[i].unicode());  // Fully encoded components are ASCII
+    }
+    return QByteArrayView(buffer, text.size());
+}
+
+QByteArrayView RequestBlocker::registrableDomain(QByteArrayView host)
+{
+    // Without a public suffix list: the last two labels, or three under a two-letter
+    // country code with a generic second level ("example.co.uk", "example.com.cn").
+    // Returns a slice of host, so it allocates nothing.
+    static const QByteArrayView genericSecondLevels[] = {
+        "ac", "co", "com", "edu", "go", "gov", "ne", "net", "or", "org"
+    };
+
+    if (host.endsWith('.')) {
+        host.chop(1);
+    }
+
+    // IP literals have no parent domain
+    bool numeric = true;
+    for (char c : host) {
+        if (c == ':') {
+            return host;
+        }
+        numeric = numeric && ((c >= '0' && c <= '9') || c == '.');
+    }
+    if (numeric) {
+        return host;
+    }
+
+    const qsizetype last = previousDot(host, host.size());
+    const qsizetype second = last > 0 ? previousDot(host, last) : -1;
+    if (second < 0) {
+        return host;
+    }
+
+    qsizetype keepFrom = second + 1;
+    const QByteArrayView topLevel = host.sliced(last + 1);
+    const QByteArrayView secondLevel = host.sliced(second + 1, last - second - 1);
+    if (topLevel.size() == 2) {
+        for (QByteArrayView generic : genericSecondLevels) {
+            if (secondLevel == generic) {
+                keepFrom = previousDot(host, second) + 1;
+                break;
+            }
+        }
+    }
+    return host.sliced(keepFrom);
+}
+
+bool RequestBlocker::isSameSite(QByteArrayView host, QByteArrayView firstPartyHost)
+{
+    if (host.isEmpty() || firstPartyHost.isEmpty()) {
+        return false;
+    }
+    return registrableDomain(host) == registrableDomain(firstPartyHost);
+}
+
+QByteArray RequestBlocker::firstPartyDomain(const QUrl& firstPartyUrl)
+{
+    // Keyed by the page's URL: its requests arrive in bursts, so this is nearly always
+    // a hit; the cache is simply dropped when it fills up
+    auto it = m_firstPartyDomains.constFind(firstPartyUrl);
+    if (it != m_firstPartyDomains.constEnd()) {
+        return *it;
+    }
+    if (m_firstPartyDomains.size() >= FIRST_PARTY_CACHE_SIZE) {
+        m_firstPartyDomains.clear();
+    }
+
+    const QByteArray host = firstPartyUrl.host(QUrl::FullyEncoded).toLatin1().toLower();
+    const QByteArray domain = registrableDomain(host).toByteArray();
+    m_firstPartyDomains.insert(firstPartyUrl, domain);
+    return domain;
+}
+
+void RequestBlocker::interceptRequest(QWebEngineUrlRequestInfo& info)
+{
+    // Runs on the UI thread for every subresource of every tile: no allocations beyond
+    // the ones QUrl makes to hand out its components
+    if (!m_enabled || info.resourceType() == QWebEngineUrlRequestInfo::ResourceTypeMainFrame) {
+        return;
+    }
+
+    const QUrl url = info.requestUrl();
+    const QString scheme = url.scheme();
+    if (scheme != QLatin1String("http") && scheme != QLatin1String("https")
+        && scheme != QLatin1String("ws") && scheme != QLatin1String("wss")) {
+        return;  // data:, blob:, qrc: and friends never leave the process
+    }
+
+    // ACE form, as in the lists; QUrl keeps hosts lowercase
+    char hostBuffer[256];
+    char pathBuffer[1024];
+    QByteArray hostOverflow;
+    QByteArray pathOverflow;
+    const QString hostText = url.host(QUrl::FullyEncoded);
+    const QByteArrayView host = asciiView(hostText, hostBuffer, sizeof(hostBuffer), &hostOverflow);
+
+    const QByteArray firstParty = firstPartyDomain(info.firstPartyUrl());
+    if (!firstParty.isEmpty() && registrableDomain(host) == QByteArrayView(firstParty)) {
+        return;
+    }
+
+    const QString pathText = url.path(QUrl::FullyEncoded);
+    const QByteArrayView path = asciiView(pathText, pathBuffer, sizeof(pathBuffer), &pathOverflow);
+    const quint32 categories = m_blocklist.match(host, path);
+    if (categories == 0) {
+        return;
+    }
+
+    info.block(true);
+    m_blocked.fetch_add(1, std::memory_order_relaxed);
+    MetricsRegistry::getInstance()->increment("bss_blocked_requests",
+                                              MetricsRegistry::label("category", Blocklist::categoryName(categories)));
+    LOG_TRACE("blocklist") << "RequestBlocker: blocked" << Blocklist::categoryName(categories) << url.toDisplayString();
+}
+
+bool RequestBlocker::isEnabled() const
+{
+    return m_enabled;
+}
+
+const Blocklist& RequestBlocker::blocklist() const
+{
+    return m_blocklist;
+}
+
+quint64 RequestBlocker::blockedCount() const
+{
+    return m_blocked.load(std::memory_order_relaxed);
+}
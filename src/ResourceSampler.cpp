@@ -0,0 +1,269 @@
+#include "ResourceSampler.h"
+#include "Log.h"
+#include "WindowManager.h"
+#include "BrowserWidget.h"
+#include "Tracer.h"
+#include <QCoreApplication>
+#include <QSet>
+#include <iterator>
+
+const int ResourceSampler::HISTORY_SIZE = 120;
+const int ResourceSampler::MIN_INTERVAL_MS = 1000;
+const int ResourceSampler::MAX_INTERVAL_MS = 10000;
+const int ResourceSampler::COST_BUDGET_PERCENT = 1;
+const int ResourceSampler::PSS_EVERY = 5;
+const int ResourceSampler::DISCOVERY_EVERY = 30;
+
+ResourceSampler::ResourceSampler(WindowManager* windowManager, QObject* parent)
+    : QObject(parent)
+    , m_windowManager(windowManager)
+    , m_timer(new QTimer(this))
+    , m_passCount(0)
+    , m_lastPassCostNs(0)
+{
+    m_timer->setInterval(MIN_INTERVAL_MS);
+    m_timer->setSingleShot(false);
+    connect(m_timer, &QTimer::timeout, this, &ResourceSampler::samplePass);
+}
+
+void ResourceSampler::start()
+{
+    if (!m_timer->isActive()) {
+        m_timer->start();
+    }
+}
+
+void ResourceSampler::stop()
+{
+    m_timer->stop();
+}
+
+bool ResourceSampler::isRunning() const
+{
+    return m_timer->isActive();
+}
+
+void ResourceSampler::samplePass()
+{
+    TRACE_SCOPE("ResourceSampler::samplePass", "resources");
+    const qint64 startNs = ProcStats::monotonicNs();
+    const bool refreshPss = m_passCount % PSS_EVERY == 0;
+
+    // Group sub-windows by renderer so shared processes are read once and split
+    QHash<qint64, QList<int>> tilesByPid;
+    for (BrowserWidget* widget : m_windowManager->getBrowserWidgets()) {
+        if (!widget || widget->getSubWindowId() <= 0) {
+            continue;
+        }
+        qint64 pid = widget->getRendererPid();
+        if (pid > 0) {
+            tilesByPid[pid].append(widget->getSubWindowId());
+        }
+    }
+
+    QHash<qint64, ProcessSample> currentSamples;
+    for (auto it = tilesByPid.constBegin(); it != tilesByPid.constEnd(); ++it) {
+        const qint64 pid = it.key();
+        ProcessSample sample = ProcStats::read(pid);
+        if (!sample.valid) {
+            continue;
+        }
+        currentSamples.insert(pid, sample);
+
+        if (refreshPss || !m_pssCache.contains(pid)) {
+            m_pssCache.insert(pid, ProcStats::readPss(pid));
+        }
+
+        const int share = it.value().size();
+        double cpu = ProcStats::cpuPercent(m_previousSamples.value(pid), sample);
+        qint64 pss = m_pssCache.value(pid, -1);
+
+        ResourceReading reading;
+        reading.timestampNs = sample.sampledAtNs;
+        reading.rendererPid = pid;
+        reading.cpuPercent = cpu >= 0.0 ? cpu / share : -1.0;
+        reading.rssBytes = sample.rssBytes / share;
+        reading.pssBytes = pss >= 0 ? pss / share : -1;
+        reading.threadCount = sample.threadCount;
+        for (int subId : it.value()) {
+            appendReading(subId, reading);
+        }
+    }
+
+    sampleAuxiliaryProcesses(refreshPss, currentSamples);
+
+    // Only processes seen in this pass are kept; exited ones drop out
+    m_previousSamples = currentSamples;
+    m_rendererShares.clear();
+    for (auto it = tilesByPid.constBegin(); it != tilesByPid.constEnd(); ++it) {
+        if (currentSamples.contains(it.key())) {
+            m_rendererShares.insert(it.key(), it.value().size());
+        }
+    }
+    for (auto it = m_pssCache.begin(); it != m_pssCache.end();) {
+        it = currentSamples.contains(it.key()) ? std::next(it) : m_pssCache.erase(it);
+    }
+
+    // Series of sub-windows that no longer have a tile are dropped
+    QSet<int> liveSubIds;
+    for (const QList<int>& subIds : tilesByPid) {
+        for (int subId : subIds) {
+            liveSubIds.insert(subId);
+        }
+    }
+    for (auto it = m_series.begin(); it != m_series.end();) {
+        it = liveSubIds.contains(it.key()) ? std::next(it) : m_series.erase(it);
+    }
+
+    ++m_passCount;
+    m_lastPassCostNs = ProcStats::monotonicNs() - startNs;
+    adaptInterval();
+
+    emit sampled();
+}
+
+void ResourceSampler::sampleAuxiliaryProcesses(bool refreshPss, QHash<qint64, ProcessSample>& currentSamples)
+{
+    const qint64 browserPid = QCoreApplication::applicationPid();
+
+    // The process tree rarely changes; scanning /proc is the most expensive step
+    if (m_passCount % DISCOVERY_EVERY == 0) {
+        m_auxiliaryPids.clear();
+        m_auxiliaryPids.append(browserPid);
+        for (qint64 pid : ProcStats::descendants(browserPid)) {
+            QString type = ProcStats::chromiumProcessType(pid);
+            // Renderers are attributed to tiles; everything else is overhead of the wall
+            if (!type.isEmpty() && type != "renderer") {
+                m_auxiliaryPids.append(pid);
+            }
+        }
+    }
+
+    QList<ProcessUsage> auxiliary;
+    QList<qint64> alive;
+    for (qint64 pid : m_auxiliaryPids) {
+        ProcessSample sample = ProcStats::read(pid);
+        if (!sample.valid) {
+            continue;
+        }
+        alive.append(pid);
+
+        if (refreshPss || !m_pssCache.contains(pid)) {
+            m_pssCache.insert(pid, ProcStats::readPss(pid));
+        }
+
+        ProcessUsage usage;
+        usage.pid = pid;
+        usage.role = pid == browserPid ? QString("browser") : ProcStats::chromiumProcessType(pid);
+        usage.cpuPercent = ProcStats::cpuPercent(m_previousSamples.value(pid), sample);
+        usage.rssBytes = sample.rssBytes;
+        usage.pssBytes = m_pssCache.value(pid, -1);
+        usage.threadCount = sample.threadCount;
+        auxiliary.append(usage);
+
+        currentSamples.insert(pid, sample);
+    }
+
+    m_auxiliaryPids = alive;
+    m_auxiliary = auxiliary;
+}
+
+void ResourceSampler::adaptInterval()
+{
+    // A pass may use at most COST_BUDGET_PERCENT of the interval
+    qint64 neededMs = m_lastPassCostNs * 100 / COST_BUDGET_PERCENT / 1000000;
+    int interval = static_cast<int>(qBound<qint64>(MIN_INTERVAL_MS, neededMs, MAX_INTERVAL_MS));
+    if (interval != m_timer->interval()) {
+        LOG_DEBUG("sampler") << "ResourceSampler: Pass took" << m_lastPassCostNs / 1000 << "us, interval now" << interval << "ms";
+        m_timer->setInterval(interval);
+    }
+}
+
+void ResourceSampler::appendReading(int subId, const ResourceReading& reading)
+{
+    TileSeries& series = m_series[subId];
+    if (series.readings.isEmpty()) {
+        series.readings.resize(HISTORY_SIZE);
+    }
+    series.readings[series.next] = reading;
+    series.next = (series.next + 1) % HISTORY_SIZE;
+    series.count = qMin(series.count + 1, HISTORY_SIZE);
+}
+
+bool ResourceSampler::hasReading(int subId) const
+{
+    auto it = m_series.constFind(subId);
+    return it != m_series.constEnd() && it->count > 0;
+}
+
+ResourceReading ResourceSampler::latest(int subId) const
+{
+    auto it = m_series.constFind(subId);
+    if (it == m_series.constEnd() || it->count == 0) {
+        return ResourceReading();
+    }
+    return it->readings[(it->next + HISTORY_SIZE - 1) % HISTORY_SIZE];
+}
+
+QList<ResourceReading> ResourceSampler::history(int subId) const
+{
+    QList<ResourceReading> result;
+    auto it = m_series.constFind(subId);
+    if (it == m_series.constEnd()) {
+        return result;
+    }
+
+    result.reserve(it->count);
+    const int first = (it->next + HISTORY_SIZE - it->count) % HISTORY_SIZE;
+    for (int i = 0; i < it->count; ++i) {
+        result.append(it->readings[(first + i) % HISTORY_SIZE]);
+    }
+    return result;
+}
+
+QList<ProcessUsage> ResourceSampler::auxiliaryProcesses() const
+{
+    return m_auxiliary;
+}
+
+ResourceTotals ResourceSampler::totals() const
+{
+    ResourceTotals totals;
+    QSet<qint64> countedPids;
+    for (auto it = m_series.constBegin(); it != m_series.constEnd(); ++it) {
+        ResourceReading reading = latest(it.key());
+        if (reading.cpuPercent > totals.busiestCpuPercent) {
+            totals.busiestCpuPercent = reading.cpuPercent;
+            totals.busiestSubId = it.key();
+        }
+
+        const qint64 pid = reading.rendererPid;
+        if (!m_rendererShares.contains(pid) || countedPids.contains(pid)) {
+            continue;  // Stale series, or process already counted
+        }
+        countedPids.insert(pid);
+
+        // Readings are per-tile shares; count the whole process once
+        ++totals.rendererCount;
+        totals.rendererRssBytes += m_previousSamples.value(pid).rssBytes;
+        if (reading.cpuPercent > 0.0) {
+            totals.rendererCpuPercent += reading.cpuPercent * m_rendererShares.value(pid);
+        }
+    }
+
+    for (const ProcessUsage& usage : m_auxiliary) {
+        totals.auxiliaryCpuPercent += qMax(0.0, usage.cpuPercent);
+        totals.auxiliaryRssBytes += qMax<qint64>(0, usage.rssBytes);
+    }
+    return totals;
+}
+
+int ResourceSampler::intervalMs() const
+{
+    return m_timer->interval();
+}
+
+qint64 ResourceSampler::lastPassCostNs() const
+{
+    return m_lastPassCostNs;
+}
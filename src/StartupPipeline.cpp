@@ -0,0 +1,147 @@
+#include "StartupPipeline.h"
+#include "Log.h"
+#include "Tracer.h"
+#include <QStringList>
+
+StartupPipeline* StartupPipeline::instance = nullptr;
+const qint64 StartupPipeline::STARTUP_BUDGET_MS = 3000;
+
+StartupPipeline* StartupPipeline::getInstance()
+{
+    if (!instance) {
+        instance = new StartupPipeline();
+    }
+    return instance;
+}
+
+StartupPipeline::StartupPipeline(QObject* parent)
+    : QObject(parent)
+    , m_lastCompletionNs(0)
+{
+    for (int i = 0; i < StageCount; ++i) {
+        m_done[i] = false;
+        m_results[i] = false;
+        m_durationNs[i] = 0;
+        m_offsetNs[i] = 0;
+    }
+    m_clock.start();
+}
+
+const char* StartupPipeline::stageLabel(Stage stage)
+{
+    switch (stage) {
+        case DatabaseOpen:          return "db-open";
+        case Settings:              return "settings";
+        case SessionCheck:          return "session-check";
+        case RegistryLoad:          return "registry-load";
+        case PoolSizing:            return "pool-sizing";
+        case NavigationScheduling:  return "navigation-scheduling";
+        case FirstPaint:            return "first-paint";
+        default:                    return "unknown";
+    }
+}
+
+QString StartupPipeline::stageName(Stage stage)
+{
+    return QString::fromLatin1(stageLabel(stage));
+}
+
+bool StartupPipeline::runStage(Stage stage, const std::function<bool()>& work)
+{
+    if (stage < 0 || stage >= StageCount) {
+        return false;
+    }
+
+    if (m_done[stage]) {
+        LOG_DEBUG("startup") << "StartupPipeline: Stage" << stageName(stage) << "already ran, skipping";
+        return m_results[stage];
+    }
+
+    // Marked before running so a re-entrant request from inside work() is a no-op
+    m_done[stage] = true;
+
+    QElapsedTimer timer;
+    timer.start();
+    bool result = work ? work() : true;
+    finishStage(stage, timer.nsecsElapsed(), result);
+    return result;
+}
+
+void StartupPipeline::markStage(Stage stage)
+{
+    if (stage < 0 || stage >= StageCount || m_done[stage]) {
+        return;
+    }
+
+    // Observed stages last from the previous completion until now
+    m_done[stage] = true;
+    finishStage(stage, qMax<qint64>(0, m_clock.nsecsElapsed() - m_lastCompletionNs), true);
+}
+
+void StartupPipeline::finishStage(Stage stage, qint64 elapsedNs, bool result)
+{
+    m_results[stage] = result;
+    m_durationNs[stage] = elapsedNs;
+    m_offsetNs[stage] = m_clock.nsecsElapsed();
+    m_lastCompletionNs = m_offsetNs[stage];
+
+    Tracer* tracer = Tracer::getInstance();
+    tracer->record(stageLabel(stage), "startup", tracer->now() - elapsedNs, elapsedNs);
+
+    LOG_DEBUG("startup") << "StartupPipeline:" << stageName(stage) << (result ? "done" : "FAILED") << "in"
+                         << elapsedNs / 1000 << "us, at" << m_offsetNs[stage] / 1000000 << "ms";
+    emit stageCompleted(stage, elapsedNs);
+
+    if (isComplete()) {
+        qint64 totalNs = totalTimeNs();
+        if (totalNs / 1000000 > STARTUP_BUDGET_MS) {
+            LOG_WARNING("startup") << "StartupPipeline: Start-up took" << totalNs / 1000000 << "ms, over the"
+                                   << STARTUP_BUDGET_MS << "ms budget:" << summary();
+        } else {
+            LOG_INFO("startup") << "StartupPipeline: Start-up complete:" << summary();
+        }
+        emit completed(totalNs);
+    }
+}
+
+bool StartupPipeline::isDone(Stage stage) const
+{
+    return stage >= 0 && stage < StageCount && m_done[stage];
+}
+
+bool StartupPipeline::isComplete() const
+{
+    for (int i = 0; i < StageCount; ++i) {
+        if (!m_done[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+qint64 StartupPipeline::stageTimeNs(Stage stage) const
+{
+    return isDone(stage) ? m_durationNs[stage] : 0;
+}
+
+qint64 StartupPipeline::stageOffsetNs(Stage stage) const
+{
+    return isDone(stage) ? m_offsetNs[stage] : 0;
+}
+
+qint64 StartupPipeline::totalTimeNs() const
+{
+    return m_lastCompletionNs;
+}
+
+QString StartupPipeline::summary() const
+{
+    QStringList parts;
+    for (int i = 0; i < StageCount; ++i) {
+        Stage stage = static_cast<Stage>(i);
+        parts.append(isDone(stage)
+            ? QString("%1=%2ms").arg(stageName(stage)).arg(m_durationNs[i] / 1000000.0, 0, 'f', 1)
+            : QString("%1=pending").arg(stageName(stage)));
+    }
+    return QString("total=%1ms ").arg(totalTimeNs() / 1000000.0, 0, 'f', 1) + parts.join(' ');
+}
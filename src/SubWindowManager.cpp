@@ -1,10 +1,11 @@
 #include "SubWindowManager.h"
+#include "Log.h"
 #include "DatabaseManager.h"
+#include "RefreshScheduler.h"
 #include <QHeaderView>
 #include <QUrl>
 #include <QRegularExpression>
 #include <QDateTime>
-#include <QDebug> // Added for qDebug
 #include <QMessageBox> // Added for QMessageBox
 #include <QVBoxLayout> // Added for QVBoxLayout
 #include <QHBoxLayout> // Added for QHBoxLayout
@@ -16,12 +17,16 @@
 #include <QList> // Added for QList
 #include <QJsonArray> // Added for QJsonArray
 #include <QTimer> // Added for delayed updates
+#include <QFile>
+#include <QFileDialog>
+#include <QJsonDocument>
 
 SubWindowManager::SubWindowManager(QWidget *parent)
     : QDialog(parent)
     , m_tableWidget(nullptr)
     , m_addButton(nullptr)
     , m_deleteButton(nullptr)
+    , m_importButton(nullptr)
     , m_refreshButton(nullptr)
     , m_buttonBox(nullptr)
 {
@@ -44,8 +49,8 @@ void SubWindowManager::setupUI()
     
     // Table widget
     m_tableWidget = new QTableWidget(this);
-    m_tableWidget->setColumnCount(5);
-    m_tableWidget->setHorizontalHeaderLabels({"选择", "ID", "名称", "网址", "创建时间"});
+    m_tableWidget->setColumnCount(7);
+    m_tableWidget->setHorizontalHeaderLabels({"选择", "ID", "名称", "网址", "缩略图刷新(秒)", "自动刷新(秒)", "创建时间"});
     
     // Set table properties
     m_tableWidget->setSelectionBehavior(QAbstractItemView::SelectRows);
@@ -61,7 +66,9 @@ void SubWindowManager::setupUI()
     header->setSectionResizeMode(1, QHeaderView::ResizeToContents);  // ID
     header->setSectionResizeMode(2, QHeaderView::Stretch);  // Name
     header->setSectionResizeMode(3, QHeaderView::Stretch);  // URL
-    header->setSectionResizeMode(4, QHeaderView::ResizeToContents);  // Created at
+    header->setSectionResizeMode(4, QHeaderView::ResizeToContents);  // Thumbnail interval
+    header->setSectionResizeMode(5, QHeaderView::ResizeToContents);  // Auto-refresh interval
+    header->setSectionResizeMode(6, QHeaderView::ResizeToContents);  // Created at
 
     // 设置表头居中
     header->setDefaultAlignment(Qt::AlignHCenter | Qt::AlignVCenter);
@@ -91,11 +98,15 @@ void SubWindowManager::setupUI()
     m_deleteButton->setIcon(QIcon(":/icons/delete.png"));
     m_deleteButton->setEnabled(false);
     
+    m_importButton = new QPushButton("导入", this);
+    m_importButton->setToolTip("从 JSON 或文本文件批量导入子窗口（每行: 名称,网址）");
+    
     m_refreshButton = new QPushButton("刷新", this);
     m_refreshButton->setIcon(QIcon(":/icons/refresh.png"));
     
     buttonLayout->addWidget(m_addButton);
     buttonLayout->addWidget(m_deleteButton);
+    buttonLayout->addWidget(m_importButton);
     buttonLayout->addStretch();
     buttonLayout->addWidget(m_refreshButton);
     
@@ -110,11 +121,13 @@ void SubWindowManager::setupConnections()
 {
     connect(m_addButton, &QPushButton::clicked, this, &SubWindowManager::onAddSubWindow);
     connect(m_deleteButton, &QPushButton::clicked, this, &SubWindowManager::onDeleteSubWindow);
+    connect(m_importButton, &QPushButton::clicked, this, &SubWindowManager::onImportSubWindows);
     connect(m_refreshButton, &QPushButton::clicked, this, &SubWindowManager::refreshSubWindows);
     
     // Checkbox changes
     connect(m_tableWidget, &QTableWidget::itemChanged, this, &SubWindowManager::onCheckboxChanged);
     connect(m_tableWidget, &QTableWidget::itemChanged, this, &SubWindowManager::onUrlChanged);
+    connect(m_tableWidget, &QTableWidget::itemChanged, this, &SubWindowManager::onIntervalChanged);
     
     connect(m_tableWidget, &QTableWidget::itemSelectionChanged, 
             this, &SubWindowManager::onSubWindowSelectionChanged);
@@ -134,10 +147,9 @@ void SubWindowManager::loadSubWindows()
 {
     DatabaseManager* dbManager = DatabaseManager::getInstance();
     if (!dbManager) {
-        qWarning() << "SubWindowManager::loadSubWindows: DatabaseManager is null, cannot load subwindows";
+        LOG_WARNING("subwindows") << "SubWindowManager::loadSubWindows: DatabaseManager is null, cannot load subwindows";
         m_subWindows.clear();
         m_tableWidget->setRowCount(0);
-        qDebug() << "=== SubWindowManager::loadSubWindows END (DB null) ===";
         return;
     }
     m_subWindows = dbManager->getAllSubWindows();
@@ -167,7 +179,7 @@ void SubWindowManager::updateSubWindowInTable(int row, const QJsonObject& subWin
 {
     
     if (row < 0 || row >= m_tableWidget->rowCount()) {
-        qWarning() << "Invalid row" << row << "in updateSubWindowInTable";
+        LOG_WARNING("subwindows") << "Invalid row" << row << "in updateSubWindowInTable";
         return;
     }
     
@@ -196,17 +208,30 @@ void SubWindowManager::updateSubWindowInTable(int row, const QJsonObject& subWin
     urlItem->setFlags(urlItem->flags() | Qt::ItemIsEditable);
     m_tableWidget->setItem(row, 3, urlItem);
     
-    // Created at (column 4) - Safe handling: Skip or set 'N/A' if missing/empty
+    // Thumbnail interval (column 4) - seconds between snapshots in thumbnail wall mode
+    QTableWidgetItem* intervalItem = new QTableWidgetItem(
+        QString::number(subWindow.value("thumbnail_interval").toInt(DatabaseManager::DEFAULT_THUMBNAIL_INTERVAL)));
+    intervalItem->setTextAlignment(Qt::AlignCenter);
+    intervalItem->setFlags(intervalItem->flags() | Qt::ItemIsEditable);
+    m_tableWidget->setItem(row, 4, intervalItem);
+    
+    // Auto-refresh interval (column 5) - seconds between scheduled reloads, 0 = off
+    QTableWidgetItem* refreshItem = new QTableWidgetItem(QString::number(subWindow.value("refresh_interval").toInt(0)));
+    refreshItem->setTextAlignment(Qt::AlignCenter);
+    refreshItem->setFlags(refreshItem->flags() | Qt::ItemIsEditable);
+    m_tableWidget->setItem(row, 5, refreshItem);
+    
+    // Created at (column 6) - Safe handling: Skip or set 'N/A' if missing/empty
     QString createdAt = subWindow.value("created_at").toString();
     if (createdAt.isEmpty() || !subWindow.contains("created_at")) {
         createdAt = "N/A";  // Fallback to avoid empty item issues
-        qWarning() << "  Created_at missing/empty for row" << row << ", setting to 'N/A'";
+        LOG_WARNING("subwindows") << "Created_at missing/empty for row" << row << ", setting to 'N/A'";
     } else {
     }
     QTableWidgetItem* createdItem = new QTableWidgetItem(createdAt);
     createdItem->setTextAlignment(Qt::AlignCenter);
     createdItem->setFlags(Qt::ItemIsEnabled);  // Read-only, set after creation
-    m_tableWidget->setItem(row, 4, createdItem);
+    m_tableWidget->setItem(row, 6, createdItem);
     
 }
 
@@ -238,61 +263,154 @@ QJsonObject SubWindowManager::getSubWindowFromTable(int row)
     subWindow["id"] = m_tableWidget->item(row, 1)->text().toInt();  // Skip checkbox
     subWindow["name"] = m_tableWidget->item(row, 2)->text();
     subWindow["url"] = m_tableWidget->item(row, 3)->text();
-    subWindow["created_at"] = m_tableWidget->item(row, 4)->text();
+    subWindow["thumbnail_interval"] = m_tableWidget->item(row, 4)->text().toInt();
+    subWindow["refresh_interval"] = m_tableWidget->item(row, 5)->text().toInt();
+    subWindow["created_at"] = m_tableWidget->item(row, 6)->text();
     return subWindow;
 }
 
+bool SubWindowManager::applyChanges(const SubWindowChangeSet& changes)
+{
+    DatabaseManager* dbManager = DatabaseManager::getInstance();
+    if (!dbManager) {
+        LOG_WARNING("subwindows") << "SubWindowManager::applyChanges: DatabaseManager is null, cannot apply changes";
+        QMessageBox::critical(this, "错误", "数据库未初始化，无法保存子窗口");
+        return false;
+    }
+    
+    SubWindowChangeResult result;
+    if (!dbManager->applySubWindowChanges(changes, &result)) {
+        return false;
+    }
+    
+    refreshSubWindows();
+    if (!result.isEmpty()) {
+        emit subWindowsChanged(result);
+    }
+    return true;
+}
+
 void SubWindowManager::onAddSubWindow()
 {
     SubWindowEditDialog dialog(QJsonObject(), this);
     if (dialog.exec() == QDialog::Accepted) {
         QJsonObject subWindowData = dialog.getSubWindowData();
-        DatabaseManager* dbManager = DatabaseManager::getInstance();
-        if (!dbManager) {
-            qWarning() << "SubWindowManager::onAddSubWindow: DatabaseManager is null, cannot add subwindow";
-            QMessageBox::critical(this, "错误", "数据库未初始化，无法添加子窗口");
-            return;
+        
+        // The change set also creates the matching window_config in the same transaction
+        SubWindowChangeSet changes;
+        changes.added.append(subWindowData);
+        if (!applyChanges(changes)) {
+            QMessageBox::critical(this, "错误", "添加子窗口失败");
         }
-        if (dbManager->addSubWindow(subWindowData["name"].toString(), 
-                                   subWindowData["url"].toString())) {
-            // Get the newly added sub window with ID from database
-            QList<QJsonObject> allSubWindows = dbManager->getAllSubWindows();
-            QJsonObject newSubWindow;
-            for (const QJsonObject& subWindow : allSubWindows) {
-                if (subWindow["name"].toString() == subWindowData["name"].toString() &&
-                    subWindow["url"].toString() == subWindowData["url"].toString()) {
-                    newSubWindow = subWindow;
-                    break;
-                }
+    }
+}
+
+void SubWindowManager::onImportSubWindows()
+{
+    QString filePath = QFileDialog::getOpenFileName(this, "导入子窗口", QString(),
+                                                    "子窗口列表 (*.json *.txt *.csv);;所有文件 (*)");
+    if (filePath.isEmpty()) {
+        return;
+    }
+    
+    QList<QJsonObject> imported = parseImportFile(filePath);
+    
+    SubWindowChangeSet changes;
+    int skipped = 0;
+    for (const QJsonObject& subWindow : imported) {
+        if (subWindow["name"].toString().trimmed().isEmpty() || !isImportableUrl(subWindow["url"].toString())) {
+            ++skipped;
+            continue;
+        }
+        changes.added.append(subWindow);
+    }
+    
+    if (changes.isEmpty()) {
+        QMessageBox::warning(this, "导入失败", "文件中没有有效的子窗口");
+        return;
+    }
+    
+    // One transaction and one wall update for the whole file
+    if (!applyChanges(changes)) {
+        QMessageBox::critical(this, "错误", "导入子窗口失败");
+        return;
+    }
+    
+    QString message = QString("已导入 %1 个子窗口").arg(changes.added.size());
+    if (skipped > 0) {
+        message += QString("，跳过 %1 个无效条目").arg(skipped);
+    }
+    QMessageBox::information(this, "导入完成", message);
+}
+
+bool SubWindowManager::isImportableUrl(const QString& url)
+{
+    const QUrl qurl(url);
+    if (!qurl.isValid()) {
+        return false;
+    }
+    const QString scheme = qurl.scheme().toLower();
+    return ((scheme == "http" || scheme == "https") && !qurl.host().isEmpty())
+        || (scheme == "file" && !qurl.path().isEmpty());
+}
+
+QList<QJsonObject> SubWindowManager::parseImportFile(const QString& filePath)
+{
+    QList<QJsonObject> subWindows;
+    
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        LOG_WARNING("subwindows") << "SubWindowManager::parseImportFile: Failed to open" << filePath << ":" << file.errorString();
+        return subWindows;
+    }
+    QByteArray data = file.readAll();
+    file.close();
+    
+    // JSON: [{"name": ..., "url": ...}, ...]
+    QJsonDocument doc = QJsonDocument::fromJson(data);
+    if (doc.isArray()) {
+        for (const QJsonValue& value : doc.array()) {
+            QJsonObject object = value.toObject();
+            QJsonObject subWindow;
+            subWindow["url"] = object["url"].toString().trimmed();
+            subWindow["name"] = object["name"].toString().trimmed();
+            if (subWindow["name"].toString().isEmpty()) {
+                subWindow["name"] = QUrl(subWindow["url"].toString()).host();
             }
-            
-
-            // Save window_config for the new subwindow
-            if (!newSubWindow.isEmpty()) {
-                int newSubId = newSubWindow["id"].toInt();
-                QString name = newSubWindow["name"].toString();
-                QString url = newSubWindow["url"].toString();
-
-                // Use subId as window_id for window_configs (1:1 mapping with sub_windows)
-                QJsonObject geometry;
-                geometry["x"] = 0;
-                geometry["y"] = 0;
-                geometry["width"] = 500;
-                geometry["height"] = 300;
-
-                if (dbManager->saveWindowConfig(newSubId, newSubId, url, name, geometry)) {
-                } else {
-                    qWarning() << "SubWindowManager::onAddSubWindow: Failed to save window_config for subId:" << newSubId;
+            subWindows.append(subWindow);
+        }
+        return subWindows;
+    }
+    
+    // Text: one sub-window per line, "name,url" or just "url"
+    const QStringList lines = QString::fromUtf8(data).split('\n');
+    for (const QString& rawLine : lines) {
+        QString line = rawLine.trimmed();
+        if (line.isEmpty() || line.startsWith('#')) {
+            continue;
+        }
+        
+        // URLs may contain commas themselves (rison state, query strings), so a line is
+        // only split where the remainder is a URL; a line that is a URL stays whole
+        QJsonObject subWindow;
+        subWindow["url"] = line;
+        if (!isImportableUrl(line)) {
+            for (int comma = line.indexOf(','); comma > 0; comma = line.indexOf(',', comma + 1)) {
+                const QString url = line.mid(comma + 1).trimmed();
+                if (isImportableUrl(url)) {
+                    subWindow["name"] = line.left(comma).trimmed();
+                    subWindow["url"] = url;
+                    break;
                 }
             }
-
-            refreshSubWindows();
-            emit subWindowAdded(newSubWindow);
-            // QMessageBox::information(this, "成功", "子窗口添加成功");
-        } else {
-            QMessageBox::critical(this, "错误", "添加子窗口失败");
         }
+        if (subWindow["name"].toString().isEmpty()) {
+            subWindow["name"] = QUrl(subWindow["url"].toString()).host();
+        }
+        subWindows.append(subWindow);
     }
+    
+    return subWindows;
 }
 
 void SubWindowManager::onDeleteSubWindow()
@@ -324,32 +442,17 @@ void SubWindowManager::onDeleteSubWindow()
                                    QMessageBox::Yes | QMessageBox::No);
     
     if (ret == QMessageBox::Yes) {
-        DatabaseManager* dbManager = DatabaseManager::getInstance();
-        if (!dbManager) {
-            qWarning() << "SubWindowManager::onDeleteSubWindow: DatabaseManager is null, cannot delete subwindows";
-            QMessageBox::critical(this, "错误", "数据库未初始化，无法删除子窗口");
-            return;
-        }
-        bool allSuccess = true;
-        
-        // Sort rows descending to avoid index issues
-        std::sort(checkedRows.begin(), checkedRows.end(), std::greater<int>());
-        
+        // All rows (and their window_configs) go in one transaction and one wall update
+        SubWindowChangeSet changes;
         for (int row : checkedRows) {
             if (row >= 0 && row < m_tableWidget->rowCount()) {
-                QJsonObject subWindowData = getSubWindowFromTable(row);
-                int id = subWindowData["id"].toInt();
-                if (dbManager->deleteSubWindow(id)) {
-                    emit subWindowDeleted(id);
-                } else {
-                    allSuccess = false;
-                }
+                changes.deleted.append(getSubWindowFromTable(row)["id"].toInt());
             }
         }
         
-        refreshSubWindows();
+        bool allSuccess = applyChanges(changes);
         
-        QString message = allSuccess ? "批量删除成功" : "部分删除失败";
+        QString message = allSuccess ? "批量删除成功" : "删除失败";
         QMessageBox::information(this, "操作结果", message);
     }
 }
@@ -417,27 +520,15 @@ void SubWindowManager::onUrlChanged(QTableWidgetItem* item)
     int id = m_tableWidget->item(row, 1)->text().toInt();
     QString name = m_tableWidget->item(row, 2)->text();
     
-    DatabaseManager* dbManager = DatabaseManager::getInstance();
-    if (!dbManager) {
-        qWarning() << "SubWindowManager::onUrlChanged: DatabaseManager is null, cannot update subwindow";
-        QMessageBox::critical(this, "错误", "数据库未初始化，无法更新子窗口");
-        refreshSubWindows();
-        isUpdating = false;
-        return;
-    }
+    QJsonObject updatedData;
+    updatedData["id"] = id;
+    updatedData["name"] = name;
+    updatedData["url"] = newUrl;
     
-    if (dbManager->updateSubWindow(id, name, newUrl)) {
-        // Create updated JSON object
-        QJsonObject updatedData;
-        updatedData["id"] = id;
-        updatedData["name"] = name;
-        updatedData["url"] = newUrl;
-        // Add other fields if needed, e.g., created_at from table
-        if (m_tableWidget->item(row, 4)) {
-            updatedData["created_at"] = m_tableWidget->item(row, 4)->text();
-        }
-        
-        emit subWindowUpdated(updatedData);
+    SubWindowChangeSet changes;
+    changes.updated.append(updatedData);
+    
+    if (applyChanges(changes)) {
         // Removed the success popup as per user request
     } else {
         QMessageBox::critical(this, "错误", "更新网址失败");
@@ -446,12 +537,60 @@ void SubWindowManager::onUrlChanged(QTableWidgetItem* item)
     isUpdating = false;
 }
 
+void SubWindowManager::onIntervalChanged(QTableWidgetItem* item)
+{
+    static bool isUpdating = false;
+    if (isUpdating || !item || (item->column() != 4 && item->column() != 5)) {  // Interval columns (4, 5)
+        return;
+    }
+    isUpdating = true;
+    
+    // Column 4: thumbnail snapshots; column 5: automatic reloads, where 0 turns them off
+    const bool thumbnail = item->column() == 4;
+    const int minimum = thumbnail ? SubWindowEditDialog::MIN_THUMBNAIL_INTERVAL : RefreshScheduler::MIN_INTERVAL_S;
+    const int maximum = thumbnail ? SubWindowEditDialog::MAX_THUMBNAIL_INTERVAL : SubWindowEditDialog::MAX_REFRESH_INTERVAL;
+    const QString what = thumbnail ? "缩略图刷新间隔" : "自动刷新间隔";
+    
+    int row = item->row();
+    bool ok = false;
+    int interval = item->text().trimmed().toInt(&ok);
+    const bool turnedOff = !thumbnail && ok && interval == 0;
+    if (!ok || (!turnedOff && (interval < minimum || interval > maximum))) {
+        QMessageBox::warning(this, "无效间隔", thumbnail
+            ? QString("%1应为 %2 到 %3 秒").arg(what).arg(minimum).arg(maximum)
+            : QString("%1应为 0（关闭）或 %2 到 %3 秒").arg(what).arg(minimum).arg(maximum));
+        refreshSubWindows();  // Revert
+        isUpdating = false;
+        return;
+    }
+    
+    QJsonObject updatedData;
+    updatedData["id"] = m_tableWidget->item(row, 1)->text().toInt();
+    updatedData["name"] = m_tableWidget->item(row, 2)->text();
+    updatedData["url"] = m_tableWidget->item(row, 3)->text();
+    updatedData[thumbnail ? "thumbnail_interval" : "refresh_interval"] = interval;
+    
+    SubWindowChangeSet changes;
+    changes.updated.append(updatedData);
+    if (!applyChanges(changes)) {
+        QMessageBox::critical(this, "错误", QString("更新%1失败").arg(what));
+        refreshSubWindows();  // Revert
+    }
+    isUpdating = false;
+}
+
 // SubWindowEditDialog Implementation
+const int SubWindowEditDialog::MIN_THUMBNAIL_INTERVAL = 5;
+const int SubWindowEditDialog::MAX_THUMBNAIL_INTERVAL = 3600;
+const int SubWindowEditDialog::MAX_REFRESH_INTERVAL = 86400;
+
 SubWindowEditDialog::SubWindowEditDialog(const QJsonObject& subWindow, QWidget *parent)
     : QDialog(parent)
     , m_nameEdit(nullptr)
     , m_urlEdit(nullptr)
     , m_urlStatusLabel(nullptr)
+    , m_thumbnailIntervalSpin(nullptr)
+    , m_refreshIntervalSpin(nullptr)
     , m_buttonBox(nullptr)
     , m_subWindowData(subWindow)
 {
@@ -489,6 +628,31 @@ void SubWindowEditDialog::setupUI()
     m_urlStatusLabel->setStyleSheet("color: red; font-size: 10px;");
     formLayout->addRow("", m_urlStatusLabel);
     
+    m_thumbnailIntervalSpin = new QSpinBox(this);
+    m_thumbnailIntervalSpin->setRange(MIN_THUMBNAIL_INTERVAL, MAX_THUMBNAIL_INTERVAL);
+    m_thumbnailIntervalSpin->setValue(DatabaseManager::DEFAULT_THUMBNAIL_INTERVAL);
+    m_thumbnailIntervalSpin->setSuffix(" 秒");
+    m_thumbnailIntervalSpin->setToolTip("缩略图模式下该子窗口快照的刷新间隔");
+    formLayout->addRow("缩略图刷新:", m_thumbnailIntervalSpin);
+    
+    m_refreshIntervalSpin = new QSpinBox(this);
+    m_refreshIntervalSpin->setRange(0, MAX_REFRESH_INTERVAL);
+    m_refreshIntervalSpin->setSingleStep(30);
+    m_refreshIntervalSpin->setSpecialValueText("关闭");
+    m_refreshIntervalSpin->setSuffix(" 秒");
+    m_refreshIntervalSpin->setToolTip("定时检查页面是否更新，有变化时自动重新加载");
+    // 0 = off; values below the scheduler's minimum snap to it, or back to off when
+    // stepping down. Without keyboard tracking a typed value is only seen once complete.
+    m_refreshIntervalSpin->setKeyboardTracking(false);
+    connect(m_refreshIntervalSpin, QOverload<int>::of(&QSpinBox::valueChanged), this, [this, previous = 0](int value) mutable {
+        if (value > 0 && value < RefreshScheduler::MIN_INTERVAL_S) {
+            m_refreshIntervalSpin->setValue(previous > value ? 0 : RefreshScheduler::MIN_INTERVAL_S);
+            return;
+        }
+        previous = value;
+    });
+    formLayout->addRow("自动刷新:", m_refreshIntervalSpin);
+    
     mainLayout->addLayout(formLayout);
     mainLayout->addStretch();
     
@@ -512,6 +676,8 @@ QJsonObject SubWindowEditDialog::getSubWindowData() const
     QJsonObject data;
     data["name"] = m_nameEdit->text().trimmed();
     data["url"] = m_urlEdit->text().trimmed();
+    data["thumbnail_interval"] = m_thumbnailIntervalSpin->value();
+    data["refresh_interval"] = m_refreshIntervalSpin->value();
     return data;
 }
 
@@ -519,6 +685,8 @@ void SubWindowEditDialog::setSubWindowData(const QJsonObject& subWindow)
 {
     m_nameEdit->setText(subWindow["name"].toString());
     m_urlEdit->setText(subWindow["url"].toString());
+    m_thumbnailIntervalSpin->setValue(subWindow["thumbnail_interval"].toInt(DatabaseManager::DEFAULT_THUMBNAIL_INTERVAL));
+    m_refreshIntervalSpin->setValue(subWindow["refresh_interval"].toInt(0));
 }
 
 void SubWindowEditDialog::onUrlChanged()
@@ -0,0 +1,67 @@
+#include "TileHud.h"
+#include <QStringList>
+
+TileHud::TileHud(QWidget* parent)
+    : QLabel(parent)
+{
+    setAttribute(Qt::WA_TransparentForMouseEvents);
+    setTextFormat(Qt::PlainText);
+    setStyleSheet(R"(
+        QLabel {
+            background-color: rgba(0, 0, 0, 170);
+            color: #7CFC00;
+            font-family: monospace;
+            font-size: 11px;
+            padding: 4px 6px;
+            border-radius: 3px;
+        }
+    )");
+    hide();
+}
+
+void TileHud::setMetrics(const TileMetrics& metrics)
+{
+    auto orDash = [](qint64 value, const QString& text) {
+        return value >= 0 ? text : QString("-");
+    };
+
+    QStringList lines;
+    lines << QString("#%1  PID %2  %3")
+                 .arg(metrics.subWindowId > 0 ? metrics.subWindowId : metrics.windowId)
+                 .arg(metrics.rendererPid > 0 ? QString::number(metrics.rendererPid) : QString("-"))
+                 .arg(metrics.lifecycleState);
+    lines << QString("导航 %1  首绘 %2")
+                 .arg(orDash(metrics.navigationMs, QString("%1 ms").arg(metrics.navigationMs)))
+                 .arg(orDash(metrics.firstPaintMs, QString("%1 ms").arg(metrics.firstPaintMs)));
+    lines << QString("RSS %1  PSS %2")
+                 .arg(orDash(metrics.rssBytes, formatBytes(metrics.rssBytes)))
+                 .arg(orDash(metrics.pssBytes, formatBytes(metrics.pssBytes)));
+    lines << QString("CPU %1  线程 %2")
+                 .arg(metrics.cpuPercent >= 0.0 ? QString("%1%").arg(metrics.cpuPercent, 0, 'f', 1)
+                                                : QString("-"))
+                 .arg(metrics.threadCount);
+    lines << QString("刷新 %1 次").arg(metrics.reloadCount);
+
+    setText(lines.join('\n'));
+    adjustSize();
+    reposition();
+}
+
+void TileHud::reposition()
+{
+    if (parentWidget()) {
+        move(6, 6);
+        raise();
+    }
+}
+
+QString TileHud::formatBytes(qint64 bytes)
+{
+    if (bytes < 0) {
+        return "-";
+    }
+    if (bytes >= 1024LL * 1024 * 1024) {
+        return QString("%1 GB").arg(bytes / (1024.0 * 1024 * 1024), 0, 'f', 2);
+    }
+    return QString("%1 MB").arg(bytes / (1024.0 * 1024), 0, 'f', 1);
+}
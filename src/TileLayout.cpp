@@ -0,0 +1,387 @@
+#include "TileLayout.h"
+#include <QWidget>
+#include <QWidgetItem>
+#include <QRegularExpression>
+#include <QtMath>
+
+TileLayoutSpec TileLayoutSpec::grid(int columns, int rows)
+{
+    TileLayoutSpec spec;
+    spec.columns = qMax(1, columns);
+    spec.rows = qMax(0, rows);
+    return spec;
+}
+
+TileLayoutSpec TileLayoutSpec::featured(int smallTiles)
+{
+    // Three columns: a 2x2 tile in the top-left corner, small tiles flow around it
+    TileLayoutSpec spec;
+    spec.columns = 3;
+
+    TileCell big;
+    big.rowSpan = 2;
+    big.columnSpan = 2;
+    spec.cells.append(big);
+
+    int placed = 0;
+    for (int index = 0; placed < smallTiles; ++index) {
+        int row = index / spec.columns;
+        int column = index % spec.columns;
+        if (row < 2 && column < 2) {
+            continue;  // Covered by the big tile
+        }
+
+        TileCell cell;
+        cell.row = row;
+        cell.column = column;
+        spec.cells.append(cell);
+        ++placed;
+    }
+
+    spec.rows = spec.rowsFor(spec.cells.size());
+    return spec;
+}
+
+TileLayoutSpec TileLayoutSpec::fromPreset(const QString& preset)
+{
+    static const QRegularExpression gridPattern(R"(^(\d+)\s*[xX]\s*(\d+)$)");
+    static const QRegularExpression featuredPattern(R"(^1\s*\+\s*(\d+)$)");
+
+    QString trimmed = preset.trimmed();
+
+    // "CxR": C columns by R rows
+    QRegularExpressionMatch match = gridPattern.match(trimmed);
+    if (match.hasMatch()) {
+        return grid(match.captured(1).toInt(), match.captured(2).toInt());
+    }
+
+    // "1+N": one big tile plus N small ones
+    match = featuredPattern.match(trimmed);
+    if (match.hasMatch()) {
+        return featured(match.captured(1).toInt());
+    }
+
+    return grid(2);
+}
+
+QStringList TileLayoutSpec::presetNames()
+{
+    return {"2x2", "3x3", "3x4", "4x4", "1+5", "1+7"};
+}
+
+QList<TileCell> TileLayoutSpec::placements(int itemCount) const
+{
+    QList<TileCell> result;
+    result.reserve(itemCount);
+
+    const int columnCount = qMax(1, columns);
+    const int explicitCount = qMin(itemCount, static_cast<int>(cells.size()));
+
+    int flowStartRow = 0;
+    for (int i = 0; i < explicitCount; ++i) {
+        result.append(cells[i]);
+        flowStartRow = qMax(flowStartRow, cells[i].row + cells[i].rowSpan);
+    }
+
+    // Items without an explicit cell continue row-major below the explicit ones
+    for (int i = explicitCount; i < itemCount; ++i) {
+        int flowIndex = i - explicitCount;
+        TileCell cell;
+        cell.row = flowStartRow + flowIndex / columnCount;
+        cell.column = flowIndex % columnCount;
+        result.append(cell);
+    }
+
+    return result;
+}
+
+int TileLayoutSpec::rowsFor(int itemCount) const
+{
+    int rowCount = 0;
+    for (const TileCell& cell : placements(itemCount)) {
+        rowCount = qMax(rowCount, cell.row + cell.rowSpan);
+    }
+    return qMax(rows, rowCount);
+}
+
+bool TileLayoutSpec::operator==(const TileLayoutSpec& other) const
+{
+    return rows == other.rows && columns == other.columns && cells == other.cells &&
+           horizontalGap == other.horizontalGap && verticalGap == other.verticalGap &&
+           qFuzzyCompare(aspectRatio + 1.0, other.aspectRatio + 1.0) && cellWidth == other.cellWidth &&
+           minimumCellWidth == other.minimumCellWidth &&
+           qFuzzyCompare(devicePixelRatio, other.devicePixelRatio);
+}
+
+TileLayout::TileLayout(QWidget* parent)
+    : QLayout(parent)
+{
+}
+
+TileLayout::~TileLayout()
+{
+    QLayoutItem* item;
+    while ((item = takeAt(0)) != nullptr) {
+        delete item;
+    }
+}
+
+void TileLayout::setSpec(const TileLayoutSpec& spec)
+{
+    if (m_spec == spec) {
+        return;
+    }
+
+    m_spec = spec;
+    invalidate();
+}
+
+const TileLayoutSpec& TileLayout::spec() const
+{
+    return m_spec;
+}
+
+void TileLayout::setWidgets(const QList<QWidget*>& widgets)
+{
+    QHash<QWidget*, QLayoutItem*> existing;
+    for (QLayoutItem* item : m_items) {
+        if (item->widget()) {
+            existing.insert(item->widget(), item);
+        } else {
+            delete item;
+        }
+    }
+
+    QList<QLayoutItem*> items;
+    items.reserve(widgets.size());
+    for (QWidget* widget : widgets) {
+        QLayoutItem* item = existing.take(widget);
+        if (!item) {
+            addChildWidget(widget);
+            item = new QWidgetItem(widget);
+        }
+        items.append(item);
+    }
+
+    // Items for widgets that left the wall; the widgets themselves stay with the parent
+    if (m_promotedWidget && existing.contains(m_promotedWidget)) {
+        m_promotedWidget = nullptr;
+    }
+    qDeleteAll(existing);
+
+    if (items != m_items) {
+        m_items = items;
+        invalidate();
+    }
+}
+
+void TileLayout::insertWidget(int index, QWidget* widget)
+{
+    if (!widget) {
+        return;
+    }
+
+    addChildWidget(widget);
+    m_items.insert(qBound(0, index, static_cast<int>(m_items.size())), new QWidgetItem(widget));
+    invalidate();
+}
+
+void TileLayout::setPromotedWidget(QWidget* widget, const QRect& rect)
+{
+    QWidget* previous = m_promotedWidget;
+    m_promotedWidget = widget;
+    m_promotedRect = rect;
+
+    // Only the tiles entering or leaving the overlay are touched
+    if (previous && previous != widget) {
+        const QList<QRect> geometries = computeGeometries(geometry());
+        for (int i = 0; i < m_items.size(); ++i) {
+            if (m_items[i]->widget() == previous) {
+                m_items[i]->setGeometry(geometries[i]);
+                break;
+            }
+        }
+    }
+
+    if (widget) {
+        for (QLayoutItem* item : m_items) {
+            if (item->widget() == widget) {
+                if (item->geometry() != rect) {
+                    item->setGeometry(rect);
+                }
+                widget->raise();
+                break;
+            }
+        }
+    }
+}
+
+QWidget* TileLayout::promotedWidget() const
+{
+    return m_promotedWidget;
+}
+
+QSize TileLayout::cellSize(const QRect& rect) const
+{
+    const int columnCount = qMax(1, m_spec.columns);
+
+    int cellWidth = m_spec.cellWidth;
+    if (cellWidth <= 0) {
+        cellWidth = (rect.width() - (columnCount - 1) * m_spec.horizontalGap) / columnCount;
+        cellWidth = snapToDevicePixels(qMax(cellWidth, m_spec.minimumCellWidth));
+    }
+    cellWidth = qMax(1, cellWidth);
+
+    int cellHeight;
+    if (m_spec.aspectRatio > 0.0) {
+        cellHeight = static_cast<int>(cellWidth / m_spec.aspectRatio);
+    } else {
+        int rowCount = qMax(1, m_spec.rowsFor(m_items.size()));
+        cellHeight = (rect.height() - (rowCount - 1) * m_spec.verticalGap) / rowCount;
+    }
+
+    return QSize(cellWidth, qMax(1, snapToDevicePixels(cellHeight)));
+}
+
+QList<QRect> TileLayout::computeGeometries(const QRect& rect) const
+{
+    const QRect contents = rect.marginsRemoved(contentsMargins());
+    const QSize cell = cellSize(contents);
+    const int stepX = cell.width() + m_spec.horizontalGap;
+    const int stepY = cell.height() + m_spec.verticalGap;
+
+    QList<QRect> geometries;
+    geometries.reserve(m_items.size());
+
+    for (const TileCell& placement : m_spec.placements(m_items.size())) {
+        geometries.append(QRect(contents.x() + placement.column * stepX,
+                                contents.y() + placement.row * stepY,
+                                placement.columnSpan * stepX - m_spec.horizontalGap,
+                                placement.rowSpan * stepY - m_spec.verticalGap));
+    }
+
+    return geometries;
+}
+
+int TileLayout::snapToDevicePixels(int logical) const
+{
+    // On fractional scale factors (1.25, 1.5, ...) pick the nearest smaller logical size
+    // that maps to a whole number of device pixels, so pages are not resampled
+    const qreal ratio = m_spec.devicePixelRatio;
+    if (ratio <= 0.0 || qFuzzyCompare(ratio, qRound(ratio) * 1.0)) {
+        return logical;
+    }
+
+    for (int candidate = logical; candidate > 0 && logical - candidate < 8; --candidate) {
+        qreal device = candidate * ratio;
+        if (qAbs(device - qRound(device)) < 0.01) {
+            return candidate;
+        }
+    }
+    return logical;
+}
+
+QSize TileLayout::contentSize(int width) const
+{
+    const QMargins margins = contentsMargins();
+    const int columnCount = qMax(1, m_spec.columns);
+    const int rowCount = m_spec.rowsFor(m_items.size());
+
+    const int gaps = (columnCount - 1) * m_spec.horizontalGap;
+    int contentWidth;
+    if (m_spec.cellWidth > 0) {
+        contentWidth = columnCount * m_spec.cellWidth + gaps;
+    } else {
+        contentWidth = qMax(columnCount * m_spec.minimumCellWidth + gaps,
+                            width - margins.left() - margins.right());
+    }
+
+    QSize cell = cellSize(QRect(0, 0, contentWidth, 0));
+    int contentHeight = 0;
+    if (rowCount > 0 && m_spec.aspectRatio > 0.0) {
+        contentHeight = rowCount * cell.height() + (rowCount - 1) * m_spec.verticalGap;
+    }
+
+    return QSize(contentWidth + margins.left() + margins.right(),
+                 contentHeight + margins.top() + margins.bottom());
+}
+
+void TileLayout::addItem(QLayoutItem* item)
+{
+    m_items.append(item);
+}
+
+int TileLayout::count() const
+{
+    return m_items.size();
+}
+
+QLayoutItem* TileLayout::itemAt(int index) const
+{
+    return m_items.value(index, nullptr);
+}
+
+QLayoutItem* TileLayout::takeAt(int index)
+{
+    if (index < 0 || index >= m_items.size()) {
+        return nullptr;
+    }
+    if (m_promotedWidget && m_items[index]->widget() == m_promotedWidget) {
+        m_promotedWidget = nullptr;
+    }
+    return m_items.takeAt(index);
+}
+
+QSize TileLayout::sizeHint() const
+{
+    int width = geometry().isValid() ? geometry().width() : 0;
+    return contentSize(width);
+}
+
+QSize TileLayout::minimumSize() const
+{
+    // With a fixed cell width the whole wall is the minimum; otherwise cells shrink
+    // with the viewport down to the minimum cell width
+    if (m_spec.cellWidth > 0) {
+        return contentSize(0);
+    }
+
+    const QMargins margins = contentsMargins();
+    const int columnCount = qMax(1, m_spec.columns);
+    int minimumWidth = 0;
+    if (m_spec.minimumCellWidth > 0) {
+        minimumWidth = columnCount * m_spec.minimumCellWidth + (columnCount - 1) * m_spec.horizontalGap;
+    }
+    return QSize(minimumWidth + margins.left() + margins.right(), margins.top() + margins.bottom());
+}
+
+Qt::Orientations TileLayout::expandingDirections() const
+{
+    return m_spec.aspectRatio > 0.0 ? Qt::Horizontal : (Qt::Horizontal | Qt::Vertical);
+}
+
+bool TileLayout::hasHeightForWidth() const
+{
+    return m_spec.cellWidth <= 0 && m_spec.aspectRatio > 0.0;
+}
+
+int TileLayout::heightForWidth(int width) const
+{
+    return contentSize(width).height();
+}
+
+void TileLayout::setGeometry(const QRect& rect)
+{
+    QLayout::setGeometry(rect);
+
+    // One pass over the items; tiles whose rectangle is unchanged are not touched
+    const QList<QRect> geometries = computeGeometries(rect);
+    for (int i = 0; i < m_items.size(); ++i) {
+        QLayoutItem* item = m_items[i];
+        const QRect& target = (m_promotedWidget && item->widget() == m_promotedWidget)
+            ? m_promotedRect : geometries[i];
+        if (item->geometry() != target) {
+            item->setGeometry(target);
+        }
+    }
+}
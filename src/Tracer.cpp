@@ -0,0 +1,192 @@
+#include "Tracer.h"
+#include "Log.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QStandardPaths>
+#include <QStringList>
+#include <QTextStream>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+Tracer* Tracer::instance = nullptr;
+const int Tracer::CAPACITY = 16384;
+
+namespace {
+
+qint64 steadyNowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+QString jsonEscape(const char* text)
+{
+    QString escaped = QString::fromUtf8(text ? text : "");
+    escaped.replace('\\', "\\\\");
+    escaped.replace('"', "\\\"");
+    return escaped;
+}
+
+}
+
+Tracer* Tracer::getInstance()
+{
+    // First call happens at the top of main(), before any other thread exists
+    if (!instance) {
+        instance = new Tracer();
+    }
+    return instance;
+}
+
+Tracer::Tracer()
+    : m_slots(new Slot[CAPACITY])
+    , m_epochNs(steadyNowNs())
+{
+}
+
+qint64 Tracer::now() const
+{
+    return steadyNowNs() - m_epochNs;
+}
+
+int Tracer::currentThreadId()
+{
+    // Small sequential ids read better in trace viewers than native handles
+    static std::atomic<int> nextId{1};
+    thread_local int id = nextId.fetch_add(1, std::memory_order_relaxed);
+    return id;
+}
+
+void Tracer::record(const char* name, const char* category, qint64 startNs, qint64 durationNs, int arg)
+{
+    if (!m_enabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    const quint64 index = m_writeIndex.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = m_slots[index % CAPACITY];
+
+    // Unpublish while writing so a concurrent dump skips the half-written slot
+    slot.sequence.store(0, std::memory_order_release);
+    slot.event.name = name;
+    slot.event.category = category;
+    slot.event.startNs = startNs;
+    slot.event.durationNs = durationNs;
+    slot.event.threadId = currentThreadId();
+    slot.event.arg = arg;
+    slot.sequence.store(index + 1, std::memory_order_release);
+}
+
+void Tracer::instant(const char* name, const char* category, int arg)
+{
+    record(name, category, now(), 0, arg);
+}
+
+void Tracer::setEnabled(bool enabled)
+{
+    m_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool Tracer::isEnabled() const
+{
+    return m_enabled.load(std::memory_order_relaxed);
+}
+
+void Tracer::configure(const QStringList& arguments)
+{
+    if (qEnvironmentVariableIsSet("BSS_TRACE") && qEnvironmentVariableIntValue("BSS_TRACE") == 0) {
+        setEnabled(false);
+    }
+
+    m_exitDumpPath = qEnvironmentVariable("BSS_TRACE_FILE");
+    for (const QString& argument : arguments) {
+        if (argument == "--trace") {
+            m_exitDumpPath = defaultDumpPath();
+        } else if (argument.startsWith("--trace=")) {
+            m_exitDumpPath = argument.mid(QString("--trace=").size());
+        }
+    }
+
+    if (!m_exitDumpPath.isEmpty()) {
+        setEnabled(true);
+    }
+}
+
+QString Tracer::exitDumpPath() const
+{
+    return m_exitDumpPath;
+}
+
+QString Tracer::defaultDumpPath() const
+{
+    QString directory = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
+    if (directory.isEmpty()) {
+        directory = QDir::currentPath();
+    }
+    QDir().mkpath(directory);
+    return QDir(directory).filePath(
+        QString("trace-%1.json").arg(QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss")));
+}
+
+bool Tracer::writeChromeTrace(const QString& path) const
+{
+    // Snapshot the published slots; slots being written right now are skipped
+    std::vector<TraceEvent> events;
+    events.reserve(CAPACITY);
+    const quint64 end = m_writeIndex.load(std::memory_order_acquire);
+    const quint64 begin = end > static_cast<quint64>(CAPACITY) ? end - CAPACITY : 0;
+    for (quint64 index = begin; index < end; ++index) {
+        const Slot& slot = m_slots[index % CAPACITY];
+        if (slot.sequence.load(std::memory_order_acquire) != index + 1) {
+            continue;
+        }
+        TraceEvent event = slot.event;
+        if (slot.sequence.load(std::memory_order_acquire) == index + 1) {
+            events.push_back(event);
+        }
+    }
+
+    std::sort(events.begin(), events.end(), [](const TraceEvent& a, const TraceEvent& b) {
+        return a.startNs < b.startNs;
+    });
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        LOG_WARNING("trace") << "Tracer: Failed to open trace file:" << path << file.errorString();
+        return false;
+    }
+
+    const qint64 pid = QCoreApplication::applicationPid();
+    QTextStream out(&file);
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    bool first = true;
+    for (const TraceEvent& event : events) {
+        if (!first) {
+            out << ",\n";
+        }
+        first = false;
+
+        // Trace-event timestamps are microseconds; keep the nanoseconds as fractions
+        out << "{\"name\":\"" << jsonEscape(event.name) << "\""
+            << ",\"cat\":\"" << jsonEscape(event.category) << "\""
+            << ",\"ph\":\"" << (event.durationNs > 0 ? "X" : "i") << "\""
+            << ",\"ts\":" << QString::number(event.startNs / 1000.0, 'f', 3);
+        if (event.durationNs > 0) {
+            out << ",\"dur\":" << QString::number(event.durationNs / 1000.0, 'f', 3);
+        } else {
+            out << ",\"s\":\"t\"";
+        }
+        out << ",\"pid\":" << pid << ",\"tid\":" << event.threadId;
+        if (event.arg >= 0) {
+            out << ",\"args\":{\"id\":" << event.arg << "}";
+        }
+        out << "}";
+    }
+    out << "\n]}\n";
+
+    LOG_INFO("trace") << "Tracer: Wrote" << events.size() << "events to" << path;
+    return out.status() == QTextStream::Ok;
+}
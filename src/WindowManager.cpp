@@ -2,20 +2,24 @@
 #include <QApplication>
 #include <QDebug>
 #include <QScrollArea>
-#include <QVBoxLayout>
-#include <QHBoxLayout>
 #include <QFrame>
+#include <QElapsedTimer>
+#include <QScrollBar>
+#include <QStyle>
+#include <QScreen>
+#include <QGuiApplication>
 #include "BrowserWidget.h"  // Ensure included for BrowserWidget*
+#include "Tracer.h"
+#include "Log.h"
+#include "EventLoopMonitor.h"
+#include "DatabaseManager.h"
 
 const QList<int> WindowManager::SUPPORTED_WINDOW_COUNTS = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
-const int WindowManager::FIXED_WIDGET_WIDTH = 500;  // 固定宽度
-const int WindowManager::FIXED_WIDGET_HEIGHT = 300; // 固定高度
-
-// 根据5:3比例计算高度
-int WindowManager::calculateHeightFromWidth(int width) const
-{
-    return static_cast<int>(width * 3.0 / 5.0);
-}
+const int WindowManager::MIN_COLUMNS = 1;
+const int WindowManager::MAX_COLUMNS = 8;
+const int WindowManager::MINIMUM_TILE_WIDTH = 340;  // 最小瓦片宽度 (5:3 → 204 高)
+const int WindowManager::RESIZE_DEBOUNCE_MS = 120;
+const int WindowManager::ZOOM_FRAME_MS = 16;  // ~60 Hz
 
 WindowManager::WindowManager(QWidget* parentWidget, QObject *parent)
     : QObject(parent)
@@ -23,17 +27,53 @@ WindowManager::WindowManager(QWidget* parentWidget, QObject *parent)
     , m_gridLayout(nullptr)
     , m_scrollArea(nullptr)
     , m_scrollContent(nullptr)
-    , m_verticalLayout(nullptr)
+    , m_tileLayout(nullptr)
+    , m_lastLayoutTimeNs(0)
     , m_currentWindowCount(0)
     , m_columnCount(2)  // Default to 2 columns
     , m_autoSaveTimer(new QTimer(this))
-    , m_widthSyncTimer(new QTimer(this))
+    , m_resizeDebounceTimer(new QTimer(this))
+    , m_zoomFrameTimer(new QTimer(this))
+    , m_promotedWidget(nullptr)
+    , m_pageCache(new PageCache(24, this))  // 16 visible tiles plus recently used off-screen pages
+    , m_hudVisible(false)
+    , m_thumbnailMode(false)
+    , m_refreshScheduler(new RefreshScheduler(this, this))
+    , m_refreshQueue(new RefreshQueue(this, this))
+    , m_resourceSampler(new ResourceSampler(this, this))
+    , m_metricsCollectorId(0)
 {
+    // Viewport resizes restart this timer; the wall reflows once the drag settles
+    m_resizeDebounceTimer->setInterval(RESIZE_DEBOUNCE_MS);
+    m_resizeDebounceTimer->setSingleShot(true);
+    connect(m_resizeDebounceTimer, &QTimer::timeout, this, &WindowManager::onParentWidgetResized);
+    
+    // Tiles request zoom updates; all requests within a frame are handled in one pass
+    m_zoomFrameTimer->setInterval(ZOOM_FRAME_MS);
+    m_zoomFrameTimer->setSingleShot(true);
+    connect(m_zoomFrameTimer, &QTimer::timeout, this, &WindowManager::onZoomFrame);
+    
+    // Screen metrics are cached here instead of being queried by every tile
+    connect(qApp, &QGuiApplication::primaryScreenChanged, this, &WindowManager::updateScreenMetrics);
+    updateScreenMetrics();
+    
+    // Per-tile resource accounting; readings are pushed to the tiles after each pass
+    connect(m_resourceSampler, &ResourceSampler::sampled, this, &WindowManager::onResourcesSampled);
+    m_resourceSampler->start();
+    
+    // Per-sub-window intervals: snapshot cadence and automatic reloads
+    loadSubWindowSettings();
+    
+    // Wall gauges are filled in when the metrics endpoint is scraped (GUI thread)
+    m_metricsCollectorId = MetricsRegistry::getInstance()->addCollector(
+        [this](MetricsRegistry& registry) { collectMetrics(registry); });
+    
     setupLayout();
     
     // Pre-create fixed pool of 16 BrowserWidgets for reuse (optimization)
     for(int i = 1; i <= 16; i++) {
         BrowserWidget* w = new BrowserWidget(i, m_parentWidget);
+        w->setHudVisible(m_hudVisible);
         m_browserWidgets.append(w);
         connectWidgetSignals(w);
         w->hide();  // Initially hidden
@@ -46,16 +86,11 @@ WindowManager::WindowManager(QWidget* parentWidget, QObject *parent)
     m_autoSaveTimer->setSingleShot(false);
     connect(m_autoSaveTimer, &QTimer::timeout, this, &WindowManager::onAutoSave);
     m_autoSaveTimer->start();
-    
-    // Setup width synchronization timer (check every 2 seconds)
-    m_widthSyncTimer->setInterval(2000);
-    m_widthSyncTimer->setSingleShot(false);
-    connect(m_widthSyncTimer, &QTimer::timeout, this, &WindowManager::onParentWidgetResized);
-    m_widthSyncTimer->start();
 }
 
 WindowManager::~WindowManager()
 {
+    MetricsRegistry::getInstance()->removeCollector(m_metricsCollectorId);
     saveAllStates();
     destroyBrowserWidgets();
 }
@@ -69,20 +104,34 @@ void WindowManager::setupLayout()
     // Create scroll area if it doesn't exist
     if (!m_scrollArea) {
         m_scrollArea = new QScrollArea(m_parentWidget);
-        m_scrollArea->setWidgetResizable(true);
-        m_scrollArea->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+        // Content size is driven from the viewport by resizeScrollContent(), so that
+        // resizes can be debounced instead of reflowing on every intermediate size
+        m_scrollArea->setWidgetResizable(false);
+        m_scrollArea->setHorizontalScrollBarPolicy(Qt::ScrollBarAsNeeded);
         m_scrollArea->setVerticalScrollBarPolicy(Qt::ScrollBarAsNeeded);
         m_scrollArea->setFrameShape(QFrame::NoFrame);
+        m_scrollArea->viewport()->installEventFilter(this);
+        
+        // A promoted tile follows the visible area if the wall scrolls underneath it
+        connect(m_scrollArea->verticalScrollBar(), &QScrollBar::valueChanged,
+                this, &WindowManager::updatePromotedGeometry);
+        connect(m_scrollArea->horizontalScrollBar(), &QScrollBar::valueChanged,
+                this, &WindowManager::updatePromotedGeometry);
+        
+        // Refresh All defers off-screen tiles until they are scrolled into view
+        connect(m_scrollArea->verticalScrollBar(), &QScrollBar::valueChanged,
+                m_refreshQueue, &RefreshQueue::pump);
+        connect(m_scrollArea->horizontalScrollBar(), &QScrollBar::valueChanged,
+                m_refreshQueue, &RefreshQueue::pump);
         
         // Create content widget for scroll area
         m_scrollContent = new QWidget();
         m_scrollArea->setWidget(m_scrollContent);
         
-        // Create vertical layout for content
-        m_verticalLayout = new QVBoxLayout(m_scrollContent);
-        m_verticalLayout->setContentsMargins(5, 5, 5, 5);
-        m_verticalLayout->setSpacing(5);
-        m_verticalLayout->setAlignment(Qt::AlignTop);
+        // Tiles are placed directly on the content widget by the tile layout
+        m_tileLayout = new TileLayout(m_scrollContent);
+        m_tileLayout->setContentsMargins(5, 5, 5, 5);
+        m_tileLayout->setSpec(currentSpec());
         
         // Create main layout for parent widget
         if (!m_gridLayout) {
@@ -103,8 +152,10 @@ void WindowManager::setLayout(int windowCount)
 
 void WindowManager::setLayout(int windowCount, bool forceUpdate)
 {
+    TRACE_SCOPE_ARG("WindowManager::setLayout", "layout", windowCount);
+
     if (!isValidWindowCount(windowCount)) {
-        qWarning() << "Unsupported window count:" << windowCount;
+        LOG_WARNING("layout") << "Unsupported window count:" << windowCount;
         return;
     }
     
@@ -117,9 +168,6 @@ void WindowManager::setLayout(int windowCount, bool forceUpdate)
     updateLayout();
     
     emit layoutChanged(windowCount);
-    if (windowCount > 0 && m_browserWidgets.size() >= windowCount) {
-        emit allWidgetsCreated();
-    }
 }
 
 int WindowManager::getCurrentWindowCount() const
@@ -143,22 +191,19 @@ BrowserWidget* WindowManager::getBrowserWidget(int index) const
 void WindowManager::addBrowserWidget()
 {
     if (m_browserWidgets.size() >= 16) {
-        qWarning() << "Maximum number of browser widgets reached (16)";
+        LOG_WARNING("layout") << "Maximum number of browser widgets reached (16)";
         return;
     }
     
     int newIndex = m_browserWidgets.size();
     BrowserWidget* newWidget = new BrowserWidget(newIndex + 1, m_parentWidget);
+    newWidget->setHudVisible(m_hudVisible);
+    newWidget->setThumbnailMode(m_thumbnailMode);
     
     m_browserWidgets.append(newWidget);
     connectWidgetSignals(newWidget);
     
-    // Set widget size based on column count
-    int widgetWidth = (m_columnCount == 1) ? 880 : 500;
-    int widgetHeight = calculateHeightFromWidth(widgetWidth); // 根据5:3比例计算高度
-    newWidget->setFixedSize(widgetWidth, widgetHeight);
-    
-    // Rebuild the entire layout to maintain proper row structure
+    // Sizing and placement are handled by the incremental layout pass
     updateLayout();
     
     emit widgetAdded(newWidget);
@@ -182,7 +227,7 @@ void WindowManager::removeBrowserWidget(int index)
         m_browserWidgets[i]->setWindowId(i + 1);
     }
     
-    // Rebuild the entire layout to maintain proper row structure
+    // Only the tiles after the removed one shift slots
     updateLayout();
     
     emit widgetRemoved(index);
@@ -251,66 +296,312 @@ bool WindowManager::isValidWindowCount(int windowCount)
 
 void WindowManager::updateLayout()
 {
-    if (!m_verticalLayout) {
-        qDebug() << "WindowManager::updateLayout: ERROR - m_verticalLayout is null, returning";
-        qDebug() << "=== WindowManager::updateLayout END (null layout) ===";
+    STALL_SCOPE("WindowManager::updateLayout");
+    if (!m_tileLayout) {
+        LOG_WARNING("layout") << "WindowManager::updateLayout: ERROR - m_tileLayout is null, returning";
         return;
     }
-    
-    QLayoutItem* item;
-    while ((item = m_verticalLayout->takeAt(0)) != nullptr) {
-        if (QWidget* w = item->widget()) {
-            w->hide();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    const int visibleCount = qMin(m_currentWindowCount, static_cast<int>(m_browserWidgets.size()));
+
+    QList<QWidget*> visibleTiles;
+    QList<QRect> previousGeometries;
+    visibleTiles.reserve(visibleCount);
+    previousGeometries.reserve(visibleCount);
+    for (int i = 0; i < visibleCount; ++i) {
+        visibleTiles.append(m_browserWidgets[i]);
+        previousGeometries.append(m_browserWidgets[i]->geometry());
+    }
+
+    // A promoted tile that leaves the wall is dropped from the overlay
+    if (m_promotedWidget && !visibleTiles.contains(m_promotedWidget)) {
+        demoteWidget();
+    }
+
+    // One spec + item update, then a single geometry pass that only touches changed tiles
+    m_tileLayout->setSpec(currentSpec());
+    m_tileLayout->setWidgets(visibleTiles);
+    resizeScrollContent();
+
+    for (int i = 0; i < m_browserWidgets.size(); ++i) {
+        BrowserWidget* widget = m_browserWidgets[i];
+        bool shouldShow = i < visibleCount;
+        if (widget->isHidden() == shouldShow) {
+            widget->setVisible(shouldShow);
         }
-        delete item;
     }
+
+    m_tileLayout->activate();
+
+    int movedTiles = 0;
+    for (int i = 0; i < visibleCount; ++i) {
+        if (m_browserWidgets[i]->geometry() != previousGeometries[i]) {
+            ++movedTiles;
+        }
+    }
+
+    m_lastLayoutTimeNs = timer.nsecsElapsed();
+    emit layoutUpdated(movedTiles, m_lastLayoutTimeNs);
     
-    if (m_currentWindowCount == 0) {
-        for (auto w : m_browserWidgets) w->hide();
+    // Tiles may have moved into view
+    m_refreshQueue->pump();
+}
+
+TileLayoutSpec WindowManager::currentSpec() const
+{
+    TileLayoutSpec spec = m_layoutPreset.isEmpty()
+        ? TileLayoutSpec::grid(m_columnCount)
+        : TileLayoutSpec::fromPreset(m_layoutPreset);
+
+    // Cells are derived from the viewport: fixed-row presets fill the visible area,
+    // open-ended grids keep 5:3 tiles across the full width and scroll vertically
+    spec.cellWidth = 0;
+    spec.minimumCellWidth = MINIMUM_TILE_WIDTH;
+    if (spec.rows > 0) {
+        spec.aspectRatio = 0.0;
+    }
+    if (m_scrollArea) {
+        spec.devicePixelRatio = m_scrollArea->devicePixelRatioF();
+    }
+    return spec;
+}
+
+void WindowManager::resizeScrollContent()
+{
+    if (!m_scrollArea || !m_scrollContent || !m_tileLayout) {
         return;
     }
     
-    int visibleIndex = 0;
-    for (int i = 0; i < m_currentWindowCount; i += m_columnCount) {
-        QWidget* rowContainer = new QWidget();
-        QHBoxLayout* rowLayout = new QHBoxLayout(rowContainer);
-        rowLayout->setContentsMargins(0, 0, 0, 0);
-        rowLayout->setSpacing(5);
-        
-        int widgetsInRow = 0;
-        for (int j = 0; j < m_columnCount && (i + j) < m_currentWindowCount; ++j) {
-            if (visibleIndex < m_browserWidgets.size()) {
-                BrowserWidget* widget = m_browserWidgets[visibleIndex];
-                
-                int widgetWidth = (m_columnCount == 1) ? 880 : 500;
-                int widgetHeight = calculateHeightFromWidth(widgetWidth);
-                widget->setFixedSize(widgetWidth, widgetHeight);
-                
-                widget->show();
-                rowLayout->addWidget(widget);
-                widgetsInRow++;
-                visibleIndex++;
+    const QSize viewport = m_scrollArea->viewport()->size();
+    int width = qMax(viewport.width(), m_tileLayout->minimumSize().width());
+    int height = viewport.height();
+    if (m_tileLayout->hasHeightForWidth()) {
+        height = qMax(height, m_tileLayout->heightForWidth(width));
+    }
+    
+    // A vertical scrollbar takes width from the viewport; size for it up front so the
+    // wall does not reflow a second time when the bar appears
+    if (height > viewport.height() && m_tileLayout->hasHeightForWidth() &&
+        m_scrollArea->verticalScrollBarPolicy() != Qt::ScrollBarAlwaysOff &&
+        !m_scrollArea->verticalScrollBar()->isVisible()) {
+        int scrollBarWidth = m_scrollArea->style()->pixelMetric(QStyle::PM_ScrollBarExtent);
+        width = qMax(width - scrollBarWidth, m_tileLayout->minimumSize().width());
+        height = qMax(viewport.height(), m_tileLayout->heightForWidth(width));
+    }
+    
+    if (m_scrollContent->size() != QSize(width, height)) {
+        m_scrollContent->resize(width, height);
+    }
+}
+
+bool WindowManager::eventFilter(QObject* watched, QEvent* event)
+{
+    if (m_scrollArea && watched == m_scrollArea->viewport()) {
+        switch (event->type()) {
+        case QEvent::Resize:
+            // The overlay is a single tile and follows immediately; the wall is debounced
+            updatePromotedGeometry();
+            m_resizeDebounceTimer->start();
+            break;
+        case QEvent::Wheel:
+            // Wheel events the page did not consume must not scroll the wall under the overlay
+            if (m_promotedWidget) {
+                return true;
             }
+            break;
+#if QT_VERSION >= QT_VERSION_CHECK(6, 6, 0)
+        case QEvent::DevicePixelRatioChange:
+#endif
+        case QEvent::ScreenChangeInternal:
+            // Moved to a screen with a different scale factor: re-snap the cells
+            m_resizeDebounceTimer->start();
+            break;
+        default:
+            break;
         }
-        
-        rowLayout->addStretch();
-        m_verticalLayout->addWidget(rowContainer);
     }
+    return QObject::eventFilter(watched, event);
+}
+
+qint64 WindowManager::lastLayoutTimeNs() const
+{
+    return m_lastLayoutTimeNs;
+}
+
+int WindowManager::layoutItemCount() const
+{
+    return m_tileLayout ? m_tileLayout->count() : 0;
+}
+
+int WindowManager::contentWidgetCount() const
+{
+    return m_scrollContent ? m_scrollContent->findChildren<QWidget*>(QString(), Qt::FindDirectChildrenOnly).size() : 0;
+}
+
+void WindowManager::setHudVisible(bool visible)
+{
+    m_hudVisible = visible;
+    for (BrowserWidget* widget : m_browserWidgets) {
+        if (widget) {
+            widget->setHudVisible(visible);
+        }
+    }
+}
+
+bool WindowManager::isHudVisible() const
+{
+    return m_hudVisible;
+}
+
+void WindowManager::setThumbnailMode(bool enabled)
+{
+    if (m_thumbnailMode == enabled) {
+        return;
+    }
+    m_thumbnailMode = enabled;
+    
+    // Intervals may have been edited while the mode was off
+    if (enabled) {
+        loadSubWindowSettings();
+    }
+    for (BrowserWidget* widget : m_browserWidgets) {
+        if (!widget) {
+            continue;
+        }
+        if (widget->getSubWindowId() > 0) {
+            widget->setThumbnailInterval(m_thumbnailIntervals.value(widget->getSubWindowId(),
+                                                                    DatabaseManager::DEFAULT_THUMBNAIL_INTERVAL));
+        }
+        widget->setThumbnailMode(enabled);
+    }
+}
+
+bool WindowManager::isThumbnailMode() const
+{
+    return m_thumbnailMode;
+}
+
+void WindowManager::loadSubWindowSettings()
+{
+    m_thumbnailIntervals.clear();
+    QList<int> scheduled = m_refreshScheduler->subWindowIds();
+    QSet<int> stale(scheduled.begin(), scheduled.end());
     
-    for (int i = m_currentWindowCount; i < m_browserWidgets.size(); ++i) {
-        m_browserWidgets[i]->hide();
+    for (const QJsonObject& subWindow : DatabaseManager::getInstance()->getAllSubWindows()) {
+        const int subId = subWindow["id"].toInt();
+        m_thumbnailIntervals.insert(subId, subWindow["thumbnail_interval"].toInt());
+        m_refreshScheduler->setInterval(subId, subWindow["refresh_interval"].toInt());
+        stale.remove(subId);
+    }
+    for (int subId : stale) {
+        m_refreshScheduler->remove(subId);
+    }
+}
+
+void WindowManager::stopRefreshing()
+{
+    m_refreshQueue->cancel();
+    m_refreshScheduler->clear();
+}
+
+RefreshScheduler* WindowManager::getRefreshScheduler() const
+{
+    return m_refreshScheduler;
+}
+
+RefreshQueue* WindowManager::getRefreshQueue() const
+{
+    return m_refreshQueue;
+}
+
+bool WindowManager::isTileOnScreen(BrowserWidget* widget) const
+{
+    if (!widget || widget->isHidden() || !m_scrollArea || !m_scrollContent) {
+        return false;
+    }
+    if (widget == m_promotedWidget) {
+        return true;
     }
     
-    m_verticalLayout->addStretch();
+    // Tiles are children of the scroll content; its position is the negated scroll offset
+    QRect visibleArea(-m_scrollContent->pos(), m_scrollArea->viewport()->size());
+    return widget->geometry().intersects(visibleArea);
+}
+
+ResourceSampler* WindowManager::getResourceSampler() const
+{
+    return m_resourceSampler;
+}
+
+void WindowManager::collectMetrics(MetricsRegistry& registry) const
+{
+    int live = 0;
+    int frozen = 0;
+    int discarded = 0;
+
+    registry.clearGauge("bss_renderer_rss_bytes");
+    registry.clearGauge("bss_renderer_pss_bytes");
+    registry.clearGauge("bss_renderer_cpu_ratio");
+
+    for (BrowserWidget* widget : m_browserWidgets) {
+        if (!widget || widget->getSubWindowId() <= 0) {
+            continue;
+        }
+
+        TileMetrics metrics = widget->getTileMetrics();
+        switch (metrics.lifecycle) {
+        case TileLifecycle::Active:
+            ++live;
+            break;
+        case TileLifecycle::Frozen:
+            ++frozen;
+            break;
+        case TileLifecycle::Discarded:
+            ++discarded;
+            break;
+        case TileLifecycle::NoPage:
+            break;  // Assigned but not loaded yet: neither live nor suspended
+        }
+
+        const QString labels = MetricsRegistry::label("sub_window", metrics.subWindowId);
+        if (metrics.rssBytes >= 0) {
+            registry.setGauge("bss_renderer_rss_bytes", labels, metrics.rssBytes);
+        }
+        if (metrics.pssBytes >= 0) {
+            registry.setGauge("bss_renderer_pss_bytes", labels, metrics.pssBytes);
+        }
+        if (metrics.cpuPercent >= 0.0) {
+            registry.setGauge("bss_renderer_cpu_ratio", labels, metrics.cpuPercent / 100.0);
+        }
+    }
+
+    registry.setGauge("bss_tiles", MetricsRegistry::label("state", "live"), live);
+    registry.setGauge("bss_tiles", MetricsRegistry::label("state", "frozen"), frozen);
+    registry.setGauge("bss_tiles", MetricsRegistry::label("state", "discarded"), discarded);
+}
+
+void WindowManager::onResourcesSampled()
+{
+    for (BrowserWidget* widget : m_browserWidgets) {
+        if (widget && m_resourceSampler->hasReading(widget->getSubWindowId())) {
+            widget->setResourceReading(m_resourceSampler->latest(widget->getSubWindowId()));
+        }
+    }
 }
 
 void WindowManager::connectWidgetSignals(BrowserWidget* widget)
 {
     if (!widget) return;
+    widget->setScreenSize(m_screenSize);
     connect(widget, &BrowserWidget::fullscreenRequested, 
             this, &WindowManager::onWidgetFullscreenRequested);
     connect(widget, &BrowserWidget::closeRequested, 
             this, &WindowManager::onWidgetCloseRequested);
+    connect(widget, &BrowserWidget::zoomUpdateRequested, 
+            this, &WindowManager::onZoomUpdateRequested);
 }
 
 void WindowManager::disconnectWidgetSignals(BrowserWidget* widget)
@@ -320,6 +611,12 @@ void WindowManager::disconnectWidgetSignals(BrowserWidget* widget)
                this, &WindowManager::onWidgetFullscreenRequested);
     disconnect(widget, &BrowserWidget::closeRequested, 
                this, &WindowManager::onWidgetCloseRequested);
+    disconnect(widget, &BrowserWidget::zoomUpdateRequested, 
+               this, &WindowManager::onZoomUpdateRequested);
+    m_pendingZoomTiles.remove(widget);
+    if (m_promotedWidget == widget) {
+        demoteWidget();
+    }
 }
 
 void WindowManager::destroyBrowserWidgets()
@@ -339,7 +636,7 @@ void WindowManager::onWidgetFullscreenRequested()
     if (widget) {
         emit fullscreenRequested(widget);
     } else {
-        qDebug() << "WindowManager::onWidgetFullscreenRequested: Failed to cast sender to BrowserWidget";
+        LOG_WARNING("layout") << "WindowManager::onWidgetFullscreenRequested: Failed to cast sender to BrowserWidget";
     }
 }
 
@@ -359,22 +656,78 @@ void WindowManager::onAutoSave()
     saveAllStates();
 }
 
+void WindowManager::onZoomUpdateRequested()
+{
+    scheduleZoomUpdate(qobject_cast<BrowserWidget*>(sender()));
+}
+
+void WindowManager::scheduleZoomUpdate(BrowserWidget* widget)
+{
+    if (!widget) {
+        return;
+    }
+    
+    m_pendingZoomTiles.insert(widget);
+    if (!m_zoomFrameTimer->isActive()) {
+        m_zoomFrameTimer->start();
+    }
+}
+
+void WindowManager::onZoomFrame()
+{
+    // Each tile is zoomed at most once per frame, with its final geometry for that frame
+    const QSet<BrowserWidget*> tiles = m_pendingZoomTiles;
+    m_pendingZoomTiles.clear();
+    
+    for (BrowserWidget* widget : tiles) {
+        if (widget->isVisible()) {
+            widget->updateWebViewResolution();
+        }
+    }
+}
+
+void WindowManager::updateScreenMetrics()
+{
+    QScreen* screen = QGuiApplication::primaryScreen();
+    if (!screen) {
+        return;
+    }
+    
+    // Track geometry changes of the current primary screen (resolution / scaling changes)
+    connect(screen, &QScreen::geometryChanged, this, &WindowManager::updateScreenMetrics, Qt::UniqueConnection);
+    
+    QSize screenSize = screen->geometry().size();
+    if (screenSize == m_screenSize) {
+        return;
+    }
+    
+    m_screenSize = screenSize;
+    for (BrowserWidget* widget : m_browserWidgets) {
+        widget->setScreenSize(m_screenSize);
+        scheduleZoomUpdate(widget);
+    }
+}
+
 void WindowManager::onParentWidgetResized()
 {
-    // With fixed size layout, widgets don't need to be resized
-    // This method is kept for compatibility but does nothing
-    return;
+    if (!m_tileLayout) {
+        return;
+    }
+    
+    // Debounced: runs once after the viewport stopped changing size
+    m_tileLayout->setSpec(currentSpec());
+    resizeScrollContent();
 }
 
 void WindowManager::forceLayoutUpdate()
 {
-    if (!m_verticalLayout) {
+    if (!m_tileLayout) {
         return;
     }
     
     // Force the layout to recalculate and update
-    m_verticalLayout->invalidate();
-    m_verticalLayout->activate();
+    m_tileLayout->invalidate();
+    m_tileLayout->activate();
     
     // Force the parent widget to update its layout
     if (m_parentWidget) {
@@ -383,114 +736,84 @@ void WindowManager::forceLayoutUpdate()
     }
 }
 
-void WindowManager::detachWidgetFromLayout(BrowserWidget* widget)
+QRect WindowManager::overlayRect() const
 {
-    if (!widget) {
-        return;
+    if (!m_scrollArea || !m_scrollContent) {
+        return QRect();
     }
     
-    
-    // For row-based layout, we need to rebuild the entire layout
-    // when detaching widgets to maintain proper row structure
-    // But we need to be careful not to destroy the widget we're detaching
-    if (m_verticalLayout) {
-        // Remove the widget from the layout without destroying it
-        m_verticalLayout->removeWidget(widget);
-        m_verticalLayout->invalidate();
-        m_verticalLayout->activate();
-        
-        if (m_parentWidget) {
-            m_parentWidget->updateGeometry();
-            m_parentWidget->update();
-        }
+    // The visible viewport, in scroll content coordinates
+    return QRect(-m_scrollContent->pos(), m_scrollArea->viewport()->size());
+}
+
+void WindowManager::updatePromotedGeometry()
+{
+    if (m_promotedWidget && m_tileLayout) {
+        m_tileLayout->setPromotedWidget(m_promotedWidget, overlayRect());
     }
 }
 
-void WindowManager::attachWidgetToLayout(BrowserWidget* widget, int position)
+void WindowManager::promoteWidget(BrowserWidget* widget)
 {
-    if (!widget) {
+    if (!widget || !m_tileLayout || widget == m_promotedWidget) {
         return;
     }
     
-    // Set widget size based on column count
-    int widgetWidth = (m_columnCount == 1) ? 880 : 500;
-    int widgetHeight = calculateHeightFromWidth(widgetWidth); // 根据5:3比例计算高度
-    widget->setFixedSize(widgetWidth, widgetHeight);
-    
-    // Calculate which row and column this widget should go to
-    int row = position / m_columnCount;
-    int col = position % m_columnCount;
-    
-    // Find the correct row container and add the widget to it
-    if (m_verticalLayout && row < m_verticalLayout->count()) {
-        QLayoutItem* rowItem = m_verticalLayout->itemAt(row);
-        if (rowItem && rowItem->widget()) {
-            QWidget* rowContainer = rowItem->widget();
-            QHBoxLayout* rowLayout = qobject_cast<QHBoxLayout*>(rowContainer->layout());
-            if (rowLayout) {
-                // Insert the widget at the correct column position
-                rowLayout->insertWidget(col, widget);
-                
-                // Force layout update
-                m_verticalLayout->invalidate();
-                m_verticalLayout->activate();
-                
-                if (m_parentWidget) {
-                    m_parentWidget->updateGeometry();
-                    m_parentWidget->update();
-                }
-
-                return;
-            }
-        }
-    }
+    // One geometry change on one tile: no reparenting, no re-layout of the wall
+    m_promotedWidget = widget;
+    m_tileLayout->setPromotedWidget(widget, overlayRect());
+    widget->setFocus();
     
-    // If we can't find the correct position, fall back to updateLayout
-    updateLayout();
+    emit promotionChanged(widget);
 }
 
-void WindowManager::synchronizeWidgetWidths()
+void WindowManager::demoteWidget()
 {
-    // With fixed size layout, all widgets already have consistent sizes
-    // No need to synchronize widths
-    return;
+    if (!m_promotedWidget || !m_tileLayout) {
+        return;
+    }
+    
+    // The tile returns to its cell; the rest of the wall was never moved
+    m_promotedWidget = nullptr;
+    m_tileLayout->setPromotedWidget(nullptr);
+    
+    emit promotionChanged(nullptr);
 }
 
-void WindowManager::ensureConsistentWidths()
+BrowserWidget* WindowManager::getPromotedWidget() const
 {
-    // With fixed size layout, all widgets already have consistent sizes
-    // No need to ensure consistent widths
-    return;
+    return m_promotedWidget;
 }
 
-int WindowManager::calculateDynamicWidth() const
+void WindowManager::detachWidgetFromLayout(BrowserWidget* widget)
 {
-    if (!m_parentWidget || !m_gridLayout) {
-        return FIXED_WIDGET_WIDTH;
+    if (!widget || !m_tileLayout) {
+        return;
     }
     
-    // Calculate width based on parent widget width
-    int parentWidth = m_parentWidget->width();
-    if (parentWidth <= 0) {
-        return FIXED_WIDGET_WIDTH;
+    // Remove the widget from the wall without touching the other tiles
+    m_tileLayout->removeWidget(widget);
+}
+
+void WindowManager::attachWidgetToLayout(BrowserWidget* widget, int position)
+{
+    if (!widget || position < 0 || !m_tileLayout) {
+        return;
     }
     
-    // Account for margins and spacing
-    int margins = m_gridLayout->contentsMargins().left() + m_gridLayout->contentsMargins().right();
-    int spacing = m_gridLayout->spacing();
-    
-    // Calculate width per column based on column count
-    int availableWidth = parentWidth - margins - (spacing * (m_columnCount - 1));
-    int widthPerColumn = availableWidth / m_columnCount;
-    
-    // Ensure minimum width
-    return qMax(widthPerColumn, FIXED_WIDGET_WIDTH);
+    // Put the widget back into its slot; the layout sizes it from the current spec
+    m_tileLayout->insertWidget(position, widget);
+    m_tileLayout->activate();
 }
 
 void WindowManager::setColumnCount(int columns)
 {
-    if (columns < 1 || columns > 3) {
-        qWarning() << "Invalid column count:" << columns << "Must be 1, 2, or 3";
+    if (columns < MIN_COLUMNS || columns > MAX_COLUMNS) {
+        LOG_WARNING("layout") << "Invalid column count:" << columns << "Must be between" << MIN_COLUMNS << "and" << MAX_COLUMNS;
+        return;
+    }
+    
+    if (m_columnCount == columns) {
         return;
     }
     
@@ -502,26 +825,191 @@ void WindowManager::setColumnCount(int columns)
 
 int WindowManager::getColumnCount() const
 {
-    return m_columnCount;
+    return m_layoutPreset.isEmpty() ? m_columnCount : TileLayoutSpec::fromPreset(m_layoutPreset).columns;
+}
+
+void WindowManager::setLayoutPreset(const QString& preset)
+{
+    if (m_layoutPreset == preset) {
+        return;
+    }
+
+    m_layoutPreset = preset;
+    updateLayout();
+}
+
+QString WindowManager::getLayoutPreset() const
+{
+    return m_layoutPreset;
 }
 
 void WindowManager::updateWidgetContent(int index, int subId, const QString& name, const QString& url)
 {
     if (index < 0 || index >= m_browserWidgets.size()) {
-        qWarning() << "Invalid widget index:" << index;
+        LOG_WARNING("layout") << "Invalid widget index:" << index;
         return;
     }
     
-    BrowserWidget* w = m_browserWidgets[index];
+    assignSubWindow(m_browserWidgets[index], subId, name, url);
+}
+
+void WindowManager::assignSubWindow(BrowserWidget* widget, int subId, const QString& name, const QString& url)
+{
+    if (!widget || subId <= 0) {
+        return;
+    }
+    
+    // Another pooled widget may still hold this sub-window from an earlier assignment
+    for (BrowserWidget* other : m_browserWidgets) {
+        if (other != widget && other->getSubWindowId() == subId) {
+            other->clearSubWindow();
+        }
+    }
+    
+    // The sub-window keeps its page: moving it here does not reload anything
+    widget->setThumbnailInterval(m_thumbnailIntervals.value(subId, DatabaseManager::DEFAULT_THUMBNAIL_INTERVAL));
+    widget->attachPage(m_pageCache->acquire(subId));
+    if (widget->getSubWindowId() != subId) {
+        widget->setSubWindowId(subId);
+    }
+    widget->setSubWindowName(name);
+    
+    widget->loadUrl(url);  // Returns early when the page already shows this URL
+}
+
+BrowserWidget* WindowManager::addTile(int subId, const QString& name, const QString& url)
+{
+    if (BrowserWidget* existing = findWidgetBySubId(subId)) {
+        retargetTile(subId, name, url);
+        return existing;
+    }
+    
+    BrowserWidget* widget = placeTile(subId, name, url);
+    if (widget) {
+        // placeTile() already counted the tile, so setLayout() would see no change
+        updateLayout();
+        emit layoutChanged(m_currentWindowCount);
+    }
+    return widget;
+}
+
+bool WindowManager::removeTile(int subId)
+{
+    if (!takeTile(subId)) {
+        return false;
+    }
+    
+    updateLayout();
+    emit layoutChanged(m_currentWindowCount);
+    return true;
+}
+
+void WindowManager::applyChangeSet(const SubWindowChangeResult& changes)
+{
+    // Deletions first so their slots are free for the additions; one layout pass at the end
+    bool wallChanged = false;
+    for (int subId : changes.deleted) {
+        wallChanged |= takeTile(subId);
+        m_thumbnailIntervals.remove(subId);
+        m_refreshScheduler->remove(subId);
+    }
+    
+    for (const QJsonObject& subWindow : changes.updated + changes.added) {
+        if (subWindow.contains("thumbnail_interval")) {
+            m_thumbnailIntervals.insert(subWindow["id"].toInt(), subWindow["thumbnail_interval"].toInt());
+        }
+        if (subWindow.contains("refresh_interval")) {
+            m_refreshScheduler->setInterval(subWindow["id"].toInt(), subWindow["refresh_interval"].toInt());
+        }
+    }
+    
+    for (const QJsonObject& subWindow : changes.updated) {
+        if (BrowserWidget* widget = findWidgetBySubId(subWindow["id"].toInt())) {
+            widget->setThumbnailInterval(m_thumbnailIntervals.value(widget->getSubWindowId(),
+                                                                    DatabaseManager::DEFAULT_THUMBNAIL_INTERVAL));
+        }
+        retargetTile(subWindow["id"].toInt(), subWindow["name"].toString(), subWindow["url"].toString());
+    }
     
-    w->setSubWindowId(subId);
-    w->setSubWindowName(name);
+    for (const QJsonObject& subWindow : changes.added) {
+        wallChanged |= placeTile(subWindow["id"].toInt(), subWindow["name"].toString(),
+                                 subWindow["url"].toString()) != nullptr;
+    }
+    
+    if (wallChanged) {
+        updateLayout();
+        emit layoutChanged(m_currentWindowCount);
+    }
+}
+
+BrowserWidget* WindowManager::placeTile(int subId, const QString& name, const QString& url)
+{
+    if (subId <= 0) {
+        return nullptr;
+    }
+    
+    if (findWidgetBySubId(subId)) {
+        retargetTile(subId, name, url);
+        return nullptr;
+    }
     
-    if (w->isVisible() && !w->getCurrentUrl().isEmpty() && !w->getCurrentUrl().startsWith(url)) {
-        w->loadUrl(url);
-    } else if (w->isVisible() && w->getCurrentUrl().isEmpty()) {
-        w->loadUrl(url);
+    if (m_currentWindowCount >= m_browserWidgets.size()) {
+        LOG_WARNING("layout") << "WindowManager::placeTile: All" << m_browserWidgets.size() << "tiles are in use, cannot show sub window" << subId;
+        return nullptr;
     }
+    
+    // The next pooled widget becomes the new last tile; existing tiles keep their slots
+    BrowserWidget* widget = m_browserWidgets[m_currentWindowCount];
+    assignSubWindow(widget, subId, name, url);
+    ++m_currentWindowCount;
+    return widget;
+}
+
+bool WindowManager::takeTile(int subId)
+{
+    BrowserWidget* widget = findWidgetBySubId(subId);
+    int index = m_browserWidgets.indexOf(widget);
+    if (!widget || index < 0 || index >= m_currentWindowCount) {
+        m_pageCache->release(subId);
+        return false;
+    }
+    
+    widget->clearSubWindow();
+    m_pageCache->release(subId);
+    
+    // Return the widget to the end of the pool; only the tiles after it shift one slot
+    m_browserWidgets.move(index, m_browserWidgets.size() - 1);
+    for (int i = index; i < m_browserWidgets.size(); ++i) {
+        m_browserWidgets[i]->setWindowId(i + 1);
+    }
+    
+    --m_currentWindowCount;
+    return true;
+}
+
+bool WindowManager::retargetTile(int subId, const QString& name, const QString& url)
+{
+    BrowserWidget* widget = findWidgetBySubId(subId);
+    if (!widget) {
+        return false;
+    }
+    
+    // Rename in place; a changed URL costs exactly one navigation
+    widget->setSubWindowName(name);
+    if (!url.isEmpty()) {
+        widget->loadUrl(url);
+    }
+    return true;
+}
+
+void WindowManager::releaseStalePages(const QSet<int>& liveSubIds)
+{
+    m_pageCache->retainOnly(liveSubIds);
+}
+
+PageCache* WindowManager::getPageCache() const
+{
+    return m_pageCache;
 }
 
 BrowserWidget* WindowManager::findWidgetBySubId(int subId) const
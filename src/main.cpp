@@ -6,24 +6,37 @@
 #include <QTranslator>
 #include <QLibraryInfo>
 #include <QWebEngineProfile>
+#include <QDebug>
 #include "MainWindow.h"
 #include "DatabaseManager.h"
+#include "StartupPipeline.h"
+#include "Tracer.h"
+#include "MetricsServer.h"
+#include "MetricsRegistry.h"
+#include "EventLoopMonitor.h"
+#include "Log.h"
 #include <QGuiApplication>  // For setAttribute, if not already included
 #include <QProcessEnvironment>  // Optional for env, but qputenv is in QtGlobal
 #include <QCoreApplication> // Required for QCoreApplication::setAttribute
 
 int main(int argc, char *argv[])
 {
+    // Start-up timing is measured from here
+    Tracer* tracer = Tracer::getInstance();
+    StartupPipeline* pipeline = StartupPipeline::getInstance();
+    const qint64 mainStartNs = tracer->now();
+    MetricsRegistry::getInstance();  // Created before any thread can report into it
+    
     // Qt WebEngine Configuration Adjustments - Disable GPU and network issues
     qputenv("QTWEBENGINE_CHROMIUM_FLAGS", "--disable-gpu --disable-software-rasterizer --no-sandbox --disable-gpu-sandbox --disable-web-security --ignore-certificate-errors --disable-features=VizDisplayCompositor --disable-background-timer-throttling --disable-history-quick-provider");
     qputenv("QT_LOGGING_RULES", "qt.webengine.*.debug=false;qt.webenginecontext.debug=false");  // Suppress warnings, but keep fatal
-    qputenv("QTWEBENGINE_LOG_ENABLED", "true");  // FIXED: Enable stderr logging for Backend errors
     
     // Enable high DPI scaling for better Win10 compatibility
     QCoreApplication::setAttribute(Qt::AA_EnableHighDpiScaling);
     QCoreApplication::setAttribute(Qt::AA_UseHighDpiPixmaps);
     
-    QApplication app(argc, argv);
+    MonitoredApplication app(argc, argv);
+    tracer->configure(app.arguments());
     
     // Set application properties
     app.setApplicationName("Browser Split Screen");
@@ -31,6 +44,9 @@ int main(int argc, char *argv[])
     app.setOrganizationName("QunKong");
     app.setOrganizationDomain("qunkong.com");
     
+    // Asynchronous file logging (BSS_LOG sets levels); qDebug/qWarning are routed through it
+    Log::install();
+    
     // Set application style
     app.setStyle(QStyleFactory::create("Fusion"));
     
@@ -58,16 +74,46 @@ int main(int argc, char *argv[])
     
     // Initialize database
     DatabaseManager* dbManager = DatabaseManager::getInstance();
-    if (!dbManager->initialize()) {
+    bool databaseReady = pipeline->runStage(StartupPipeline::DatabaseOpen, [dbManager]() {
+        return dbManager->initialize();
+    });
+    if (!databaseReady) {
         QMessageBox::critical(nullptr, "Database Error", 
                             "Failed to initialize database. Please check file permissions.");
+        Log::shutdown();
         return -1;
     }
     
+    // Opt-in OpenMetrics endpoint on loopback (BSS_METRICS_PORT or the metricsPort setting)
+    MetricsServer metricsServer;
+    metricsServer.start(MetricsServer::configuredPort());
+    
     // Create and show main window
     MainWindow window;
-    window.show();
+    {
+        TRACE_SCOPE("MainWindow::show", "startup");
+        window.show();
+    }
+    tracer->record("main-to-event-loop", "startup", mainStartNs, tracer->now() - mainStartNs);
+    
+    // GUI-thread stall watchdog (BSS_EVENT_LOOP_MONITOR=0 disables it)
+    EventLoopMonitor* loopMonitor = EventLoopMonitor::getInstance();
+    if (!qEnvironmentVariableIsSet("BSS_EVENT_LOOP_MONITOR") || qEnvironmentVariableIntValue("BSS_EVENT_LOOP_MONITOR") != 0) {
+        loopMonitor->start();
+    }
+    
+    int result = app.exec();
+    
+    if (loopMonitor->isRunning()) {
+        loopMonitor->stop();
+        LOG_INFO("startup") << loopMonitor->report();
+    }
+    
+    if (!tracer->exitDumpPath().isEmpty()) {
+        tracer->writeChromeTrace(tracer->exitDumpPath());
+    }
     
-    return app.exec();
+    Log::shutdown();
+    return result;
 }
 
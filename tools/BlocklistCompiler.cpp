@@ -0,0 +1,60 @@
+// Compiles text blocklists into the image RequestBlocker maps at startup.
+//
+//     BlocklistCompiler -o blocklist.bin blocklists/ads.txt blocklists/trackers.txt blocklists/heavy.txt
+//     BlocklistCompiler --check blocklist.bin
+//
+// The build runs it over blocklists/*.txt and puts blocklist.bin next to the
+// executable; see Blocklist.h for the list syntax and the image layout.
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QSaveFile>
+#include <QTextStream>
+#include "Blocklist.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Compiles text blocklists into a memory-mappable image.");
+    parser.addHelpOption();
+    QCommandLineOption outputOption({"o", "output"}, "Image to write.", "file");
+    QCommandLineOption checkOption("check", "Load an existing image and print its rule counts.", "file");
+    parser.addOption(outputOption);
+    parser.addOption(checkOption);
+    parser.addPositionalArgument("lists", "Text blocklists, in order.", "[lists...]");
+    parser.process(app);
+
+    if (parser.isSet(checkOption)) {
+        Blocklist blocklist;
+        if (!blocklist.load(parser.value(checkOption))) {
+            err << "invalid image: " << parser.value(checkOption) << "\n";
+            return 1;
+        }
+        out << blocklist.hostRuleCount() << " host rules, " << blocklist.pathRuleCount() << " path rules\n";
+        return 0;
+    }
+
+    const QStringList lists = parser.positionalArguments();
+    if (!parser.isSet(outputOption) || lists.isEmpty()) {
+        parser.showHelp(1);
+    }
+
+    QByteArray image;
+    QString error;
+    if (!Blocklist::compile(lists, &image, &error)) {
+        err << error << "\n";
+        return 1;
+    }
+
+    QSaveFile file(parser.value(outputOption));
+    if (!file.open(QIODevice::WriteOnly) || file.write(image) != image.size() || !file.commit()) {
+        err << parser.value(outputOption) << ": " << file.errorString() << "\n";
+        return 1;
+    }
+    out << "wrote " << image.size() << " bytes to " << parser.value(outputOption) << "\n";
+    return 0;
+}